@@ -5,14 +5,18 @@
 
 #pragma once
 
+#include <algorithm>
 #include <array>
 #include <atomic>
 #include <chrono>
+#include <complex>
+#include <condition_variable>
 #include <deque>
 #include <fstream>
 #include <iostream>
 #include <iterator>
 #include <list>
+#include <memory>
 #include <mutex>
 #include <queue>
 #include <string>
@@ -378,6 +382,7 @@ inline uint16_t byteorder_swap(const uint16_t x)
 
 #include "c74_min_string.h" // String helper functions
 #include "c74_min_symbol.h"
+#include "c74_min_small_vector.h" // Inline storage for short lists of atoms
 #include "c74_min_atom.h"
 #include "c74_min_dictionary.h"
 #include "c74_min_limit.h" // Library of miscellaneous helper functions (e.g. range clipping)
@@ -385,21 +390,35 @@ inline uint16_t byteorder_swap(const uint16_t x)
 #include "c74_min_notification.h" // A class representing notifications from attached-to objects
 #include "c74_min_patcher.h" // Wrapper for interfacing with patchers
 
+#include "c74_min_lockfree_queue.h" // Queue for passing items between threads
+#include "c74_min_worker_pool.h" // Threads sharing the work of the audio thread
+#include "c74_min_deferred_message.h" // Queue for messages deferred to the main thread
 #include "c74_min_object_components.h" // Shared components of Max objects
 #include "c74_jitter.h"
 #include "c74_min_flags.h" // Class flags
 #include "c74_min_time.h" // ITM Support
 #include "c74_min_port.h" // Inlets and Outlets
 #include "c74_min_threadsafety.h" // ...
+#include "c74_min_handoff.h" // Memory handed from the main thread to the audio thread
 #include "c74_min_inlet.h" // ...
 #include "c74_min_outlet.h" // ...
+#include "c74_min_event_outlet.h" // Outlets for events sent from the audio thread
 #include "c74_min_argument.h" // Arguments to objects
 #include "c74_min_message.h" // Messages to objects
 #include "c74_min_attribute.h" // Attributes of objects
 #include "c74_min_logger.h" // Console / Max Window output
+#include "c74_min_sample_lanes.h" // Packs of samples processed together by sample operators
+#include "c74_min_control_events.h" // Control events applied by audio objects at the sample
+#include "c74_min_denormals.h" // Flushing denormals and checking outputs in audio objects
 #include "c74_min_operator_vector.h" // Vector-based MSP object add-ins
 #include "c74_min_operator_sample.h" // Sample-based MSP object add-ins
+#include "c74_min_oversampled.h" // Oversampled sample-based MSP object add-ins
 #include "c74_min_operator_mc.h" // Vector-based MC object add-ins
+#include "c74_min_smoothed_attribute.h" // Attributes smoothed for use in audio
+#include "c74_min_snapshot_attribute.h" // Attributes of any type read from the audio thread
+#include "c74_min_scratch_arena.h" // Temporary memory for audio routines
+#include "c74_min_fft.h" // Fast Fourier transforms of real signals
+#include "c74_min_stft.h" // Short-time Fourier transforms for spectral processing
 #include "c74_min_operator_matrix.h" // Jitter MOP add-ins
 #include "c74_min_operator_ui.h" // User Interface add-ins
 #include "c74_min_graphics.h" // Graphics classes for UI objects
@@ -411,6 +430,7 @@ inline uint16_t byteorder_swap(const uint16_t x)
 #include "c74_min_timer.h" // Wrapper for clocks
 #include "c74_min_queue.h" // Wrapper for qelems and fifos
 #include "c74_min_buffer.h" // Wrapper for MSP buffers
+#include "c74_min_convolver.h" // Partitioned convolution with impulse responses
 #include "c74_min_path.h" // Wrapper class for accessing the Max path system
 #include "c74_min_texteditor.h" // Wrapper for text editor window
 #include "c74_min_dataspace.h" // Unit conversion routines (e.g. db-to-linear or hz-to-midi)
@@ -20,7 +20,7 @@ class atom : public max::t_atom
     }
 
     /// constructor with generic initializer
-    template <class T, typename enable_if<!std::is_enum<T>::value && !is_same<T, std::vector<atom>>::value, int>::type = 0>
+    template <class T, typename enable_if<!std::is_enum<T>::value && !is_same<T, std::vector<atom>>::value && !is_small_vector<T>::value, int>::type = 0>
     atom(const T initial_value)
     {
         *this = initial_value;
@@ -257,10 +257,21 @@ class atom : public max::t_atom
 /// The atoms container is the standard means by which zero or more values are passed.
 /// It is implemented as a std::vector of the atom type, and thus atoms contained in an
 /// atoms container are 'owned' copies... not simply a reference to some externally owned atoms.
+///
+/// If C74_MIN_SMALL_ATOMS is defined then atoms is instead a small_vector which stores up to
+/// C74_MIN_SMALL_ATOMS_CAPACITY atoms (default 8) without allocating memory.
+/// It has the same interface as std::vector but is not convertible to a std::vector.
 
 // TODO: how to document inherited interface, e.g. size(), begin(), etc. ?
 
+#ifdef C74_MIN_SMALL_ATOMS
+#ifndef C74_MIN_SMALL_ATOMS_CAPACITY
+#define C74_MIN_SMALL_ATOMS_CAPACITY 8
+#endif
+using atoms = small_vector<atom, C74_MIN_SMALL_ATOMS_CAPACITY>;
+#else
 using atoms = std::vector<atom>;
+#endif
 
 #ifdef __APPLE__
 #pragma mark -
@@ -321,11 +332,30 @@ class atom_reference
     // pop_front
     // pop_back
 
-    // TODO: we could consider implementing the following (but we may not need them due to limited role of this type):
-    // front()
-    // back()
-    // operator []
-    // at()
+    // Element access returns the atoms in place, allowing messages to read their arguments without copying them.
+
+    const atom& operator[](const size_type index) const
+    {
+        return *static_cast<const atom*>(m_av + index);
+    }
+
+    const atom& at(const size_type index) const
+    {
+        if (index < 0 || index >= m_ac) {
+            throw std::out_of_range("atomref index out of range");
+        }
+        return (*this)[index];
+    }
+
+    const atom& front() const
+    {
+        return (*this)[0];
+    }
+
+    const atom& back() const
+    {
+        return (*this)[m_ac - 1];
+    }
 
     // The ctor does not alter the atoms,
     // but note that some future operations done to the atom_reference could unless it is a const atom_reference
@@ -173,6 +173,31 @@ class attribute_base
 
     virtual void create(max::t_class* c, const max::method getter, const max::method setter, const bool isjitclass = 0) = 0;
 
+    // A function writing a sample from a signal mapped to an audio inlet straight to the value of an attribute.
+    using sample_setter = void (*)(attribute_base* an_attribute, const double value);
+
+    // Resolve the function for setting the attribute from a signal, called when the audio is compiled.
+    // Returns nullptr if each sample must take the full path of set() instead.
+
+    virtual sample_setter resolve_sample_setter()
+    {
+        return nullptr;
+    }
+
+    // Is setting the attribute from another thread than the main thread deferred to the main thread?
+    // The samples of a signal mapped to such an attribute are then handed over without taking the full path of set().
+
+    virtual bool defers_set() const
+    {
+        return false;
+    }
+
+    // Called for each attribute of an audio object when the audio is compiled, on the main thread.
+
+    virtual void prepare(const double a_samplerate)
+    {
+    }
+
     /// Determine the name of the datatype
     /// @return	The name of the datatype of the attribute.
 
@@ -524,7 +549,7 @@ class attribute : public attribute_base
     string default_string() const override
     {
         auto as = to_atoms(m_default);
-        auto s = to_string(as);
+        auto s = std::to_string(as);
         return s;
     }
 
@@ -622,6 +647,53 @@ class attribute : public attribute_base
         }
     }
 
+    // Numeric attributes without a custom setter are set from signals by writing the limited sample to the value.
+    // The result is the same as calling set() with the sample, without allocating atoms or deferring.
+    // The value is written on the audio thread, so this is only done for attributes that are threadsafe.
+    // The sample is limited while it is still a double, so that converting it to an integer type cannot overflow.
+
+    sample_setter resolve_sample_setter() override
+    {
+        if constexpr (std::is_arithmetic<T>::value && !is_same<T, bool>::value) {
+            const auto limited{ !is_same<limit_type<T>, limit::none<T>>::value };
+
+            if (m_setter || !writable() || defers_set() || name() == k_sym_value || (limited && m_range.size() < 2)) {
+                return nullptr;
+            }
+            return [](attribute_base* an_attribute, double value) {
+                auto& self{ *static_cast<attribute*>(an_attribute) };
+
+                if (value != value) {
+                    return; // NaN has no value to convert to
+                }
+                if constexpr (!is_same<limit_type<T>, limit::none<T>>::value) {
+                    value = limit_type<double>::apply(
+                        value, static_cast<double>(self.m_range[0]), static_cast<double>(self.m_range[1]));
+                }
+                if constexpr (std::is_integral<T>::value) {
+                    // the largest values of 64-bit types round up when they are converted to double
+                    if (value >= static_cast<double>(std::numeric_limits<T>::max())) {
+                        self.m_value = std::numeric_limits<T>::max();
+                        return;
+                    }
+                    if (value <= static_cast<double>(std::numeric_limits<T>::lowest())) {
+                        self.m_value = std::numeric_limits<T>::lowest();
+                        return;
+                    }
+                }
+                self.m_value = static_cast<T>(value);
+            };
+        }
+        else {
+            return nullptr;
+        }
+    }
+
+    bool defers_set() const override
+    {
+        return threadsafety == threadsafe::no || (threadsafety == threadsafe::undefined && !m_owner.is_assumed_threadsafe());
+    }
+
     /// Get the raw attribute value from an attribute.
     /// @return The attribute value.
 
@@ -807,6 +879,116 @@ class attribute : public attribute_base
     }
 };
 
+/// An attribute set from the signal connected to an audio inlet.
+/// The way each sample is written to the attribute is resolved once, when the audio is compiled,
+/// so that for numeric attributes without a custom setter it costs a few instructions rather than a call to set().
+/// Attributes that are not threadsafe are set on the main thread instead: the audio thread only stores the sample,
+/// and the latest one is applied with set() when the main thread gets to it.
+
+class mapped_attribute
+{
+    // The latest sample for an attribute set on the main thread, written by the audio thread.
+    class pending_sample
+    {
+      public:
+        explicit pending_sample(attribute_base* an_attribute)
+            : m_attribute{ an_attribute }
+        {
+            m_qelem = max::qelem_new(this, reinterpret_cast<max::method>(callback));
+        }
+
+        ~pending_sample()
+        {
+            max::qelem_free(m_qelem);
+        }
+
+        pending_sample(const pending_sample&) = delete;
+        pending_sample& operator=(const pending_sample&) = delete;
+
+        void store(const double a_value)
+        {
+            m_value.store(a_value, std::memory_order_relaxed);
+            // the exchanges order the store of the value before the main thread reads it
+            if (!m_waiting.exchange(true, std::memory_order_acq_rel)) {
+                max::qelem_set(m_qelem);
+            }
+        }
+
+        void apply()
+        {
+            if (m_waiting.exchange(false, std::memory_order_acq_rel)) {
+                atoms a{ { m_value.load(std::memory_order_relaxed) } };
+                m_attribute->set(a, false, false);
+            }
+        }
+
+      private:
+        attribute_base* m_attribute;
+        std::atomic<double> m_value{ 0.0 };
+        std::atomic<bool> m_waiting{ false }; // set when a sample is stored, cleared when it is applied
+        max::t_qelem* m_qelem;
+
+        static void callback(pending_sample* self)
+        {
+            self->apply();
+        }
+    };
+
+  public:
+    mapped_attribute(const int an_inlet, attribute_base* an_attribute)
+        : m_inlet{ an_inlet }
+        , m_attribute{ an_attribute }
+        , m_sample_setter{ an_attribute->resolve_sample_setter() }
+    {
+        if (!m_sample_setter && an_attribute->defers_set()) {
+            m_pending = std::make_unique<pending_sample>(an_attribute);
+        }
+    }
+
+    /// The index of the audio inlet.
+    int inlet() const
+    {
+        return m_inlet;
+    }
+
+    /// The attribute set from the inlet.
+    attribute_base* attribute() const
+    {
+        return m_attribute;
+    }
+
+    /// Set the attribute from a sample.
+    /// @param	value	The sample received at the inlet.
+    void set(const double value)
+    {
+        if (m_sample_setter) {
+            m_sample_setter(m_attribute, value);
+        }
+        else if (m_pending && !max::systhread_ismainthread()) {
+            m_pending->store(value);
+        }
+        else {
+            atoms a{ { value } };
+            m_attribute->set(a, false, false);
+        }
+    }
+
+    /// Apply the latest sample stored for an attribute set on the main thread, if there is one.
+    /// This is called on the main thread after samples have been stored: there is no need to call it yourself.
+    void apply_pending()
+    {
+        if (m_pending) {
+            m_pending->apply();
+        }
+    }
+
+  private:
+    int m_inlet;
+    attribute_base* m_attribute;
+    attribute_base::sample_setter m_sample_setter;
+    unique_ptr<pending_sample> m_pending; // for attributes set on the main thread
+};
+
 #ifdef MAC_VERSION
 #pragma mark -
 #pragma mark Threadsafe Helper
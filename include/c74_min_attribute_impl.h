@@ -114,7 +114,7 @@ void attribute<T, threadsafety, limit_type, repetitions>::create(max::t_class* c
 };
 
 template <>
-void attribute<numbers>::create(max::t_class* c, const max::method getter, const max::method setter, bool const isjitclass)
+inline void attribute<numbers>::create(max::t_class* c, const max::method getter, const max::method setter, bool const isjitclass)
 {
     long attr_flags{};
     if (visible() == visibility::hide) {
@@ -140,7 +140,7 @@ void attribute<numbers>::create(max::t_class* c, const max::method getter, const
 };
 
 template <>
-void attribute<ints>::create(max::t_class* c, const max::method getter, const max::method setter, bool const isjitclass)
+inline void attribute<ints>::create(max::t_class* c, const max::method getter, const max::method setter, bool const isjitclass)
 {
     long attr_flags{};
     if (visible() == visibility::hide) {
@@ -222,7 +222,7 @@ std::string attribute<T, threadsafety, limit_type, repetitions>::range_string()
 };
 
 template <>
-std::string attribute<numbers>::range_string() const
+inline std::string attribute<numbers>::range_string() const
 {
     if (m_range.empty()) {
         return "";
@@ -237,7 +237,7 @@ std::string attribute<numbers>::range_string() const
 };
 
 template <>
-std::string attribute<ints>::range_string() const
+inline std::string attribute<ints>::range_string() const
 {
     if (m_range.empty()) {
         return "";
@@ -280,7 +280,7 @@ void attribute<T, threadsafety, limit_type, repetitions>::copy_range()
 };
 
 template <>
-void attribute<numbers>::copy_range()
+inline void attribute<numbers>::copy_range()
 {
     if (!m_range.empty()) {
         // the range for this type is a low-bound and high-bound applied to all elements in the vector
@@ -293,7 +293,7 @@ void attribute<numbers>::copy_range()
 };
 
 template <>
-void attribute<ints>::copy_range()
+inline void attribute<ints>::copy_range()
 {
     if (!m_range.empty()) {
         // the range for this type is a low-bound and high-bound applied to all elements in the vector
@@ -312,19 +312,19 @@ bool attribute<T, threadsafety, limit_type, repetitions>::compare_to_current_val
 }
 
 template <>
-bool attribute<number>::compare_to_current_value(const atoms& args) const
+inline bool attribute<number>::compare_to_current_value(const atoms& args) const
 {
     return equivalent<number>(args[0], m_value);
 }
 
 template <>
-bool attribute<symbol>::compare_to_current_value(const atoms& args) const
+inline bool attribute<symbol>::compare_to_current_value(const atoms& args) const
 {
     return (args[0] == m_value);
 }
 
 template <>
-bool attribute<numbers>::compare_to_current_value(const atoms& args) const
+inline bool attribute<numbers>::compare_to_current_value(const atoms& args) const
 {
     if (args.size() == m_value.size()) {
         for (auto i = 0; i < m_value.size(); ++i) {
@@ -338,7 +338,7 @@ bool attribute<numbers>::compare_to_current_value(const atoms& args) const
 }
 
 template <>
-bool attribute<ints>::compare_to_current_value(const atoms& args) const
+inline bool attribute<ints>::compare_to_current_value(const atoms& args) const
 {
     if (args.size() == m_value.size()) {
         for (auto i = 0; i < m_value.size(); ++i) {
@@ -352,7 +352,7 @@ bool attribute<ints>::compare_to_current_value(const atoms& args) const
 }
 
 template <>
-bool attribute<ui::color>::compare_to_current_value(const atoms& args) const
+inline bool attribute<ui::color>::compare_to_current_value(const atoms& args) const
 {
     return equivalent<double>(args[0], m_value.red())
            && equivalent<double>(args[1], m_value.green())
@@ -175,6 +175,11 @@ class buffer_lock
 
     ~buffer_lock();
 
+    /// True if returning the lock marks the buffer~ as modified, notifying every buffer_reference to it.
+    /// A buffer_lock<false> ends an edit of the buffer~ when it is returned, whether or not the samples were written.
+
+    static constexpr bool modifies_on_release{ !audio_thread_access };
+
     /// Determine if the buffer~ being accessed has valid samples to access.
     ///	@return	True if the buffer~ is valid and possesses samples. Otherwise false.
 
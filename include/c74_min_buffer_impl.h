@@ -44,4 +44,23 @@ buffer_lock<false>::~buffer_lock()
     buffer_edit_end(m_buffer_obj, true);
 }
 
+
+inline void convolver::load(buffer_reference& an_impulse_response)
+{
+    vector<sample> samples;
+    size_t         frame_count{ 0 };
+    size_t         channel_count{ 1 };
+
+    if (an_impulse_response) {
+        impulse_response_lock b{ an_impulse_response };
+
+        if (b.valid() && b.frame_count() > 0) { // an empty buffer~ has no first sample to read from
+            frame_count = b.frame_count();
+            channel_count = b.channel_count();
+            samples.assign(&b[0], &b[0] + frame_count * channel_count);
+        }
+    }
+    load(samples.data(), frame_count, channel_count);
+}
+
 } // namespace c74::min
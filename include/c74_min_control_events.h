@@ -0,0 +1,271 @@
+/// @file
+///	@ingroup 	minapi
+///	@copyright	Copyright 2018 The Min-API Authors. All rights reserved.
+///	@license	Use of this source code is governed by the MIT License found in the License.md file.
+
+#pragma once
+
+namespace c74::min {
+
+/// The base class of control_event_queue<>, through which the performer of an audio object applies the events.
+/// You will not typically use this class directly.
+
+class control_event_queue_base
+{
+  public:
+    explicit control_event_queue_base(object_base* an_owner)
+    {
+        an_owner->control_event_queues().push_back(this);
+    }
+
+    virtual ~control_event_queue_base() = default;
+
+    // Queues cannot be copied: the owner holds on to them.
+    control_event_queue_base(const control_event_queue_base&) = delete;
+    control_event_queue_base& operator=(const control_event_queue_base& value) = delete;
+
+    // Find the first event due in a vector, on the audio thread.
+    // The vector covers the scheduler time from window_start, with samples_per_ms samples for each millisecond.
+    virtual void begin(const double window_start, const double samples_per_ms, const long frame_count) = 0;
+
+    // The offset of the next event due in the current vector, or the frame count if there is none.
+    virtual long next_offset() const = 0;
+
+    // Apply the events due at or before an offset in the current vector, on the audio thread.
+    virtual void apply(const long offset) = 0;
+};
+
+
+/// A queue of control events applied by an audio object at the sample at which they are due.
+///
+/// Messages and attributes otherwise take effect at the start of the next vector,
+/// which at large vector sizes is audible as uneven timing.
+/// Instead, schedule() the value of an event from a message (typically a threadsafe message, handled on the scheduler thread).
+/// The event is timestamped with the scheduler's logical time and passed to the audio thread without locking or allocating.
+/// The audio is then processed in segments, split at the offsets of the events due in each vector,
+/// and the handler of each event is called between the segments.
+///
+/// Events are applied one vector later than they were scheduled, keeping the time between them to the sample.
+/// Events must be scheduled in time order: an event due before the one ahead of it in the queue is applied with that one.
+///
+/// Finding the offsets needs Max's Scheduler in Audio Interrupt setting, with which the scheduler time moves on with the audio.
+/// Otherwise the scheduler time read on the audio thread has no fixed relation to the samples,
+/// and the events due in each vector are applied at its start, as with an mc_operator<>.
+///
+/// A vector_operator<> is called with each segment as a shorter vector of audio.
+/// A sample_operator<> is called for each frame as usual, frame() still being the index in the whole vector.
+/// An mc_operator<>, or a vector_operator<> with more than k_max_segment_channels inputs or outputs,
+/// applies the events due in a vector at its start.
+///
+/// @tparam	T	The type of the values of the events. Copying a value should not allocate memory,
+///				e.g. a number or a struct of numbers.
+///
+/// @code
+/// control_event_queue<number> frequency_changes { this, [this](const number& a_frequency) {
+///     m_increment = a_frequency / samplerate();
+/// }};
+///
+/// message<threadsafe::yes> frequency { this, "frequency", "Set the frequency, at the sample.",
+///     MIN_FUNCTION {
+///         frequency_changes.schedule(args[0]);
+///         return {};
+///     }
+/// };
+/// @endcode
+
+template <class T = number>
+class control_event_queue : public control_event_queue_base
+{
+    struct queued_event
+    {
+        double time{}; // in milliseconds of scheduler time
+        T value{};
+    };
+
+  public:
+    /// The function called with the value of each event, on the audio thread.
+    using handler = std::function<void(const T&)>;
+
+    static constexpr size_t k_default_capacity{ 256 };
+
+    /// Create a control event queue.
+    /// @param	an_owner	The Min object instance that owns this queue. Typically you should pass 'this'.
+    /// @param	a_handler	The function applying each event, called on the audio thread.
+    /// @param	a_capacity	Optional number of events that can wait to be applied.
+    control_event_queue(object_base* an_owner, const handler& a_handler, const size_t a_capacity = k_default_capacity)
+        : control_event_queue_base{ an_owner }
+        , m_handler{ a_handler }
+    {
+        m_events.configure(a_capacity, overflow_policy::drop_newest);
+    }
+
+    /// Schedule an event for the current logical time of the scheduler.
+    /// Call this from a message, typically on the scheduler thread.
+    /// @param	a_value		The value of the event.
+    /// @return				True if the event was queued, false if it was dropped because the queue is full.
+    bool schedule(const T& a_value)
+    {
+        double now;
+        max::clock_getftime(&now);
+        return schedule_at(a_value, now);
+    }
+
+    /// Schedule an event for a time of the scheduler, e.g. ahead of the current time.
+    /// @param	a_value		The value of the event.
+    /// @param	a_time		The scheduler time in milliseconds.
+    /// @return				True if the event was queued, false if it was dropped because the queue is full.
+    bool schedule_at(const T& a_value, const double a_time)
+    {
+        return m_events.push([&](queued_event& slot) {
+            slot.time = a_time;
+            slot.value = a_value;
+        });
+    }
+
+    /// The number of events dropped because too many were waiting to be applied.
+    /// @return	The number of dropped events.
+    size_t dropped() const
+    {
+        return m_events.dropped();
+    }
+
+    void begin(const double window_start, const double samples_per_ms, const long frame_count) override
+    {
+        m_window_start = window_start;
+        m_samples_per_ms = samples_per_ms;
+        m_frame_count = frame_count;
+        find_next();
+    }
+
+    long next_offset() const override
+    {
+        return m_next_offset;
+    }
+
+    void apply(const long offset) override
+    {
+        while (m_next_offset <= offset && m_holding) {
+            m_holding = false;
+            if (m_handler) {
+                m_handler(m_next.value);
+            }
+            find_next();
+        }
+    }
+
+  private:
+    handler m_handler;
+    lockfree_queue<queued_event> m_events;
+
+    // owned by the audio thread
+    queued_event m_next; // the event taken from the queue and waiting to be due
+    bool m_holding{ false };
+    double m_window_start{ 0.0 };
+    double m_samples_per_ms{ 0.0 };
+    long m_frame_count{ 0 };
+    long m_next_offset{ 0 };
+
+    // Take the next event from the queue if needed and find its offset in the current vector.
+    // Late events are due at the start of the vector.
+    void find_next()
+    {
+        if (!m_holding) {
+            m_holding = m_events.try_pop([this](queued_event& an_event) { m_next = an_event; });
+        }
+
+        if (!m_holding) {
+            m_next_offset = m_frame_count;
+            return;
+        }
+
+        const auto position{ (m_next.time - m_window_start) * m_samples_per_ms };
+        if (position >= m_frame_count) {
+            m_next_offset = m_frame_count; // due in a later vector
+        }
+        else {
+            m_next_offset = std::max<long>(static_cast<long>(std::ceil(position)), 0);
+        }
+    }
+};
+
+
+/// The largest number of inputs or outputs of a vector_operator<> whose vectors are split at the offsets of control events.
+
+constexpr long k_max_segment_channels{ 64 };
+
+
+/// Process a vector of audio in segments split at the offsets of the events due in it, applying the events between the segments.
+/// The vector covers the scheduler time of the previous vector, so each event is applied one vector after it was scheduled.
+///
+/// @param	queues			The control event queues of the object.
+/// @param	now				The scheduler time in milliseconds at the start of the vector.
+/// @param	samplerate		The samplerate of the audio.
+/// @param	frame_count		The number of frames in the vector.
+/// @param	perform_segment	A function called with the first frame and the end frame of each segment.
+template <class F>
+void perform_control_event_segments(const std::vector<control_event_queue_base*>& queues, const double now, const double samplerate,
+                                    const long frame_count, F&& perform_segment)
+{
+    const auto samples_per_ms{ samplerate * 0.001 };
+
+    for (auto a_queue : queues) {
+        a_queue->begin(now - frame_count / samples_per_ms, samples_per_ms, frame_count);
+    }
+
+    long position{ 0 };
+    while (position < frame_count) {
+        long next{ frame_count };
+        for (auto a_queue : queues) {
+            a_queue->apply(position);
+            next = std::min(next, a_queue->next_offset());
+        }
+        perform_segment(position, next);
+        position = next;
+    }
+}
+
+
+// Apply the control events due in a vector of audio at its start, for objects whose vectors are not split.
+inline void apply_control_events(object_base& an_object, const double samplerate, const long frame_count)
+{
+    const auto& queues{ an_object.control_event_queues() };
+
+    if (queues.empty() || frame_count <= 0) {
+        return;
+    }
+
+    double now;
+    max::clock_getftime(&now);
+
+    const auto samples_per_ms{ samplerate * 0.001 };
+    for (auto a_queue : queues) {
+        a_queue->begin(now - frame_count / samples_per_ms, samples_per_ms, frame_count);
+        a_queue->apply(frame_count - 1);
+    }
+}
+
+// Process a vector of audio for an object, split at the offsets of its control events if it has any
+// and the scheduler runs in the audio interrupt.
+template <class F>
+void perform_with_control_events(object_base& an_object, const double samplerate, const long frame_count, F&& perform_segment)
+{
+    const auto& queues{ an_object.control_event_queues() };
+
+    if (queues.empty()) {
+        perform_segment(0, frame_count);
+        return;
+    }
+
+    // the scheduler runs on the audio thread only with Scheduler in Audio Interrupt
+    if (!max::systhread_istimerthread()) {
+        apply_control_events(an_object, samplerate, frame_count);
+        perform_segment(0, frame_count);
+        return;
+    }
+
+    double now;
+    max::clock_getftime(&now);
+    perform_control_event_segments(queues, now, samplerate, frame_count, perform_segment);
+}
+
+} // namespace c74::min
@@ -0,0 +1,445 @@
+/// @file
+///	@ingroup 	minapi
+///	@copyright	Copyright 2018 The Min-API Authors. All rights reserved.
+///	@license	Use of this source code is governed by the MIT License found in the License.md file.
+
+#pragma once
+
+namespace c74::min {
+
+/// A partitioned convolution of audio with an impulse response, e.g. that of a room read from a buffer~.
+///
+/// The impulse response is cut into partitions whose spectra are prepared when it is loaded, on the main thread.
+/// Each vector of audio is then convolved by multiplying spectra, at a cost growing with the number of partitions
+/// rather than with the length of the impulse response.
+/// The output is delayed by latency() samples, which is the partition size.
+///
+/// By default all partitions have the same size (uniformly partitioned).
+/// With a larger maximum partition size the later parts of the impulse response are cut into partitions twice as large
+/// as the previous ones, up to the maximum (non-uniformly partitioned), which lowers the average cost of long impulse responses
+/// for the same latency. A larger partition is transformed all at once every time it fills up,
+/// so the cost of some vectors is higher than that of others.
+///
+/// Loading an impulse response allocates and prepares everything needed to convolve with it, and hands it to the audio thread
+/// without locking. The audio thread crossfades to the new impulse response over k_crossfade_frames
+/// and the previous one is freed later on the main thread.
+/// The new impulse response takes over the input already heard, so the tail of that input is convolved with it too,
+/// but only as far back as the previous impulse response reached: a longer one starts its later part from silence.
+/// Taking over the input costs about as much on the audio thread as every stage finishing a partition at once.
+/// Channel n of the audio is convolved with channel n of the impulse response, wrapping around if it has fewer channels.
+///
+/// @code
+/// buffer_reference impulse_response { this, MIN_FUNCTION {
+///     reverb.load(impulse_response); // when the buffer~ is bound, unbound or modified
+///     return {};
+/// }};
+///
+/// convolver reverb { 2, 256 };
+///
+/// void operator()(audio_bundle input, audio_bundle output) {
+///     reverb(input, output);
+/// }
+/// @endcode
+
+class convolver
+{
+    // A uniformly partitioned convolution with one range of the impulse response.
+    // Its partitions are `size` samples, transformed with a frame of twice the size,
+    // and its output is delayed by `delay` partitions in addition to the latency of one partition.
+    struct stage
+    {
+        stage(const size_t a_size, const size_t a_delay, const size_t a_partition_count, const size_t a_channel_count)
+            : transform{ 2 * a_size }
+            , size{ a_size }
+            , delay{ a_delay }
+            , partition_count{ a_partition_count }
+            , bin_count{ a_size + 1 }
+            , input(2 * a_size * a_channel_count)
+            , spectra((a_delay + a_partition_count) * (a_size + 1) * a_channel_count)
+            , output(a_size * a_channel_count)
+            , sum(a_size + 1)
+            , frame(2 * a_size)
+        {}
+
+        fft transform;
+        size_t size;
+        size_t delay;
+        size_t partition_count;
+        size_t bin_count;
+        vector<complex_sample> kernel; // the spectra of the partitions of each channel of the impulse response
+        vector<sample> input; // the previous and the current partition of input of each channel
+        vector<complex_sample> spectra; // a ring of the spectra of the last partitions of input of each channel
+        vector<sample> output; // the output of each channel for the current partition
+        vector<complex_sample> sum;
+        vector<sample> frame;
+        size_t position{ 0 }; // in the current partition
+        size_t newest{ 0 }; // the index in the ring of the spectra of the newest partition
+
+        // Transform the last two partitions of input of a channel into the newest spectrum of the ring.
+        void transform_partition(const size_t channel)
+        {
+            const auto channel_input{ input.data() + channel * 2 * size };
+
+            transform.forward(channel_input, channel_spectra(channel) + newest * bin_count);
+            std::copy(channel_input + size, channel_input + 2 * size, channel_input);
+        }
+
+        // Convolve the spectra of the last partitions of input of a channel with the impulse response, into its output.
+        void convolve_partition(const size_t channel, const size_t ir_channel)
+        {
+            const auto ring_size{ delay + partition_count };
+            const auto channel_spectra{ this->channel_spectra(channel) };
+
+            std::fill(sum.begin(), sum.end(), complex_sample{});
+            for (size_t partition = 0; partition < partition_count; ++partition) {
+                const auto index{ (newest + ring_size - (delay + partition) % ring_size) % ring_size };
+                multiply_add(channel_spectra + index * bin_count, kernel.data() + (ir_channel * partition_count + partition) * bin_count);
+            }
+
+            transform.inverse(sum.data(), frame.data());
+            std::copy(frame.data() + size, frame.data() + 2 * size, output.data() + channel * size);
+        }
+
+        // Take over the input of the same stage convolving with another impulse response, with the spectra of as many
+        // partitions as both rings hold, and convolve the current partition again with this impulse response.
+        void continue_from(const stage& previous, const size_t channel_count, const size_t ir_channel_count)
+        {
+            const auto ring_size{ delay + partition_count };
+            const auto previous_ring_size{ previous.delay + previous.partition_count };
+            const auto kept{ std::min(ring_size, previous_ring_size) };
+
+            std::copy(previous.input.begin(), previous.input.end(), input.begin());
+            position = previous.position;
+            newest = kept - 1;
+
+            for (size_t channel = 0; channel < channel_count; ++channel) {
+                for (size_t age = 0; age < kept; ++age) {
+                    const auto from{ previous.channel_spectra(channel) + (previous.newest + previous_ring_size - age) % previous_ring_size * bin_count };
+                    std::copy(from, from + bin_count, channel_spectra(channel) + (newest - age) * bin_count);
+                }
+                convolve_partition(channel, channel % ir_channel_count);
+            }
+        }
+
+        complex_sample* channel_spectra(const size_t channel)
+        {
+            return spectra.data() + channel * (delay + partition_count) * bin_count;
+        }
+
+        const complex_sample* channel_spectra(const size_t channel) const
+        {
+            return spectra.data() + channel * (delay + partition_count) * bin_count;
+        }
+
+        void multiply_add(const complex_sample* a, const complex_sample* b)
+        {
+            // arrays of complex numbers may be accessed as arrays of their real and imaginary parts
+            const auto x{ reinterpret_cast<const sample*>(a) };
+            const auto y{ reinterpret_cast<const sample*>(b) };
+            const auto z{ reinterpret_cast<sample*>(sum.data()) };
+
+            for (size_t i = 0; i < 2 * bin_count; i += 2) {
+                z[i] += x[i] * y[i] - x[i + 1] * y[i + 1];
+                z[i + 1] += x[i] * y[i + 1] + x[i + 1] * y[i];
+            }
+        }
+    };
+
+    // Everything needed to convolve with one impulse response, prepared on the main thread and handed to the audio thread.
+    struct engine
+    {
+        engine(const sample* samples, const size_t frame_count, const size_t a_ir_channel_count, const size_t a_channel_count,
+               const size_t a_partition_size, const size_t a_max_partition_size)
+            : channel_count{ a_channel_count }
+            , ir_channel_count{ std::max<size_t>(a_ir_channel_count, 1) }
+        {
+            // Each stage has partitions twice the size of the previous stage's, starting where that stage ends.
+            // A stage of partitions of size L starting at offset s of the impulse response is delayed by (s + partition size) / L - 1
+            // partitions, which must be a whole number: this sets the parity of the number of partitions of each stage.
+            size_t offset{ 0 };
+            size_t size{ a_partition_size };
+            size_t delay{ 0 };
+
+            while (offset < frame_count) {
+                const auto remaining{ (frame_count - offset + size - 1) / size };
+                auto       count{ remaining };
+
+                if (size < a_max_partition_size) {
+                    count = k_partitions_per_stage + (delay + 1 + k_partitions_per_stage) % 2;
+                    count = std::min(count, remaining);
+                }
+
+                stages.emplace_back(size, delay, count, channel_count);
+                prepare_kernel(stages.back(), samples, frame_count, offset);
+
+                offset += count * size;
+                delay = (delay + 1 + count) / 2 - 1;
+                size = std::min(2 * size, a_max_partition_size);
+            }
+        }
+
+        vector<stage> stages;
+        size_t channel_count;
+        size_t ir_channel_count;
+
+        // Take over the input of an engine convolving with another impulse response, stage by stage.
+        // Stages the previous engine did not have start from silence, in step with the first stage.
+        void continue_from(const engine& previous)
+        {
+            const auto shared{ std::min(stages.size(), previous.stages.size()) };
+
+            for (size_t index = 0; index < stages.size(); ++index) {
+                if (index < shared) {
+                    stages[index].continue_from(previous.stages[index], channel_count, ir_channel_count);
+                }
+                else if (index > 0) {
+                    stages[index].position = stages.front().position;
+                }
+            }
+        }
+
+        // Convolve a number of frames of each channel.
+        // The inputs are all read before the outputs are written, so they may share memory.
+        void process(const sample* const* ins, sample* const* outs, const size_t frame_count)
+        {
+            if (stages.empty()) {
+                for (size_t channel = 0; channel < channel_count; ++channel) {
+                    std::fill(outs[channel], outs[channel] + frame_count, 0.0);
+                }
+                return;
+            }
+
+            const auto partition_size{ stages.front().size };
+            size_t     done{ 0 };
+
+            while (done < frame_count) {
+                // up to the end of the vector or of the current partition of the first stage,
+                // which is also the end of a partition of the others as they are all in step with it
+                const auto chunk{ std::min(frame_count - done, partition_size - stages.front().position) };
+
+                for (size_t channel = 0; channel < channel_count; ++channel) {
+                    const auto in{ ins[channel] + done };
+                    const auto out{ outs[channel] + done };
+
+                    for (auto& s : stages) {
+                        std::copy(in, in + chunk, s.input.data() + channel * 2 * s.size + s.size + s.position);
+                    }
+
+                    std::fill(out, out + chunk, 0.0);
+                    for (auto& s : stages) {
+                        const auto stage_output{ s.output.data() + channel * s.size + s.position };
+                        for (size_t i = 0; i < chunk; ++i) {
+                            out[i] += stage_output[i];
+                        }
+                    }
+                }
+
+                for (auto& s : stages) {
+                    s.position += chunk;
+                    if (s.position == s.size) {
+                        s.position = 0;
+                        s.newest = (s.newest + 1) % (s.delay + s.partition_count);
+                        for (size_t channel = 0; channel < channel_count; ++channel) {
+                            s.transform_partition(channel);
+                            s.convolve_partition(channel, channel % ir_channel_count);
+                        }
+                    }
+                }
+
+                done += chunk;
+            }
+        }
+
+      private:
+        // Transform the partitions of a stage for each channel of the impulse response, starting at an offset.
+        void prepare_kernel(stage& s, const sample* samples, const size_t frame_count, const size_t offset)
+        {
+            s.kernel.resize(ir_channel_count * s.partition_count * s.bin_count);
+
+            for (size_t ir_channel = 0; ir_channel < ir_channel_count; ++ir_channel) {
+                for (size_t partition = 0; partition < s.partition_count; ++partition) {
+                    const auto start{ offset + partition * s.size };
+                    const auto end{ std::min(start + s.size, frame_count) };
+
+                    std::fill(s.frame.begin(), s.frame.end(), 0.0);
+                    for (auto i = start; i < end; ++i) {
+                        s.frame[i - start] = samples[i * ir_channel_count + ir_channel];
+                    }
+                    s.transform.forward(s.frame.data(), s.kernel.data() + (ir_channel * s.partition_count + partition) * s.bin_count);
+                }
+            }
+        }
+    };
+
+  public:
+    /// The number of partitions of each stage before the next, larger one, when the partitions are not uniform.
+    static constexpr size_t k_partitions_per_stage{ 4 };
+
+    /// The number of frames over which the audio thread crossfades to a newly loaded impulse response.
+    static constexpr size_t k_crossfade_frames{ 1024 };
+
+    /// Create a convolver, initially without an impulse response so that its output is silent.
+    /// @param	a_channel_count			The number of channels convolved.
+    /// @param	a_partition_size		The number of samples in the partitions, which is also the latency.
+    ///									A power of two of at least 2.
+    /// @param	a_max_partition_size	Optionally the number of samples in the largest partitions, for non-uniform partitions.
+    ///									A power of two of at least the partition size.
+    convolver(const size_t a_channel_count, const size_t a_partition_size, const size_t a_max_partition_size = 0)
+        : m_channel_count{ a_channel_count }
+        , m_partition_size{ a_partition_size }
+        , m_max_partition_size{ std::max(a_max_partition_size, a_partition_size) }
+        , m_silence(a_partition_size)
+        , m_discard(a_partition_size)
+        , m_crossfade(a_partition_size * a_channel_count)
+        , m_ins(a_channel_count)
+        , m_outs(a_channel_count)
+        , m_crossfade_outs(a_channel_count)
+    {
+        if (a_partition_size < 2 || (a_partition_size & (a_partition_size - 1)) != 0) {
+            error("convolver partition size must be a power of two of at least 2");
+        }
+        if ((m_max_partition_size & (m_max_partition_size - 1)) != 0) {
+            error("convolver maximum partition size must be a power of two");
+        }
+
+        m_active = std::make_unique<engine>(nullptr, 0, 1, m_channel_count, m_partition_size, m_max_partition_size);
+    }
+
+    // The convolver cannot be copied: the audio thread holds on to its memory.
+    convolver(const convolver&) = delete;
+    convolver& operator=(const convolver& value) = delete;
+
+    /// The lock with which load() reads a buffer~.
+    /// It must not mark the buffer~ as modified: load() is called from the notifications of the buffer~, and would notify itself again.
+    using impulse_response_lock = buffer_lock<true>;
+
+    /// Load an impulse response from a buffer~, on the main thread.
+    /// The buffer~ is read with an impulse_response_lock, and released before the partitions are prepared.
+    /// If the buffer~ does not exist or is empty the output becomes silent.
+    /// Call this from the notification function of the buffer_reference to follow changes to the buffer~.
+    /// @param	an_impulse_response	The buffer~ with the impulse response.
+    void load(buffer_reference& an_impulse_response);
+
+    /// Load an impulse response, on the main thread.
+    /// @param	samples			The samples of the impulse response, with the channels of each frame next to each other as in a buffer~.
+    /// @param	frame_count		The number of frames in the impulse response. If zero the output becomes silent.
+    /// @param	channel_count	The number of channels in the impulse response.
+    void load(const sample* samples, const size_t frame_count, const size_t channel_count = 1)
+    {
+        // an impulse response loaded before but not yet taken by the audio thread is replaced
+        m_engines.publish(std::make_unique<engine>(samples, frame_count, channel_count, m_channel_count, m_partition_size, m_max_partition_size));
+    }
+
+    /// Remove the impulse response, so that the output becomes silent.
+    void clear()
+    {
+        load(nullptr, 0);
+    }
+
+    /// The number of samples in the partitions.
+    /// @return	The partition size.
+    size_t partition_size() const
+    {
+        return m_partition_size;
+    }
+
+    /// The number of channels convolved.
+    /// @return	The number of channels.
+    size_t channel_count() const
+    {
+        return m_channel_count;
+    }
+
+    /// The delay of the output.
+    /// @return	The latency in samples.
+    size_t latency() const
+    {
+        return m_partition_size;
+    }
+
+    /// Convolve a vector of audio.
+    /// Channels of the output beyond channel_count() are silenced.
+    /// @param	input	The incoming audio. Missing channels are taken to be silent.
+    /// @param	output	The outgoing audio. It may share memory with the input.
+    void operator()(audio_bundle input, audio_bundle output)
+    {
+        const auto frame_count{ static_cast<size_t>(output.frame_count()) };
+
+        for (auto channel = static_cast<long>(m_channel_count); channel < output.channel_count(); ++channel) {
+            output.channel(channel).clear();
+        }
+
+        // take a newly loaded impulse response, once the previous one has been freed
+        if (!m_next) {
+            m_next.reset(m_engines.take());
+
+            if (m_next) {
+                m_next->continue_from(*m_active);
+                m_crossfade_position = 0;
+
+                if (m_active->stages.empty()) {
+                    finish_crossfade(); // there is nothing to fade from
+                }
+            }
+        }
+
+        size_t done{ 0 };
+        while (done < frame_count) {
+            const auto chunk{ std::min(frame_count - done, m_partition_size) };
+
+            for (size_t channel = 0; channel < m_channel_count; ++channel) {
+                m_ins[channel] = channel < static_cast<size_t>(input.channel_count()) ? input.samples(channel) + done : m_silence.data();
+                m_outs[channel] = channel < static_cast<size_t>(output.channel_count()) ? output.samples(channel) + done : m_discard.data();
+                m_crossfade_outs[channel] = m_crossfade.data() + channel * m_partition_size;
+            }
+
+            if (m_next) {
+                m_next->process(m_ins.data(), m_crossfade_outs.data(), chunk);
+            }
+            m_active->process(m_ins.data(), m_outs.data(), chunk);
+
+            if (m_next) {
+                for (size_t i = 0; i < chunk; ++i) {
+                    const auto gain{ std::min(static_cast<sample>(m_crossfade_position + i) / k_crossfade_frames, 1.0) };
+                    for (size_t channel = 0; channel < m_channel_count; ++channel) {
+                        m_outs[channel][i] += gain * (m_crossfade_outs[channel][i] - m_outs[channel][i]);
+                    }
+                }
+
+                m_crossfade_position += chunk;
+                if (m_crossfade_position >= k_crossfade_frames) {
+                    finish_crossfade();
+                }
+            }
+
+            done += chunk;
+        }
+    }
+
+  private:
+    size_t m_channel_count;
+    size_t m_partition_size;
+    size_t m_max_partition_size;
+
+    // owned by the audio thread
+    unique_ptr<engine> m_active;
+    unique_ptr<engine> m_next; // being crossfaded to
+    size_t m_crossfade_position{ 0 };
+    vector<sample> m_silence; // the input of missing channels
+    vector<sample> m_discard; // the output of missing channels
+    vector<sample> m_crossfade; // the output of the next engine for each channel, for one partition
+    vector<const sample*> m_ins;
+    vector<sample*> m_outs;
+    vector<sample*> m_crossfade_outs;
+
+    // handed between threads: the audio thread takes loaded engines and hands back the ones it replaced
+    handoff<engine> m_engines;
+
+    void finish_crossfade()
+    {
+        m_engines.retire(m_active.release());
+        m_active = std::move(m_next);
+    }
+};
+
+} // namespace c74::min
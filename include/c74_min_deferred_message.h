@@ -0,0 +1,144 @@
+/// @file
+///	@ingroup 	minapi
+///	@copyright	Copyright 2018 The Min-API Authors. All rights reserved.
+///	@license	Use of this source code is governed by the MIT License found in the License.md file.
+
+#pragma once
+
+namespace c74::min {
+
+class message_base;
+
+// A message call waiting in a deferred_message_queue.
+// The args are pooled: they keep their capacity when the call has been made so that the next call can reuse it.
+struct deferred_message
+{
+    message_base* message{ nullptr };
+    atoms args;
+    int inlet{ -1 };
+};
+
+
+/// A queue of message calls deferred to the main thread.
+/// Every object has one, which is used by all of its messages that are not threadsafe.
+///
+/// Calls may be pushed from any number of threads without locking or allocating:
+/// they are stored in a ring of preallocated slots, each with its own preallocated atoms.
+/// A single main thread callback is scheduled for however many calls are queued, and it makes all of them in order.
+///
+/// The default capacity is 16 calls of up to 4 atoms each.
+/// Longer calls are still queued but may allocate the first time they use a slot.
+/// Use configure() in your object's constructor to change these defaults or the overflow policy.
+
+class deferred_message_queue
+{
+  public:
+    static constexpr size_t k_default_capacity{ 16 };
+    static constexpr size_t k_default_atoms_per_message{ 4 };
+
+    deferred_message_queue() = default;
+
+    ~deferred_message_queue()
+    {
+        if (m_qelem) {
+            max::qelem_free(m_qelem);
+        }
+    }
+
+    // Queues cannot be copied.
+    // If they are then the ownership of the internal t_qelem becomes ambiguous.
+    deferred_message_queue(const deferred_message_queue&) = delete;
+    deferred_message_queue& operator=(const deferred_message_queue& value) = delete;
+
+    /// Set the size of the queue and how it behaves when it is full.
+    /// This must be called from the main thread while no calls are being deferred, typically in your object's constructor.
+    /// Any calls already queued are discarded.
+    ///
+    /// @param	capacity			The number of calls that can be queued. Rounded up to a power of two.
+    /// @param	policy				What to do with a new call when the queue is full.
+    /// @param	atoms_per_message	The number of atoms preallocated for the arguments of each call.
+    void configure(const size_t capacity, const overflow_policy policy = overflow_policy::drop_oldest,
+                   const size_t atoms_per_message = k_default_atoms_per_message)
+    {
+        m_atoms_per_message = atoms_per_message;
+        m_calls.configure(capacity, policy, [atoms_per_message](deferred_message& call) { call.args.reserve(atoms_per_message); });
+    }
+
+    /// Allocate the queue with the current settings, if it has not been allocated already.
+    /// Called from the main thread when a message that may defer is created.
+    void prepare()
+    {
+        if (!m_calls.capacity()) {
+            configure(k_default_capacity, m_calls.policy(), m_atoms_per_message);
+        }
+        if (!m_qelem) {
+            m_qelem = max::qelem_new(this, reinterpret_cast<max::method>(deferred_message_queue::qelem_callback));
+        }
+    }
+
+    /// Queue a message call to be made on the main thread.
+    /// This may be called from any thread.
+    ///
+    /// @param	a_message	The message to call.
+    /// @param	args		The arguments for the call. These are copied.
+    /// @param	inlet		The inlet at which the message was received.
+    /// @return				True if the call was queued, false if it was dropped.
+    bool push(message_base* a_message, const atoms& args, const int inlet)
+    {
+        if (!m_qelem) {
+            return false; // not prepared: no message of this object may be deferred
+        }
+
+        const auto queued = m_calls.push([&](deferred_message& call) {
+            call.message = a_message;
+            call.args.assign(args.begin(), args.end()); // reuses the slot's capacity
+            call.inlet = inlet;
+        });
+
+        max::qelem_set(m_qelem);
+        return queued;
+    }
+
+    /// Make all queued calls.
+    /// This is called automatically on the main thread after calls have been pushed.
+    void drain();
+
+    /// The number of calls dropped because the queue was full since the object was created or reset_dropped() was called.
+    /// @return	The number of dropped calls.
+    size_t dropped() const
+    {
+        return m_calls.dropped();
+    }
+
+    /// Reset the count of dropped calls.
+    void reset_dropped()
+    {
+        m_calls.reset_dropped();
+    }
+
+    /// The number of calls that can be queued without overflowing.
+    /// @return	The capacity of the queue, or zero if it has not been allocated.
+    size_t capacity() const
+    {
+        return m_calls.capacity();
+    }
+
+    /// The current overflow policy.
+    /// @return The overflow policy.
+    overflow_policy policy() const
+    {
+        return m_calls.policy();
+    }
+
+  private:
+    lockfree_queue<deferred_message> m_calls;
+    size_t m_atoms_per_message{ k_default_atoms_per_message };
+    max::t_qelem* m_qelem{ nullptr };
+
+    static void qelem_callback(deferred_message_queue* self)
+    {
+        self->drain();
+    }
+};
+
+} // namespace c74::min
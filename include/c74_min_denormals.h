@@ -0,0 +1,139 @@
+/// @file
+///	@ingroup 	minapi
+///	@copyright	Copyright 2018 The Min-API Authors. All rights reserved.
+///	@license	Use of this source code is governed by the MIT License found in the License.md file.
+
+#pragma once
+
+#if defined(__SSE__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 1)
+#include <xmmintrin.h>
+#define C74_MIN_FLUSH_DENORMALS_SSE 1
+#elif defined(__aarch64__) || (defined(__arm__) && defined(__ARM_FP))
+#define C74_MIN_FLUSH_DENORMALS_ARM 1
+#endif
+
+namespace c74::min {
+
+/// Treat denormal numbers as zero while in scope, on the current thread.
+///
+/// Calculations that decay towards zero, e.g. the feedback of filters and reverbs, reach numbers so small (denormals)
+/// that the processor handles them many times more slowly than other numbers.
+/// On x86 processors this sets the flush-to-zero (FTZ) and denormals-are-zero (DAZ) flags,
+/// and on ARM processors the flush-to-zero (FZ) flag. The previous flags are restored at the end of the scope.
+/// On other processors it does nothing.
+
+class scoped_flush_denormals
+{
+  public:
+    scoped_flush_denormals()
+    {
+#if defined(C74_MIN_FLUSH_DENORMALS_SSE)
+        m_previous = _mm_getcsr();
+        _mm_setcsr(m_previous | k_ftz | k_daz);
+#elif defined(C74_MIN_FLUSH_DENORMALS_ARM)
+        m_previous = read_fpcr();
+        write_fpcr(m_previous | k_fz);
+#endif
+    }
+
+    ~scoped_flush_denormals()
+    {
+#if defined(C74_MIN_FLUSH_DENORMALS_SSE)
+        _mm_setcsr(m_previous);
+#elif defined(C74_MIN_FLUSH_DENORMALS_ARM)
+        write_fpcr(m_previous);
+#endif
+    }
+
+    scoped_flush_denormals(const scoped_flush_denormals&) = delete;
+    scoped_flush_denormals& operator=(const scoped_flush_denormals&) = delete;
+
+    /// Find out if denormals can be flushed on this processor.
+    /// @return	True if the flags are supported.
+    static constexpr bool supported()
+    {
+#if defined(C74_MIN_FLUSH_DENORMALS_SSE) || defined(C74_MIN_FLUSH_DENORMALS_ARM)
+        return true;
+#else
+        return false;
+#endif
+    }
+
+  private:
+#if defined(C74_MIN_FLUSH_DENORMALS_SSE)
+    static constexpr unsigned int k_ftz{ 0x8000 };
+    static constexpr unsigned int k_daz{ 0x0040 };
+    unsigned int m_previous;
+#elif defined(C74_MIN_FLUSH_DENORMALS_ARM)
+    static constexpr uintptr_t k_fz{ 1 << 24 };
+    uintptr_t m_previous;
+
+    static uintptr_t read_fpcr()
+    {
+        uintptr_t value;
+#if defined(__aarch64__)
+        asm volatile("mrs %0, fpcr" : "=r"(value));
+#else
+        asm volatile("vmrs %0, fpscr" : "=r"(value));
+#endif
+        return value;
+    }
+
+    static void write_fpcr(const uintptr_t value)
+    {
+#if defined(__aarch64__)
+        asm volatile("msr fpcr, %0" : : "r"(value));
+#else
+        asm volatile("vmsr fpscr, %0" : : "r"(value));
+#endif
+    }
+#endif
+};
+
+
+/// Inherit from flush_denormals in addition to your audio operator to treat denormal numbers as zero
+/// while your object processes audio (see scoped_flush_denormals).
+/// Use this for objects with feedback that decays towards zero, to avoid sudden rises in CPU usage as it decays.
+///
+/// @code
+/// class comb : public object<comb>, public sample_operator<1, 1>, public flush_denormals {
+///     // ...
+/// };
+/// @endcode
+
+class flush_denormals
+{};
+
+
+/// Inherit from check_outputs in addition to your audio operator to check the outputs of your object
+/// for NaN and infinite samples after each vector.
+/// An output channel with such samples is silenced, so that they do not spread through the signal chain (and into feedback),
+/// and the vector is counted in nonfinite_count() rather than anything being reported from the audio thread.
+
+class check_outputs
+{
+  public:
+    /// The number of vectors in which the object's outputs had NaN or infinite samples.
+    /// @return	The number of vectors.
+    size_t nonfinite_count() const
+    {
+        return m_nonfinite_count.load(std::memory_order_relaxed);
+    }
+
+    /// Reset the count of vectors with NaN or infinite samples.
+    void reset_nonfinite_count()
+    {
+        m_nonfinite_count.store(0, std::memory_order_relaxed);
+    }
+
+    // Count a vector with NaN or infinite samples, on the audio thread.
+    void count_nonfinite()
+    {
+        m_nonfinite_count.fetch_add(1, std::memory_order_relaxed);
+    }
+
+  private:
+    std::atomic<size_t> m_nonfinite_count{ 0 };
+};
+
+} // namespace c74::min
@@ -0,0 +1,265 @@
+/// @file
+///	@ingroup 	minapi
+///	@copyright	Copyright 2018 The Min-API Authors. All rights reserved.
+///	@license	Use of this source code is governed by the MIT License found in the License.md file.
+
+#pragma once
+
+namespace c74::min {
+
+/// An outlet for sending events from the audio thread.
+///
+/// Call send() from your audio object's call operator, passing the offset of the event in the current vector of samples
+/// (in a sample_operator<> this is frame()). The event is written into a preallocated ring without locking or allocating,
+/// and is sent from the outlet on the scheduler thread.
+/// Each event is timed from the scheduler time last recorded at the end of a vector, plus the samples since then.
+/// Events reaching the scheduler together keep that spacing, all delayed by as much as the first of them,
+/// so that downstream timing follows the sample offsets without drifting from the scheduler.
+///
+/// The ring is allocated when the audio is first compiled. If it fills up new events are dropped and counted by dropped().
+///
+/// @code
+/// event_outlet onsets { this, "(bang) onsets" };
+///
+/// sample operator()(sample x) {
+///     if (detect_onset(x))
+///         onsets.send_bang(frame());
+///     return x;
+/// }
+/// @endcode
+
+class event_outlet : public outlet<thread_check::none, thread_action::assert>
+{
+    // an event as written by the audio thread
+    struct queued_event
+    {
+        double time{}; // in milliseconds of scheduler time
+        number value{};
+        bool bang{ false };
+    };
+
+    // the clock on which events are delivered
+    class event_trigger : public thread_trigger<event_outlet*, thread_check::scheduler>
+    {
+      public:
+        explicit event_trigger(event_outlet* an_owner)
+            : thread_trigger<event_outlet*, thread_check::scheduler>(an_owner)
+        {
+        }
+
+        void callback() override
+        {
+            m_baton->deliver();
+        }
+
+        void push(const message_type, const atoms&) override {}
+
+        void delay(const double milliseconds)
+        {
+            max::clock_fdelay(m_clock, milliseconds);
+        }
+    };
+
+  public:
+    static constexpr size_t k_default_capacity{ 1024 };
+
+    /// Create an event outlet
+    /// @param an_owner			The Min object instance that owns this outlet. Typically you should pass 'this'.
+    /// @param a_description	Documentation string for this outlet.
+    /// @param a_capacity		Optional number of events that can wait to be delivered.
+    event_outlet(object_base* an_owner, const string& a_description, const size_t a_capacity = k_default_capacity)
+        : outlet<thread_check::none, thread_action::assert>(an_owner, a_description)
+        , m_capacity{ a_capacity }
+    {
+        an_owner->event_outlets().push_back(this);
+    }
+
+    /// Send a number from the audio thread.
+    /// @param value	The number to send.
+    /// @param offset	The offset of the event in the current vector of samples.
+    void send(const number value, const size_t offset = 0)
+    {
+        push({ time_of(offset), value, false });
+    }
+
+    /// Send a bang from the audio thread.
+    /// @param offset	The offset of the event in the current vector of samples.
+    void send_bang(const size_t offset = 0)
+    {
+        push({ time_of(offset), 0.0, true });
+    }
+
+    /// Send a number from the audio thread.
+    /// @param value	The number to send.
+    /// @param offset	The offset of the event in the current vector of samples.
+    void operator()(const number value, const size_t offset = 0)
+    {
+        send(value, offset);
+    }
+
+    /// The number of events dropped because too many were waiting to be delivered.
+    /// @return	The number of dropped events.
+    size_t dropped() const
+    {
+        return m_events.dropped();
+    }
+
+    // Called when the audio is compiled, on the main thread.
+    // The ring is allocated only once: the audio thread may still be running the previous signal chain.
+    void prepare(const double a_samplerate)
+    {
+        if (!m_events.capacity()) {
+            m_events.configure(m_capacity, overflow_policy::drop_newest);
+        }
+        m_samplerate = a_samplerate;
+        m_recompiled = true;
+    }
+
+    // Called at the end of each vector, on the audio thread.
+    void advance(const long a_frame_count)
+    {
+        restart_if_recompiled();
+        m_position += a_frame_count;
+
+        double now;
+        max::clock_getftime(&now);
+        if (now != m_anchor_time) { // the scheduler time may stay the same for several vectors
+            m_anchor_time = now;
+            m_anchor_position = m_position;
+        }
+    }
+
+    // Perform routine added to the signal chain after the object's own to advance all of its event outlets.
+    static void perform_advance(max::t_object*, max::t_object*, double**, long, double**, long, long sampleframes, long, void* an_owner)
+    {
+        for (auto an_event_outlet : static_cast<object_base*>(an_owner)->event_outlets()) {
+            an_event_outlet->advance(sampleframes);
+        }
+    }
+
+    /// Hand the events that are due at a scheduler time to a function, in order. This is how the outlet sends them.
+    /// The first event in a burst is due straightaway, and those that follow are delayed by as much.
+    /// @param	now			The scheduler time in milliseconds.
+    /// @param	a_function	The function called with each event that is due.
+    /// @return				The time in milliseconds until the next event is due, or zero if no events are waiting.
+    template <class F>
+    double take(const double now, F&& a_function)
+    {
+        for (;;) {
+            if (!m_holding) {
+                if (!m_events.try_pop([this](queued_event& an_event) { m_next = an_event; })) {
+                    m_pending = false; // events pushed from here on need another callback
+                    if (!m_events.try_pop([this](queued_event& an_event) { m_next = an_event; })) {
+                        break;
+                    }
+                    m_pending = true; // pushed before the flag was cleared, without a callback of its own
+                }
+                m_holding = true;
+            }
+
+            if (!m_anchored) {
+                m_delay = std::max(now - m_next.time, 0.0);
+                m_anchored = true;
+            }
+
+            const auto due = m_next.time + m_delay; // in the past if sent out of order
+            if (due > now) {
+                return due - now; // still pending: the clock is set for it
+            }
+
+            m_holding = false;
+            a_function(static_cast<const queued_event&>(m_next));
+        }
+
+        m_anchored = false; // the next burst is timed from when it arrives
+        return 0.0;
+    }
+
+  private:
+    size_t m_capacity;
+    lockfree_queue<queued_event> m_events;
+    std::atomic<double> m_samplerate{ c74::max::sys_getsr() };
+    std::atomic<bool> m_recompiled{ true }; // the position and time of the previous signal chain no longer apply
+    std::atomic<bool> m_pending{ false }; // events are waiting and the clock is set
+    event_trigger m_trigger{ this };
+
+    // owned by the audio thread
+    uint64_t m_position{ 0 }; // in samples, counted from when the audio was compiled
+    uint64_t m_anchor_position{ 0 }; // the position at which the scheduler time was last recorded
+    double m_anchor_time{ 0.0 };
+
+    // owned by the scheduler thread
+    queued_event m_next;
+    bool m_holding{ false };
+    bool m_anchored{ false };
+    double m_delay{ 0.0 }; // of the events of the current burst
+
+    // The scheduler time of an offset in the current vector, on the audio thread.
+    double time_of(const size_t offset)
+    {
+        restart_if_recompiled();
+        const auto elapsed{ m_position + offset - m_anchor_position };
+        return m_anchor_time + static_cast<double>(elapsed) * 1000.0 / m_samplerate;
+    }
+
+    // Count samples from zero again when the audio has been compiled, on the audio thread.
+    void restart_if_recompiled()
+    {
+        if (m_recompiled.load(std::memory_order_relaxed) && m_recompiled.exchange(false)) {
+            m_position = 0;
+            m_anchor_position = 0;
+            max::clock_getftime(&m_anchor_time);
+        }
+    }
+
+    // The clock is only set when the first event arrives: while events are waiting it is already set for the next of them.
+    void push(const queued_event& an_event)
+    {
+        m_events.push([&an_event](queued_event& slot) { slot = an_event; });
+        if (!m_pending.exchange(true)) {
+            m_trigger.set();
+        }
+    }
+
+    // Send all events that are due, then wait for the next one.
+    void deliver()
+    {
+        double now;
+        max::clock_getftime(&now);
+
+        const auto wait = take(now, [this](const queued_event& an_event) {
+            if (an_event.bang) {
+                max::outlet_bang(m_instance);
+            }
+            else {
+                max::outlet_float(m_instance, an_event.value);
+            }
+        });
+        if (wait > 0.0) {
+            m_trigger.delay(wait);
+        }
+    }
+};
+
+
+// Add the perform routine advancing the event outlets of an object to the signal chain.
+// Called for audio objects when the signal chain is compiled, after adding their own perform routine.
+template <class min_class_type>
+void min_dsp64_add_event_outlets(minwrap<min_class_type>* self, max::t_object* dsp64)
+{
+    auto& event_outlets{ self->m_min_object.event_outlets() };
+
+    if (event_outlets.empty()) {
+        return;
+    }
+
+    for (auto an_event_outlet : event_outlets) {
+        an_event_outlet->prepare(self->m_min_object.samplerate());
+    }
+
+    using namespace c74::max;
+    object_method_direct(void, (void*, max::t_object*, const max::t_perfroutine64, const long, const void*), dsp64, symbol("dsp_add64"),
+                         self->maxobj(), event_outlet::perform_advance, 0, static_cast<object_base*>(&self->m_min_object));
+}
+
+} // namespace c74::min
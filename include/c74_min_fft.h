@@ -0,0 +1,282 @@
+/// @file
+///	@ingroup 	minapi
+///	@copyright	Copyright 2018 The Min-API Authors. All rights reserved.
+///	@license	Use of this source code is governed by the MIT License found in the License.md file.
+
+#pragma once
+
+namespace c74::min {
+
+/// A complex number of samples, e.g. a bin of a spectrum.
+using complex_sample = std::complex<sample>;
+
+
+/// A view of the bins of a spectrum, without owning them.
+
+class spectrum
+{
+  public:
+    spectrum(complex_sample* bins, const size_t bin_count)
+        : m_bins{ bins }
+        , m_bin_count{ bin_count }
+    {}
+
+    /// The bins of the spectrum.
+    /// @return	A pointer to the first bin.
+    complex_sample* data() const
+    {
+        return m_bins;
+    }
+
+    /// The number of bins.
+    /// @return	The number of bins.
+    size_t size() const
+    {
+        return m_bin_count;
+    }
+
+    complex_sample& operator[](const size_t index) const
+    {
+        return m_bins[index];
+    }
+
+    complex_sample* begin() const
+    {
+        return m_bins;
+    }
+
+    complex_sample* end() const
+    {
+        return m_bins + m_bin_count;
+    }
+
+  private:
+    complex_sample* m_bins;
+    size_t m_bin_count;
+};
+
+
+/// A fast Fourier transform of real signals, of a power-of-two size.
+///
+/// A real signal of size() samples is transformed to size() / 2 + 1 bins, from DC to the Nyquist frequency,
+/// by a complex transform of half the size.
+/// The complex transform starts with radix-4 butterflies, and its later stages calculate k_sample_lanes butterflies at a time.
+///
+/// The tables and working memory are allocated when the size is set, on the main thread.
+/// Transforms do not allocate, so they may be made on the audio thread, but only one at a time for each fft.
+
+class fft
+{
+    using pack = sample_lanes<k_sample_lanes>;
+
+  public:
+    /// Create a transform.
+    /// @param	a_size	The number of samples in the signal. A power of two of at least 4, or zero to set it later.
+    explicit fft(const size_t a_size = 0)
+    {
+        if (a_size) {
+            resize(a_size);
+        }
+    }
+
+    /// Set the size of the transform, allocating its tables.
+    /// An invalid size is an error, leaving the size as it was.
+    /// @param	a_size	The number of samples in the signal. A power of two of at least 4.
+    void resize(const size_t a_size)
+    {
+        if (a_size < 4 || (a_size & (a_size - 1)) != 0) {
+            error("fft size must be a power of two of at least 4");
+            return;
+        }
+
+        m_size = a_size;
+        m_half_size = a_size / 2;
+
+        size_t bits{ 0 };
+        while ((size_t{ 1 } << bits) < m_half_size) {
+            ++bits;
+        }
+        m_bit_reverse.resize(m_half_size);
+        for (size_t i = 0; i < m_half_size; ++i) {
+            size_t reversed{ 0 };
+            for (size_t bit = 0; bit < bits; ++bit) {
+                reversed |= ((i >> bit) & 1) << (bits - 1 - bit);
+            }
+            m_bit_reverse[i] = reversed;
+        }
+
+        // the twiddles of each radix-2 stage after the first radix-4 pass, half = 4, 8, ..., starting at (half - 4)
+        const auto pi{ std::acos(-1.0) };
+        m_twiddles_real.resize(m_half_size);
+        m_twiddles_imaginary.resize(m_half_size);
+        for (size_t half = 4; half < m_half_size; half *= 2) {
+            for (size_t k = 0; k < half; ++k) {
+                m_twiddles_real[half - 4 + k] = std::cos(-pi * k / half);
+                m_twiddles_imaginary[half - 4 + k] = std::sin(-pi * k / half);
+            }
+        }
+
+        // the twiddles separating the transforms of the even and odd samples of a real signal
+        m_real_twiddles.resize(m_half_size);
+        for (size_t k = 0; k < m_half_size; ++k) {
+            m_real_twiddles[k] = std::polar(1.0, -2.0 * pi * k / m_size);
+        }
+
+        m_real.resize(m_half_size);
+        m_imaginary.resize(m_half_size);
+    }
+
+    /// The size of the transform.
+    /// @return	The number of samples in the signal.
+    size_t size() const
+    {
+        return m_size;
+    }
+
+    /// The number of bins in a spectrum.
+    /// @return	size() / 2 + 1
+    size_t bin_count() const
+    {
+        return m_size ? m_half_size + 1 : 0;
+    }
+
+    /// Transform a signal to its spectrum.
+    /// @param	input	The size() samples of the signal.
+    /// @param	bins	The bin_count() bins of the spectrum.
+    void forward(const sample* input, complex_sample* bins)
+    {
+        // the even samples are the real part and the odd samples the imaginary part of a complex signal of half the size
+        for (size_t i = 0; i < m_half_size; ++i) {
+            m_real[m_bit_reverse[i]] = input[2 * i];
+            m_imaginary[m_bit_reverse[i]] = input[2 * i + 1];
+        }
+
+        transform_complex();
+
+        // separate the spectra of the even and odd samples, and combine them
+        bins[0] = { m_real[0] + m_imaginary[0], 0.0 };
+        bins[m_half_size] = { m_real[0] - m_imaginary[0], 0.0 };
+
+        for (size_t k = 1; k < m_half_size; ++k) {
+            const complex_sample z{ m_real[k], m_imaginary[k] };
+            const auto           mirror{ std::conj(complex_sample{ m_real[m_half_size - k], m_imaginary[m_half_size - k] }) };
+            const auto           even{ (z + mirror) * 0.5 };
+            const auto           odd{ (z - mirror) * complex_sample{ 0.0, -0.5 } };
+
+            bins[k] = even + m_real_twiddles[k] * odd;
+        }
+    }
+
+    /// Transform a spectrum to its signal.
+    /// The signal is scaled such that the inverse of the forward transform of a signal is the signal.
+    /// @param	bins	The bin_count() bins of the spectrum. The imaginary parts of the first and last bins are ignored.
+    /// @param	output	The size() samples of the signal.
+    void inverse(const complex_sample* bins, sample* output)
+    {
+        // combine the spectra of the even and odd samples into that of a complex signal of half the size,
+        // conjugated so that the forward complex transform makes the inverse one
+        for (size_t k = 0; k < m_half_size; ++k) {
+            const auto mirror{ std::conj(bins[m_half_size - k]) };
+            const auto even{ (bins[k] + mirror) * 0.5 };
+            const auto odd{ (bins[k] - mirror) * std::conj(m_real_twiddles[k]) * 0.5 };
+            const auto z{ even + complex_sample{ -odd.imag(), odd.real() } };
+
+            m_real[m_bit_reverse[k]] = z.real();
+            m_imaginary[m_bit_reverse[k]] = -z.imag();
+        }
+
+        transform_complex();
+
+        const auto scale{ 1.0 / m_half_size };
+        for (size_t i = 0; i < m_half_size; ++i) {
+            output[2 * i] = m_real[i] * scale;
+            output[2 * i + 1] = -m_imaginary[i] * scale;
+        }
+    }
+
+  private:
+    size_t m_size{ 0 };
+    size_t m_half_size{ 0 };
+    vector<size_t> m_bit_reverse;
+    vector<sample> m_twiddles_real;
+    vector<sample> m_twiddles_imaginary;
+    vector<complex_sample> m_real_twiddles;
+    vector<sample> m_real; // the working memory of the complex transform, split into real and imaginary parts
+    vector<sample> m_imaginary;
+
+    // The complex transform of half the size, in place on data in bit-reversed order.
+    void transform_complex()
+    {
+        const auto re{ m_real.data() };
+        const auto im{ m_imaginary.data() };
+        const auto n{ m_half_size };
+
+        if (n == 2) {
+            butterfly(re, im, 0, 1, 1.0, 0.0);
+            return;
+        }
+
+        // the first two stages as radix-4 butterflies, whose twiddles are 1 and -i
+        for (size_t i = 0; i < n; i += 4) {
+            const auto r0{ re[i] + re[i + 1] }, i0{ im[i] + im[i + 1] };
+            const auto r1{ re[i] - re[i + 1] }, i1{ im[i] - im[i + 1] };
+            const auto r2{ re[i + 2] + re[i + 3] }, i2{ im[i + 2] + im[i + 3] };
+            const auto r3{ re[i + 2] - re[i + 3] }, i3{ im[i + 2] - im[i + 3] };
+
+            re[i] = r0 + r2;
+            im[i] = i0 + i2;
+            re[i + 2] = r0 - r2;
+            im[i + 2] = i0 - i2;
+            re[i + 1] = r1 + i3; // r1 + -i * (r3 + i i3)
+            im[i + 1] = i1 - r3;
+            re[i + 3] = r1 - i3;
+            im[i + 3] = i1 + r3;
+        }
+
+        // the remaining stages as radix-2 butterflies
+        for (size_t half = 4; half < n; half *= 2) {
+            const auto twiddles_re{ m_twiddles_real.data() + half - 4 };
+            const auto twiddles_im{ m_twiddles_imaginary.data() + half - 4 };
+
+            for (size_t group = 0; group < n; group += 2 * half) {
+                size_t k{ 0 };
+
+                if (half >= k_sample_lanes) {
+                    for (; k < half; k += k_sample_lanes) {
+                        const auto a{ group + k };
+                        const auto b{ a + half };
+                        const auto wr{ pack::load(twiddles_re + k) };
+                        const auto wi{ pack::load(twiddles_im + k) };
+                        const auto br{ pack::load(re + b) };
+                        const auto bi{ pack::load(im + b) };
+                        const auto ar{ pack::load(re + a) };
+                        const auto ai{ pack::load(im + a) };
+                        const auto tr{ br * wr - bi * wi };
+                        const auto ti{ br * wi + bi * wr };
+
+                        (ar - tr).store(re + b);
+                        (ai - ti).store(im + b);
+                        (ar + tr).store(re + a);
+                        (ai + ti).store(im + a);
+                    }
+                }
+                for (; k < half; ++k) {
+                    butterfly(re, im, group + k, group + k + half, twiddles_re[k], twiddles_im[k]);
+                }
+            }
+        }
+    }
+
+    static void butterfly(sample* re, sample* im, const size_t a, const size_t b, const sample wr, const sample wi)
+    {
+        const auto tr{ re[b] * wr - im[b] * wi };
+        const auto ti{ re[b] * wi + im[b] * wr };
+
+        re[b] = re[a] - tr;
+        im[b] = im[a] - ti;
+        re[a] += tr;
+        im[a] += ti;
+    }
+};
+
+} // namespace c74::min
@@ -0,0 +1,164 @@
+/// @file
+///	@ingroup 	minapi
+///	@copyright	Copyright 2018 The Min-API Authors. All rights reserved.
+///	@license	Use of this source code is governed by the MIT License found in the License.md file.
+
+#pragma once
+
+namespace c74::min {
+
+// Frees memory handed back from the audio thread by calling reclaim() on its owner on the main thread, after set() is called.
+// reclaim() returns false if some of the memory may still be in use. It is then tried again after a while:
+// a clock fires on the scheduler thread, which sets the trigger again, rather than the main thread polling until it succeeds.
+
+template <class owner_type>
+class reclaim_trigger : public thread_trigger<owner_type*, thread_check::main>
+{
+  public:
+    // The time in milliseconds after which memory still in use is reclaimed again.
+    static constexpr double k_retry_interval{ 10.0 };
+
+    explicit reclaim_trigger(owner_type* an_owner)
+        : thread_trigger<owner_type*, thread_check::main>(an_owner)
+    {
+    }
+
+    ~reclaim_trigger()
+    {
+        if (m_retry) {
+            max::object_free(m_retry);
+        }
+    }
+
+    void callback() override
+    {
+        if (!this->m_baton->reclaim()) {
+            if (!m_retry) {
+                m_retry = max::clock_new(this, reinterpret_cast<max::method>(retry_callback));
+            }
+            max::clock_fdelay(m_retry, k_retry_interval);
+        }
+    }
+
+    void push(const message_type, const atoms&) override {}
+
+  private:
+    max::t_clock* m_retry{ nullptr }; // created the first time memory is still in use
+
+    static void retry_callback(reclaim_trigger* self)
+    {
+        self->set();
+    }
+};
+
+
+/// Memory prepared on the main thread and handed to the audio thread without locking, e.g. buffers sized for the vector size.
+///
+/// The main thread publish()es a complete new value. The audio thread picks it up with update() at the start of a vector,
+/// and from then on current() is the new value. The previous value is handed back to be freed on the main thread,
+/// which only happens after the audio thread has switched, so the audio thread never sees memory being changed or freed.
+///
+/// A value published before the audio thread took the previous one replaces it, and one taken before the previous value
+/// was freed waits for the next vector. At most three values exist at once: the current one, one waiting to be taken
+/// and one waiting to be freed.
+///
+/// @tparam	T	The type of the value.
+
+template <class T>
+class handoff
+{
+  public:
+    handoff() = default;
+
+    ~handoff()
+    {
+        delete m_current.load();
+        delete m_pending.load();
+        delete m_retired.load();
+    }
+
+    // Handoffs cannot be copied: the audio thread holds on to their values.
+    handoff(const handoff&) = delete;
+    handoff& operator=(const handoff& value) = delete;
+
+    /// Hand a new value to the audio thread.
+    /// Call this on the main thread.
+    /// @param	a_value	The new value.
+    void publish(std::unique_ptr<T> a_value)
+    {
+        reclaim();
+        delete m_pending.exchange(a_value.release(), std::memory_order_acq_rel);
+    }
+
+    /// Switch to the latest published value, if there is one that can be taken.
+    /// Call this on the audio thread at the start of a vector, before using current().
+    /// @param	transfer	A function called on the audio thread with the previous value (or nullptr) and the new value,
+    ///						e.g. to carry state over, before the previous value is handed back.
+    /// @return				True if the value changed.
+    template <class F>
+    bool update(F&& transfer)
+    {
+        const auto next{ take() };
+        if (!next) {
+            return false;
+        }
+
+        const auto previous{ m_current.load(std::memory_order_relaxed) };
+        transfer(previous, *next);
+        m_current.store(next, std::memory_order_release);
+        if (previous) {
+            retire(previous);
+        }
+        return true;
+    }
+
+    bool update()
+    {
+        return update([](const T*, T&) {});
+    }
+
+    /// The value the audio thread is using.
+    /// On the main thread this may be replaced at any time, but it is not freed before the main thread frees it.
+    /// @return	The current value, or nullptr if the audio thread has not taken one yet.
+    T* current() const
+    {
+        return m_current.load(std::memory_order_acquire);
+    }
+
+    /// Take the latest published value without making it current, on the audio thread.
+    /// The caller then owns it, and must hand back the value it replaces with retire(), before calling take() again.
+    /// @return	The new value, or nullptr if there is none or the value retired last has not been freed yet.
+    T* take()
+    {
+        if (m_retired.load(std::memory_order_acquire)) {
+            return nullptr;
+        }
+        return m_pending.exchange(nullptr, std::memory_order_acq_rel);
+    }
+
+    /// Hand back a value that the audio thread no longer uses, to be freed on the main thread.
+    /// @param	a_value	The value, taken before with take().
+    void retire(T* a_value)
+    {
+        m_retired.store(a_value, std::memory_order_release);
+        m_reclaim_trigger.set();
+    }
+
+    // DO NOT USE
+    // Free the value handed back by the audio thread. This happens automatically on the main thread.
+    // Returns true, as the value can always be freed once it has been handed back.
+
+    bool reclaim()
+    {
+        delete m_retired.exchange(nullptr, std::memory_order_acq_rel);
+        return true;
+    }
+
+  private:
+    std::atomic<T*> m_current{ nullptr }; // written by the audio thread
+    std::atomic<T*> m_pending{ nullptr }; // published but not yet taken by the audio thread
+    std::atomic<T*> m_retired{ nullptr }; // handed back by the audio thread but not yet freed
+    reclaim_trigger<handoff> m_reclaim_trigger{ this };
+};
+
+} // namespace c74::min
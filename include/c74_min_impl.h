@@ -222,12 +222,11 @@ sample vector_operator<vector_operator_placeholder_type>::operator()(const sampl
 #pragma mark message<>
 #endif
 
-void deferred_message::pop()
+// implemented out-of-line because of bi-directional dependency of min::deferred_message_queue and min::message_base
+
+void deferred_message_queue::drain()
 {
-    deferred_message x;
-    if (m_owning_message->m_deferred_messages.try_dequeue(x)) {
-        x.m_owning_message->m_function(x.m_args, x.m_inlet);
-    }
+    m_calls.pop_all([](deferred_message& call) { call.message->m_function(call.args, call.inlet); });
 }
 
 } // namespace c74::min
@@ -0,0 +1,281 @@
+/// @file
+///	@ingroup 	minapi
+///	@copyright	Copyright 2018 The Min-API Authors. All rights reserved.
+///	@license	Use of this source code is governed by the MIT License found in the License.md file.
+
+#pragma once
+
+namespace c74::min {
+
+/// The overflow policy determines what happens when a bounded queue is full.
+///
+/// @seealso #lockfree_queue
+enum class overflow_policy
+{
+    drop_oldest, ///< Discard the oldest queued item to make room for the new one
+    drop_newest, ///< Discard the new item
+    grow ///< Keep the new item in additional storage. This locks a mutex and allocates memory: not for the audio thread
+};
+
+
+/// A queue for passing items between threads without locking or allocating.
+///
+/// Items are stored in a ring of preallocated slots.
+/// They may be pushed from any number of threads and popped from any number of threads.
+/// Producers write their item into a slot in place, so storage owned by the item (e.g. the capacity of atoms)
+/// is reused from one item to the next.
+/// When the ring is full the overflow policy determines what happens to new items.
+///
+/// @tparam	T	The type of the items in the queue. Must be default constructible.
+
+template <class T>
+class lockfree_queue
+{
+  public:
+    lockfree_queue() = default;
+
+    // Queues cannot be copied.
+    // Producers and consumers hold on to the slots while they are using them.
+    lockfree_queue(const lockfree_queue&) = delete;
+    lockfree_queue& operator=(const lockfree_queue& value) = delete;
+
+    /// Allocate the queue.
+    /// This must be called while no other thread is using the queue. Any items already queued are discarded.
+    ///
+    /// @param	capacity	The number of items that can be queued. Rounded up to a power of two.
+    /// @param	policy		What to do with a new item when the queue is full.
+    /// @param	prepare		Optional function called with each slot once, e.g. to reserve storage for the items.
+    void configure(const size_t capacity, const overflow_policy policy = overflow_policy::drop_oldest,
+                   const std::function<void(T&)>& prepare = nullptr)
+    {
+        size_t size = 2;
+        while (size < capacity) {
+            size <<= 1;
+        }
+
+        m_policy = policy;
+        m_mask = size - 1;
+        m_slots = std::make_unique<slot[]>(size);
+        for (size_t i = 0; i < size; ++i) {
+            m_slots[i].sequence.store(i, std::memory_order_relaxed);
+            if (prepare) {
+                prepare(m_slots[i].item);
+            }
+        }
+        m_push_position.store(0, std::memory_order_relaxed);
+        m_pop_position.store(0, std::memory_order_relaxed);
+
+        std::lock_guard<std::mutex> lock{ m_overflow_mutex };
+        m_overflow.clear();
+        m_overflowing = false;
+    }
+
+    /// Add an item to the queue.
+    /// This may be called from any thread.
+    ///
+    /// @param	write	A function called with a reference to the slot for the item, which it should overwrite.
+    /// @return			True if the item was queued, false if it was dropped.
+    template <class F>
+    bool push(F&& write)
+    {
+        if (!m_slots) {
+            return false;
+        }
+
+        if (m_overflowing) {
+            return push_overflow(write); // preserve the order until the overflow has been popped
+        }
+        if (try_push(write)) {
+            return true;
+        }
+
+        switch (m_policy) {
+            case overflow_policy::grow:
+                return push_overflow(write);
+
+            case overflow_policy::drop_oldest:
+                for (auto tries = 0; tries < 8; ++tries) {
+                    if (try_pop([](T&) {})) {
+                        ++m_dropped;
+                    }
+                    if (try_push(write)) {
+                        return true;
+                    }
+                }
+                ++m_dropped;
+                return false;
+
+            default:
+                ++m_dropped;
+                return false;
+        }
+    }
+
+    /// Remove the oldest item from the queue.
+    /// This may be called from any thread.
+    ///
+    /// @param	read	A function called with a reference to the item before its slot is released.
+    /// @return			True if an item was removed, false if the ring was empty.
+    template <class F>
+    bool try_pop(F&& read)
+    {
+        if (!m_slots) {
+            return false;
+        }
+
+        auto position = m_pop_position.load(std::memory_order_relaxed);
+        slot* s;
+
+        for (;;) {
+            s = &m_slots[position & m_mask];
+            const auto sequence = s->sequence.load(std::memory_order_acquire);
+            const auto distance = static_cast<std::intptr_t>(sequence) - static_cast<std::intptr_t>(position + 1);
+
+            if (distance == 0) {
+                if (m_pop_position.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) {
+                    break;
+                }
+            }
+            else if (distance < 0) {
+                return false; // empty
+            }
+            else {
+                position = m_pop_position.load(std::memory_order_relaxed);
+            }
+        }
+
+        read(s->item);
+        s->sequence.store(position + m_mask + 1, std::memory_order_release);
+        return true;
+    }
+
+    /// Remove all items from the queue, in the order they were pushed.
+    /// Items that overflowed the ring (with overflow_policy::grow) are removed after those in the ring.
+    ///
+    /// @param	read	A function called with a reference to each item.
+    /// @return			The number of items removed.
+    template <class F>
+    size_t pop_all(F&& read)
+    {
+        size_t count{ 0 };
+
+        while (try_pop(read)) {
+            ++count;
+        }
+
+        if (m_overflowing) {
+            std::deque<T> overflow;
+            size_t end;
+            {
+                std::lock_guard<std::mutex> lock{ m_overflow_mutex };
+                end = m_push_position.load(std::memory_order_acquire);
+                overflow.swap(m_overflow);
+                m_overflowing = false;
+            }
+
+            // Items claimed in the ring before the overflow was taken were pushed before it,
+            // including those pushed since the ring was emptied above, so they are removed first.
+            while (static_cast<std::intptr_t>(end - m_pop_position.load(std::memory_order_relaxed)) > 0) {
+                if (try_pop(read)) {
+                    ++count;
+                }
+                else {
+                    std::this_thread::yield(); // a producer is still writing its item
+                }
+            }
+            for (auto& item : overflow) {
+                read(item);
+                ++count;
+            }
+        }
+        return count;
+    }
+
+    /// The number of items dropped because the queue was full since it was created or reset_dropped() was called.
+    /// @return	The number of dropped items.
+    size_t dropped() const
+    {
+        return m_dropped;
+    }
+
+    /// Reset the count of dropped items.
+    void reset_dropped()
+    {
+        m_dropped = 0;
+    }
+
+    /// The number of items that can be queued without overflowing.
+    /// @return	The capacity of the queue, or zero if it has not been configured.
+    size_t capacity() const
+    {
+        return m_slots ? m_mask + 1 : 0;
+    }
+
+    /// The current overflow policy.
+    /// @return	The overflow policy.
+    overflow_policy policy() const
+    {
+        return m_policy;
+    }
+
+  private:
+    // Bounded multi-producer/multi-consumer ring after Dmitry Vyukov's design:
+    // each slot carries a sequence number that tells producers and consumers whose turn it is.
+    struct slot
+    {
+        std::atomic<size_t> sequence{ 0 };
+        T item;
+    };
+
+    std::unique_ptr<slot[]> m_slots;
+    size_t m_mask{ 0 };
+    std::atomic<size_t> m_push_position{ 0 };
+    std::atomic<size_t> m_pop_position{ 0 };
+    std::atomic<size_t> m_dropped{ 0 };
+    overflow_policy m_policy{ overflow_policy::drop_oldest };
+
+    std::atomic<bool> m_overflowing{ false };
+    std::mutex m_overflow_mutex;
+    std::deque<T> m_overflow;
+
+    template <class F>
+    bool try_push(F& write)
+    {
+        auto position = m_push_position.load(std::memory_order_relaxed);
+        slot* s;
+
+        for (;;) {
+            s = &m_slots[position & m_mask];
+            const auto sequence = s->sequence.load(std::memory_order_acquire);
+            const auto distance = static_cast<std::intptr_t>(sequence) - static_cast<std::intptr_t>(position);
+
+            if (distance == 0) {
+                if (m_push_position.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) {
+                    break;
+                }
+            }
+            else if (distance < 0) {
+                return false; // full
+            }
+            else {
+                position = m_push_position.load(std::memory_order_relaxed);
+            }
+        }
+
+        write(s->item);
+        s->sequence.store(position + 1, std::memory_order_release);
+        return true;
+    }
+
+    template <class F>
+    bool push_overflow(F& write)
+    {
+        std::lock_guard<std::mutex> lock{ m_overflow_mutex };
+        m_overflow.emplace_back();
+        write(m_overflow.back());
+        m_overflowing = true;
+        return true;
+    }
+};
+
+} // namespace c74::min
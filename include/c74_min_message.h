@@ -19,6 +19,42 @@ using function = std::function<atoms(const atoms& as, const int inlet)>;
 /// @see argument_function
 #define MIN_FUNCTION [this](const c74::min::atoms& args, const int inlet) -> c74::min::atoms
 
+
+/// A callback function for messages that receive a single number, such as int and float.
+/// Unlike a #function the value is passed directly, so calling it from the int or float wrappers does not allocate.
+/// Ints are converted to a number, which is exact up to 2^53; messages that need larger integers should use a #function.
+/// Typically this is provided to a message as a lamba function using the #MIN_NUMBER_FUNCTION macro.
+/// @param	value	The number received by the message.
+/// @param	inlet	The number (zero-based index) of the inlet at which the message was received, if relevant. Otherwise -1.
+/// @see		MIN_NUMBER_FUNCTION
+using number_function = std::function<void(const number value, const int inlet)>;
+
+/// Provide the correct lamba function prototype for a message receiving a single number.
+/// @see number_function
+#define MIN_NUMBER_FUNCTION [this](const c74::min::number value, const int inlet) -> void
+
+
+/// A callback function for messages that receive their arguments by reference.
+/// The arguments are not copied from Max into atoms before calling the function, which matters for long lists.
+/// They are only valid for the duration of the call and are copied only if the message needs to be deferred.
+/// Typically this is provided to a message as a lamba function using the #MIN_REFERENCE_FUNCTION macro.
+/// @param	args	A reference to the atoms passed to the message.
+/// @param	inlet	The number (zero-based index) of the inlet at which the message was received, if relevant. Otherwise -1.
+/// @see		MIN_REFERENCE_FUNCTION
+using reference_function = std::function<atoms(const atom_reference& args, const int inlet)>;
+
+/// Provide the correct lamba function prototype for a message receiving its arguments by reference.
+/// @see reference_function
+#define MIN_REFERENCE_FUNCTION [this](const c74::min::atom_reference& args, const int inlet) -> c74::min::atoms
+
+
+// SFINAE helper to choose the message constructors for a #reference_function.
+// A #function also accepts an atom_reference (it converts to atoms) so the lambda type has to be inspected.
+template <class F>
+using enable_if_reference_function = typename enable_if<std::is_invocable<F, const atom_reference&, const int>::value
+                                                            && !std::is_invocable<F, const atoms&, const int>::value,
+                                                        int>::type;
+
 /// Represents any type of message.
 /// Used internally to allow heterogenous containers of messages for the Min class.
 class message_base
@@ -84,11 +120,61 @@ class message_base
         m_owner->messages()[name] = this; // add the message to the owning object's pile
     }
 
+    // Constructor for messages receiving a single number.
+    // Calls with atoms (e.g. lists or deferred calls) are forwarded to the number function with the first atom.
+    message_base(object_base* an_owner, const std::string& a_name, const number_function& a_function, const description& a_description = {}, const message_type type = message_type::gimme)
+        : message_base(an_owner, a_name, function([a_function](const atoms& as, const int inlet) -> atoms {
+                           a_function(as.empty() ? 0.0 : static_cast<number>(as[0]), inlet);
+                           return {};
+                       }), a_description, type)
+    {
+        m_number_function = a_function;
+    }
+
+    // Constructor for messages receiving their arguments by reference.
+    // Calls with atoms (e.g. deferred calls) are forwarded to the reference function with a reference to those atoms.
+    message_base(object_base* an_owner, const std::string& a_name, const reference_function& a_function, const description& a_description = {}, const message_type type = message_type::gimme)
+        : message_base(an_owner, a_name, function([a_function](const atoms& as, const int inlet) -> atoms {
+                           return a_function(atom_reference(static_cast<long>(as.size()), as.data()), inlet);
+                       }), a_description, type)
+    {
+        m_reference_function = a_function;
+    }
+
   public:
     // All messages must define what happens when you call them.
     virtual atoms operator()(const atoms& args = {}, const int inlet = -1) = 0;
     virtual atoms operator()(const atom arg, const int inlet = -1) = 0;
 
+    /// Call the message's action with a single number.
+    /// Messages created with a #number_function receive the value without it being packed into atoms.
+    /// Other messages, and calls that are deferred, receive the atom itself, so integers keep their full precision.
+    /// @param	value	The number to send to the message's action, as an int or float atom.
+    /// @param	inlet	Optional inlet number associated with the incoming message.
+    virtual void call_number(const atom& value, const int inlet = -1) = 0;
+
+    /// Determine if the message was created with a #number_function.
+    /// @return	True if the message can receive a number without allocating.
+    bool has_number_function() const
+    {
+        return m_number_function != nullptr;
+    }
+
+    /// Call the message's action with a reference to the arguments.
+    /// Messages created with a #reference_function receive the reference without the arguments being copied.
+    /// Other messages receive a copy of the arguments.
+    /// @param	args	A reference to the arguments to send to the message's action.
+    /// @param	inlet	Optional inlet number associated with the incoming message.
+    /// @return			Any return values will be returned as atoms.
+    virtual atoms call_reference(const atom_reference& args, const int inlet = -1) = 0;
+
+    /// Determine if the message was created with a #reference_function.
+    /// @return	True if the message can receive its arguments without copying them.
+    bool has_reference_function() const
+    {
+        return m_reference_function != nullptr;
+    }
+
     /// Return the Max C API message type constant for this message.
     /// @return The type of the message as a numeric constant.
     long type() const
@@ -117,14 +203,25 @@ class message_base
         return m_name;
     }
 
+    // DO NOT USE
+    // Used by the message dispatch to check that the memory at a recorded position holds a message of the instance.
+
+    bool belongs_to(const object_base* an_owner, const symbol& a_name) const
+    {
+        return m_owner == an_owner && m_name == a_name;
+    }
+
   protected:
     object_base* m_owner;
     function m_function;
+    number_function m_number_function;
+    reference_function m_reference_function;
     message_type m_type{ message_type::gimme };
     symbol m_name;
     description m_description;
 
     friend class object_base;
+    friend class deferred_message_queue;
 
     void update_inlet_number(int& inlet)
     {
@@ -143,30 +240,6 @@ class message_base
 template <threadsafe threadsafety>
 class message;
 
-class deferred_message
-{
-  public:
-    deferred_message(message<threadsafe::no>* an_owning_message, const atoms& args, const int inlet)
-        : m_owning_message{ an_owning_message }
-        , m_args{ args }
-        , m_inlet{ inlet }
-    {
-    }
-
-    deferred_message()
-    {
-    }
-
-    // call a message's action and remove it from the queue
-    // will free the deferred_message in the process
-    void pop();
-
-  private:
-    message<threadsafe::no>* m_owning_message{ nullptr };
-    atoms m_args{};
-    int m_inlet{ -1 };
-};
-
 /// A message.
 /// Messages (sometimes called Methods) in Max are how actions are triggered in objects.
 /// When you create a message in your Min class you provide the action that it should trigger as an argument,
@@ -194,6 +267,7 @@ class message : public message_base
     message(object_base* an_owner, const std::string& a_name, const function& a_function, const description& a_description = {}, const message_type a_type = message_type::gimme)
         : message_base(an_owner, a_name, a_function, a_description, a_type)
     {
+        m_owner->deferred_messages().prepare(); // any messages received from outside the main thread will be deferred
     }
 
     /// Create a new message for a Min class.
@@ -206,6 +280,7 @@ class message : public message_base
     message(object_base* an_owner, const std::string& a_name, const description& a_description, const function& a_function)
         : message_base(an_owner, a_name, a_function, a_description)
     {
+        m_owner->deferred_messages().prepare(); // any messages received from outside the main thread will be deferred
     }
 
     /// Create a new message for a Min class.
@@ -221,6 +296,64 @@ class message : public message_base
     {
     }
 
+    /// Create a new message for a Min class that receives a single number.
+    ///
+    /// @param	an_owner		The Min object instance that owns this outlet. Typically you should pass 'this'.
+    /// @param	a_name			The name of the message. This is how users in Max will trigger the message action.
+    /// @param	a_function		The function to be called when the message is received by your object.
+    ///							This is typically provided as a lamba function using the #MIN_NUMBER_FUNCTION definition.
+    /// @param	a_description	Optional, but highly encouraged, description string to document the message.
+    /// @param	a_type			Optional message type determines what kind of messages Max can send.
+    ///							In most cases you should _not_ pass anything here and accept the default.
+    message(object_base* an_owner, const std::string& a_name, const number_function& a_function, const description& a_description = {}, const message_type a_type = message_type::gimme)
+        : message_base(an_owner, a_name, a_function, a_description, a_type)
+    {
+        m_owner->deferred_messages().prepare(); // any messages received from outside the main thread will be deferred
+    }
+
+    /// Create a new message for a Min class that receives a single number.
+    ///
+    /// @param	an_owner		The Min object instance that owns this outlet. Typically you should pass 'this'.
+    /// @param	a_name			The name of the message. This is how users in Max will trigger the message action.
+    /// @param	a_description	Optional, but highly encouraged, description string to document the message.
+    /// @param	a_function		The function to be called when the message is received by your object.
+    ///							This is typically provided as a lamba function using the #MIN_NUMBER_FUNCTION definition.
+    message(object_base* an_owner, const std::string& a_name, const description& a_description, const number_function& a_function)
+        : message_base(an_owner, a_name, a_function, a_description)
+    {
+        m_owner->deferred_messages().prepare(); // any messages received from outside the main thread will be deferred
+    }
+
+    /// Create a new message for a Min class that receives its arguments by reference.
+    ///
+    /// @param	an_owner		The Min object instance that owns this outlet. Typically you should pass 'this'.
+    /// @param	a_name			The name of the message. This is how users in Max will trigger the message action.
+    /// @param	a_function		The function to be called when the message is received by your object.
+    ///							This is typically provided as a lamba function using the #MIN_REFERENCE_FUNCTION definition.
+    /// @param	a_description	Optional, but highly encouraged, description string to document the message.
+    /// @param	a_type			Optional message type determines what kind of messages Max can send.
+    ///							In most cases you should _not_ pass anything here and accept the default.
+    template <class F, enable_if_reference_function<F> = 0>
+    message(object_base* an_owner, const std::string& a_name, const F& a_function, const description& a_description = {}, const message_type a_type = message_type::gimme)
+        : message_base(an_owner, a_name, reference_function(a_function), a_description, a_type)
+    {
+        m_owner->deferred_messages().prepare(); // any messages received from outside the main thread will be deferred
+    }
+
+    /// Create a new message for a Min class that receives its arguments by reference.
+    ///
+    /// @param	an_owner		The Min object instance that owns this outlet. Typically you should pass 'this'.
+    /// @param	a_name			The name of the message. This is how users in Max will trigger the message action.
+    /// @param	a_description	Optional, but highly encouraged, description string to document the message.
+    /// @param	a_function		The function to be called when the message is received by your object.
+    ///							This is typically provided as a lamba function using the #MIN_REFERENCE_FUNCTION definition.
+    template <class F, enable_if_reference_function<F> = 0>
+    message(object_base* an_owner, const std::string& a_name, const description& a_description, const F& a_function)
+        : message_base(an_owner, a_name, reference_function(a_function), a_description)
+    {
+        m_owner->deferred_messages().prepare(); // any messages received from outside the main thread will be deferred
+    }
+
     virtual ~message() {}
 
     /// Call the message's action.
@@ -236,26 +369,11 @@ class message : public message_base
             return m_function(args, inlet);
         }
         else {
-            deferred_message m{ reinterpret_cast<message<threadsafe::no>*>(this), args, inlet };
-            if (m_deferred_messages.try_enqueue(m)) {
-                max::defer(this->m_owner->maxobj(), reinterpret_cast<max::method>(message<threadsafety>::defer_callback),
-                           reinterpret_cast<c74::max::t_symbol*>(this), 0, nullptr);
-            }
+            m_owner->deferred_messages().push(this, args, inlet);
         }
         return {};
     }
 
-    void pop()
-    {
-        auto r = m_deferred_messages.peek();
-        r->pop();
-    }
-
-    static void defer_callback(max::t_object* self, message<threadsafety>* m, const long, max::t_atom*)
-    {
-        m->pop();
-    }
-
     /// Call the message's action.
     /// @param	arg		A single argument to send to the message's action.
     /// @return			Any return values will be returned as atoms.
@@ -265,10 +383,42 @@ class message : public message_base
         return (*this)(as, inlet);
     }
 
-  private:
-    // Any messages received from outside the main thread will be deferred using the queue below.
-    friend class deferred_message;
-    fifo<deferred_message> m_deferred_messages{ 2 };
+    // See message_base::call_number().
+    void call_number(const atom& value, const int an_inlet = -1) override
+    {
+        if (!m_number_function) {
+            (*this)(atoms{ value }, an_inlet);
+            return;
+        }
+
+        int inlet{ an_inlet };
+        update_inlet_number(inlet);
+
+        if (m_owner->is_assumed_threadsafe() || max::systhread_ismainthread()) {
+            m_number_function(static_cast<number>(value), inlet);
+        }
+        else {
+            (*this)(atoms{ value }, inlet); // deferring needs its own copy of the value
+        }
+    }
+
+    // See message_base::call_reference().
+    atoms call_reference(const atom_reference& args, const int an_inlet = -1) override
+    {
+        if (!m_reference_function) {
+            return (*this)(static_cast<atoms>(args), an_inlet);
+        }
+
+        int inlet{ an_inlet };
+        update_inlet_number(inlet);
+
+        if (m_owner->is_assumed_threadsafe() || max::systhread_ismainthread()) {
+            return m_reference_function(args, inlet);
+        }
+        else {
+            return (*this)(static_cast<atoms>(args), inlet); // deferring needs its own copy of the arguments
+        }
+    }
 };
 
 // specialization of message for messages which declare themselves to be not threadsafe
@@ -288,6 +438,7 @@ class message<threadsafe::no> : public message_base
     message(object_base* an_owner, const std::string& a_name, const function& a_function, const description& a_description = {}, const message_type type = message_type::gimme)
         : message_base(an_owner, a_name, a_function, a_description)
     {
+        m_owner->deferred_messages().prepare(); // any messages received from outside the main thread will be deferred
     }
 
     /// Create a new message for a Min class.
@@ -300,6 +451,41 @@ class message<threadsafe::no> : public message_base
     message(object_base* an_owner, const std::string& a_name, const description& a_description, const function& a_function)
         : message_base(an_owner, a_name, a_function, a_description)
     {
+        m_owner->deferred_messages().prepare(); // any messages received from outside the main thread will be deferred
+    }
+
+    /// Create a new message for a Min class that receives a single number.
+    /// @see message<>::message() for the parameters, which are the same for every threadsafety.
+    message(object_base* an_owner, const std::string& a_name, const number_function& a_function, const description& a_description = {}, const message_type type = message_type::gimme)
+        : message_base(an_owner, a_name, a_function, a_description, type)
+    {
+        m_owner->deferred_messages().prepare(); // any messages received from outside the main thread will be deferred
+    }
+
+    /// Create a new message for a Min class that receives a single number.
+    /// @see message<>::message() for the parameters, which are the same for every threadsafety.
+    message(object_base* an_owner, const std::string& a_name, const description& a_description, const number_function& a_function)
+        : message_base(an_owner, a_name, a_function, a_description)
+    {
+        m_owner->deferred_messages().prepare(); // any messages received from outside the main thread will be deferred
+    }
+
+    /// Create a new message for a Min class that receives its arguments by reference.
+    /// @see message<>::message() for the parameters, which are the same for every threadsafety.
+    template <class F, enable_if_reference_function<F> = 0>
+    message(object_base* an_owner, const std::string& a_name, const F& a_function, const description& a_description = {}, const message_type type = message_type::gimme)
+        : message_base(an_owner, a_name, reference_function(a_function), a_description, type)
+    {
+        m_owner->deferred_messages().prepare(); // any messages received from outside the main thread will be deferred
+    }
+
+    /// Create a new message for a Min class that receives its arguments by reference.
+    /// @see message<>::message() for the parameters, which are the same for every threadsafety.
+    template <class F, enable_if_reference_function<F> = 0>
+    message(object_base* an_owner, const std::string& a_name, const description& a_description, const F& a_function)
+        : message_base(an_owner, a_name, reference_function(a_function), a_description)
+    {
+        m_owner->deferred_messages().prepare(); // any messages received from outside the main thread will be deferred
     }
 
     /// Call the message's action.
@@ -315,26 +501,11 @@ class message<threadsafe::no> : public message_base
             return m_function(args, inlet);
         }
         else {
-            deferred_message m{ this, args, inlet };
-            if (m_deferred_messages.try_enqueue(m)) {
-                max::defer(this->m_owner->maxobj(), reinterpret_cast<max::method>(message<threadsafe::no>::defer_callback),
-                           reinterpret_cast<c74::max::t_symbol*>(this), 0, nullptr);
-            }
+            m_owner->deferred_messages().push(this, args, inlet);
         }
         return {};
     }
 
-    void pop()
-    {
-        auto r = m_deferred_messages.peek();
-        r->pop();
-    }
-
-    static void defer_callback(max::t_object* self, message<threadsafe::no>* m, long, const max::t_atom*)
-    {
-        m->pop();
-    }
-
     /// Call the message's action.
     /// @param	arg		A single argument to send to the message's action.
     /// @return			Any return values will be returned as atoms.
@@ -344,11 +515,42 @@ class message<threadsafe::no> : public message_base
         return (*this)(as, inlet);
     }
 
-  private:
-    // Any messages received from outside the main thread will be deferred using the queue below.
+    // See message_base::call_number().
+    void call_number(const atom& value, const int an_inlet = -1) override
+    {
+        if (!m_number_function) {
+            (*this)(atoms{ value }, an_inlet);
+            return;
+        }
+
+        int inlet{ an_inlet };
+        update_inlet_number(inlet);
+
+        if (max::systhread_ismainthread()) {
+            m_number_function(static_cast<number>(value), inlet);
+        }
+        else {
+            (*this)(atoms{ value }, inlet); // deferring needs its own copy of the value
+        }
+    }
+
+    // See message_base::call_reference().
+    atoms call_reference(const atom_reference& args, const int an_inlet = -1) override
+    {
+        if (!m_reference_function) {
+            return (*this)(static_cast<atoms>(args), an_inlet);
+        }
+
+        int inlet{ an_inlet };
+        update_inlet_number(inlet);
 
-    friend class deferred_message;
-    fifo<deferred_message> m_deferred_messages{ 2 };
+        if (max::systhread_ismainthread()) {
+            return m_reference_function(args, inlet);
+        }
+        else {
+            return (*this)(static_cast<atoms>(args), inlet); // deferring needs its own copy of the arguments
+        }
+    }
 };
 
 // specialization of message for messages which declare themselves to be threadsafe
@@ -383,6 +585,36 @@ class message<threadsafe::yes> : public message_base
     {
     }
 
+    /// Create a new message for a Min class that receives a single number.
+    /// @see message<>::message() for the parameters, which are the same for every threadsafety.
+    message(object_base* an_owner, const std::string& a_name, const number_function& a_function, const description& a_description = {}, const message_type a_type = message_type::gimme)
+        : message_base(an_owner, a_name, a_function, a_description, a_type)
+    {
+    }
+
+    /// Create a new message for a Min class that receives a single number.
+    /// @see message<>::message() for the parameters, which are the same for every threadsafety.
+    message(object_base* an_owner, const std::string& a_name, const description& a_description, const number_function& a_function)
+        : message_base(an_owner, a_name, a_function, a_description)
+    {
+    }
+
+    /// Create a new message for a Min class that receives its arguments by reference.
+    /// @see message<>::message() for the parameters, which are the same for every threadsafety.
+    template <class F, enable_if_reference_function<F> = 0>
+    message(object_base* an_owner, const std::string& a_name, const F& a_function, const description& a_description = {}, const message_type a_type = message_type::gimme)
+        : message_base(an_owner, a_name, reference_function(a_function), a_description, a_type)
+    {
+    }
+
+    /// Create a new message for a Min class that receives its arguments by reference.
+    /// @see message<>::message() for the parameters, which are the same for every threadsafety.
+    template <class F, enable_if_reference_function<F> = 0>
+    message(object_base* an_owner, const std::string& a_name, const description& a_description, const F& a_function)
+        : message_base(an_owner, a_name, reference_function(a_function), a_description)
+    {
+    }
+
     /// Call the message's action.
     /// @param	args	Optional arguments to send to the message's action.
     /// @param	inlet	Optional inlet number associated with the incoming message.
@@ -402,6 +634,31 @@ class message<threadsafe::yes> : public message_base
     {
         return m_function({ arg }, inlet);
     }
+
+    // See message_base::call_number().
+    void call_number(const atom& value, const int an_inlet = -1) override
+    {
+        if (!m_number_function) {
+            (*this)(atoms{ value }, an_inlet);
+            return;
+        }
+
+        int inlet{ an_inlet };
+        update_inlet_number(inlet);
+        m_number_function(static_cast<number>(value), inlet);
+    }
+
+    // See message_base::call_reference().
+    atoms call_reference(const atom_reference& args, const int an_inlet = -1) override
+    {
+        if (!m_reference_function) {
+            return (*this)(static_cast<atoms>(args), an_inlet);
+        }
+
+        int inlet{ an_inlet };
+        update_inlet_number(inlet);
+        return m_reference_function(args, inlet);
+    }
 };
 
 } // namespace c74::min
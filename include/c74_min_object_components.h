@@ -16,6 +16,9 @@ namespace c74::min {
 
 class inlet_base;
 class outlet_base;
+class event_outlet;
+class scratch_arena;
+class control_event_queue_base;
 class argument_base;
 class message_base;
 class attribute_base;
@@ -168,6 +171,28 @@ class object_base
         return m_outlets;
     }
 
+    /// Get a reference to this object's event outlets.
+    /// These are also included in outlets().
+    /// @return	A reference to this object's event outlets.
+    auto event_outlets() -> std::vector<event_outlet*>&
+    {
+        return m_event_outlets;
+    }
+
+    /// Get a reference to this object's scratch arenas.
+    /// @return	A reference to this object's scratch arenas.
+    auto scratch_arenas() -> std::vector<scratch_arena*>&
+    {
+        return m_scratch_arenas;
+    }
+
+    /// Get a reference to this object's control event queues.
+    /// @return	A reference to this object's control event queues.
+    auto control_event_queues() -> std::vector<control_event_queue_base*>&
+    {
+        return m_control_event_queues;
+    }
+
     /// Get a reference to this object's argument declarations.
     /// Note that to get the actual argument values you will need to call state() and parse the dictionary.
     /// @return	A reference to this object's argument declarations.
@@ -204,6 +229,14 @@ class object_base
         return m_attributes;
     }
 
+    /// Get a reference to the queue used by this object's messages to defer calls to the main thread.
+    /// Use this to configure the queue's capacity and overflow policy, or to check for dropped calls.
+    /// @return	A reference to this object's deferred message queue.
+    deferred_message_queue& deferred_messages()
+    {
+        return m_deferred_messages;
+    }
+
     /// Is this object done being initialized?
     ///	@return	True if it is done with initialization and construction. Otherwise false.
     bool initialized() const
@@ -292,9 +325,13 @@ class object_base
     bool m_initialized{ false };
     std::vector<inlet_base*> m_inlets;
     std::vector<outlet_base*> m_outlets;
+    std::vector<event_outlet*> m_event_outlets;
+    std::vector<scratch_arena*> m_scratch_arenas;
+    std::vector<control_event_queue_base*> m_control_event_queues;
     std::vector<argument_base*> m_arguments;
     std::unordered_map<std::string, message_base*> m_messages; // written at class init -- readonly thereafter
     std::unordered_map<std::string, attribute_base*> m_attributes; // written at class init -- readonly thereafter
+    deferred_message_queue m_deferred_messages;
     dict m_state;
     symbol m_classname; // what's typed in the max box
 
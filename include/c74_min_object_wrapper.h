@@ -111,11 +111,121 @@ minwrap<min_class_type>* wrapper_find_self(max::t_object* mob)
     return static_cast<minwrap<min_class_type>*>(job);
 }
 
+/// Resolves incoming Max messages to the message instances of a Min class.
+///
+/// Messages are members of the Min class, so the distance from the start of an instance to one of its messages is the same for
+/// every instance of that class. These distances are recorded once, when the class is wrapped, and keyed by the message's symbol.
+/// Dispatching a message is then a pointer-keyed lookup (or a single load for the wrappers that carry the name as a type, e.g. int,
+/// float and bang) instead of constructing a std::string and hashing it into object_base::messages() for every call.
+///
+/// Messages that do not live inside the instance (e.g. added after construction) are not cached and fall back to the name lookup.
+/// A recorded position is only used if the message there belongs to the instance and has the expected name. Otherwise (e.g. while
+/// the instance is being constructed, or for a message that this instance did not construct) the name lookup decides.
+template <class min_class_type>
+class message_dispatch
+{
+  public:
+    /// Record the position of every message in the (dummy) instance used to wrap the class.
+    /// @param	instance	An instance of the Min class, typically the one constructed for wrapping the class.
+    static void build(min_class_type& instance)
+    {
+        s_table.clear();
+        for (auto& a_message : instance.messages()) {
+            auto offset = offset_of(instance, a_message.second);
+            if (offset != k_unresolved) {
+                const symbol name{ a_message.first };
+                s_table[name] = slot{ offset, name };
+            }
+        }
+    }
+
+    /// Bind the wrapper for a name type to the message recorded by build().
+    /// @tparam	message_name_type	One of the wrapper_message_name_ types.
+    template <class message_name_type>
+    static void resolve()
+    {
+        const symbol name{ message_name_type::name };
+        auto found = s_table.find(name);
+        s_slot<message_name_type> = (found != s_table.end()) ? slot{ found->second.offset, name } : slot{};
+    }
+
+    /// Find the message of an instance for a wrapper name type.
+    /// @tparam	message_name_type	One of the wrapper_message_name_ types.
+    /// @param	instance			The instance receiving the message.
+    /// @return						The message, or nullptr if the instance has no such message.
+    template <class message_name_type>
+    static message_base* find(min_class_type& instance)
+    {
+        if (auto a_message = at(instance, s_slot<message_name_type>)) {
+            return a_message;
+        }
+        return find_by_name(instance, message_name_type::name);
+    }
+
+    /// Find the message of an instance for a message selector.
+    /// @param	instance	The instance receiving the message.
+    /// @param	s			The selector with which Max called the message.
+    /// @return				The message, or nullptr if the instance has no such message.
+    static message_base* find(min_class_type& instance, const max::t_symbol* s)
+    {
+        auto found = s_table.find(s);
+        if (found != s_table.end()) {
+            if (auto a_message = at(instance, found->second)) {
+                return a_message;
+            }
+        }
+        return find_by_name(instance, s->s_name);
+    }
+
+  private:
+    static constexpr std::ptrdiff_t k_unresolved{ -1 };
+
+    struct slot
+    {
+        std::ptrdiff_t offset{ k_unresolved };
+        const max::t_symbol* name{ nullptr };
+    };
+
+    // Keyed by the selector itself: hashing a pointer is an identity function, so no string is built or hashed.
+    static inline std::unordered_map<const max::t_symbol*, slot> s_table;
+
+    template <class message_name_type>
+    static inline slot s_slot;
+
+    static std::ptrdiff_t offset_of(const min_class_type& instance, const message_base* a_message)
+    {
+        const auto base = reinterpret_cast<std::uintptr_t>(&instance);
+        const auto address = reinterpret_cast<std::uintptr_t>(a_message);
+
+        if (address >= base && address < base + sizeof(min_class_type)) {
+            return static_cast<std::ptrdiff_t>(address - base);
+        }
+        return k_unresolved;
+    }
+
+    // The message recorded at a slot, if the instance has constructed it.
+    static message_base* at(min_class_type& instance, const slot& a_slot)
+    {
+        if (a_slot.offset == k_unresolved) {
+            return nullptr;
+        }
+
+        auto a_message = reinterpret_cast<message_base*>(reinterpret_cast<char*>(&instance) + a_slot.offset);
+        return a_message->belongs_to(&instance, a_slot.name) ? a_message : nullptr;
+    }
+
+    static message_base* find_by_name(min_class_type& instance, const char* name)
+    {
+        auto found = instance.messages().find(name);
+        return (found != instance.messages().end()) ? found->second : nullptr;
+    }
+};
+
 template <class min_class_type, class message_name_type>
 void wrapper_method_zero(max::t_object* o)
 {
     auto self = wrapper_find_self<min_class_type>(o);
-    auto& meth = *self->m_min_object.messages()[message_name_type::name];
+    auto& meth = *message_dispatch<min_class_type>::template find<message_name_type>(self->m_min_object);
 
     meth();
 }
@@ -124,27 +234,37 @@ template <class min_class_type, class message_name_type>
 void wrapper_method_int(max::t_object* o, const max::t_atom_long v)
 {
     auto self = wrapper_find_self<min_class_type>(o);
-    auto& meth = *self->m_min_object.messages()[message_name_type::name];
-    atoms as = { v };
+    auto& meth = *message_dispatch<min_class_type>::template find<message_name_type>(self->m_min_object);
 
-    meth(as);
+    if (meth.has_number_function()) {
+        meth.call_number(atom{ v }); // messages receiving atoms get the integer itself
+    }
+    else {
+        atoms as = { v };
+        meth(as);
+    }
 }
 
 template <class min_class_type, class message_name_type>
 void wrapper_method_float(max::t_object* o, const double v)
 {
     auto self = wrapper_find_self<min_class_type>(o);
-    auto& meth = *self->m_min_object.messages()[message_name_type::name];
-    atoms as = { v };
+    auto& meth = *message_dispatch<min_class_type>::template find<message_name_type>(self->m_min_object);
 
-    meth(as);
+    if (meth.has_number_function()) {
+        meth.call_number(v);
+    }
+    else {
+        atoms as = { v };
+        meth(as);
+    }
 }
 
 template <class min_class_type, class message_name_type>
 void wrapper_method_symbol(max::t_object* o, const max::t_symbol* v)
 {
     auto self = wrapper_find_self<min_class_type>(o);
-    auto& meth = *self->m_min_object.messages()[message_name_type::name];
+    auto& meth = *message_dispatch<min_class_type>::template find<message_name_type>(self->m_min_object);
     atoms as = { symbol(v) };
 
     meth(as);
@@ -154,7 +274,7 @@ template <class min_class_type, class message_name_type>
 void wrapper_method_anything(max::t_object* o, const max::t_symbol* s, const long ac, const max::t_atom* av)
 {
     auto self = wrapper_find_self<min_class_type>(o);
-    auto& meth = *self->m_min_object.messages()[message_name_type::name];
+    auto& meth = *message_dispatch<min_class_type>::template find<message_name_type>(self->m_min_object);
     atoms as(ac + 1L);
 
     as[0] = s;
@@ -168,17 +288,17 @@ template <class min_class_type, class message_name_type>
 void wrapper_method_ptr(max::t_object* o, const void* v)
 {
     auto self = wrapper_find_self<min_class_type>(o);
-    auto& meth = *self->m_min_object.messages()[message_name_type::name];
+    auto& meth = *message_dispatch<min_class_type>::template find<message_name_type>(self->m_min_object);
     atoms as = { v };
 
     meth(as);
 }
 
-template <class min_class_type>
+template <class min_class_type, class message_name_type>
 void wrapper_method_savestate(max::t_object* o, const max::t_dictionary* d)
 {
     auto self = wrapper_find_self<min_class_type>(o);
-    auto& meth = *self->m_min_object.messages()["savestate"];
+    auto& meth = *message_dispatch<min_class_type>::template find<message_name_type>(self->m_min_object);
     atoms as = { d };
     meth(as);
 }
@@ -187,7 +307,7 @@ template <class min_class_type, class message_name_type>
 void wrapper_method_self_ptr(max::t_object* o, const void* arg1)
 {
     auto self = wrapper_find_self<min_class_type>(o);
-    auto& meth = *self->m_min_object.messages()[message_name_type::name];
+    auto& meth = *message_dispatch<min_class_type>::template find<message_name_type>(self->m_min_object);
     atoms as{ o, arg1 };
 
     meth(as);
@@ -203,7 +323,7 @@ void* wrapper_method_oksize(max::t_object* o, const void* arg1)
         return 0;
     }
     else {
-        auto& meth = *self->m_min_object.messages()[message_name_type::name];
+        auto& meth = *message_dispatch<min_class_type>::template find<message_name_type>(self->m_min_object);
         atoms as{ arg1 };
         atoms r = meth(as);
         return r[0];
@@ -216,7 +336,7 @@ void wrapper_method_paint(max::t_object* o, const void* arg1)
     if (is_base_of<ui_operator_base, min_class_type>::value) {
         auto self = wrapper_find_self<min_class_type>(o);
         auto& ui_op = const_cast<ui_operator_base&>(dynamic_cast<const ui_operator_base&>(self->m_min_object));
-        auto& meth = *self->m_min_object.messages()[message_name_type::name];
+        auto& meth = *message_dispatch<min_class_type>::template find<message_name_type>(self->m_min_object);
         atoms as{ o, arg1 };
 
         ui_op.update_colors();
@@ -231,7 +351,7 @@ template <class min_class_type, class message_name_type>
 void wrapper_method_mouse(max::t_object* o, max::t_object* a_patcherview, const max::t_pt position, const max::t_atom_long modifiers)
 {
     auto self = wrapper_find_self<min_class_type>(o);
-    auto& meth = *self->m_min_object.messages()[message_name_type::name];
+    auto& meth = *message_dispatch<min_class_type>::template find<message_name_type>(self->m_min_object);
     max::t_mouseevent an_event{};
 
     an_event.type = max::eMouseEvent;
@@ -254,7 +374,7 @@ template <class min_class_type, class message_name_type>
 void wrapper_method_mousewheel(max::t_object* o, max::t_object* a_patcherview, max::t_pt position, long modifiers, double delta_x, double delta_y)
 {
     auto self = wrapper_find_self<min_class_type>(o);
-    auto& meth = *self->m_min_object.messages()[message_name_type::name];
+    auto& meth = *message_dispatch<min_class_type>::template find<message_name_type>(self->m_min_object);
     max::t_mouseevent an_event{};
 
     an_event.type = max::eMouseEvent;
@@ -273,27 +393,7 @@ template <class min_class_type, class message_name_type>
 void wrapper_method_multitouch(max::t_object* o, max::t_object* a_patcherview, const max::t_mouseevent* an_event)
 {
     auto self = wrapper_find_self<min_class_type>(o);
-    std::string name = message_name_type::name;
-
-    if (name == "mt_mouseenter") {
-        name = "mouseenter";
-    }
-    else if (name == "mt_mouseleave") {
-        name = "mouseleave";
-    }
-    else if (name == "mt_mousedown") {
-        name = "mousedown";
-    }
-    else if (name == "mt_mouseup") {
-        name = "mouseup";
-    }
-    else if (name == "mt_mousemove") {
-        name = "mousemove";
-    }
-    else if (name == "mt_mousedrag") {
-        name = "mousedrag";
-    }
-    auto& meth = *self->m_min_object.messages()[name];
+    auto& meth = *message_dispatch<min_class_type>::template find<message_name_type>(self->m_min_object);
 
     event e{ o, a_patcherview, *an_event };
     atoms as{ e };
@@ -306,6 +406,7 @@ max::t_max_err wrapper_method_self_sym_sym_ptr_ptr___err(max::t_object* o, const
     auto self = wrapper_find_self<min_class_type>(o);
 
     // This supports notify methods for UI objects which don't actually have a notify method member in the min class
+    // Notifications also arrive while the instance is constructed and destroyed, so the messages it has registered decide.
     if (self->m_min_object.messages().find(message_name_type::name) != self->m_min_object.messages().end()) {
         auto& meth = *self->m_min_object.messages()[message_name_type::name];
         atoms as{ o, s1, s2, p1, p2 }; // NOTE: self could be the jitter object rather than the max object -- so we pass `o` which is
@@ -339,7 +440,7 @@ template <class min_class_type, class message_name_type>
 void wrapper_method_self_ptr_long_ptr_long_ptr_long(max::t_object* o, const void* arg1, const max::t_atom_long arg2, const max::t_atom_long* arg3, const max::t_atom_long arg4, const max::t_atom_long* arg5, const max::t_atom_long arg6)
 {
     auto self = wrapper_find_self<min_class_type>(o);
-    auto& meth = *self->m_min_object.messages()[message_name_type::name];
+    auto& meth = *message_dispatch<min_class_type>::template find<message_name_type>(self->m_min_object);
     atoms as{ o, arg1, arg2, arg3, arg4, arg5, arg6 }; // NOTE: self could be the jitter object rather than the max object -- so we
                                                        // pass `o` which is always the correct `self` for box operations
     meth(as);
@@ -349,7 +450,7 @@ template <class min_class_type, class message_name_type>
 max::t_atom_long wrapper_method_self_ptr_long_long_long(max::t_object* o, const void* arg1, const max::t_atom_long arg2, const max::t_atom_long arg3, const max::t_atom_long arg4)
 {
     auto self = wrapper_find_self<min_class_type>(o);
-    auto& meth = *self->m_min_object.messages()[message_name_type::name];
+    auto& meth = *message_dispatch<min_class_type>::template find<message_name_type>(self->m_min_object);
     atoms as{ o, arg1, arg2, arg3, arg4 }; // NOTE: self could be the jitter object rather than the max object -- so we
                                            // pass `o` which is always the correct `self` for box operations
     auto return_value = static_cast<max::t_atom_long>(meth(as)[0]);
@@ -360,7 +461,7 @@ template <class min_class_type, class message_name_type>
 void wrapper_method_getplaystate(max::t_object* o, long* play, double* pos, long* loop)
 {
     auto self = wrapper_find_self<min_class_type>(o);
-    auto& meth = *self->m_min_object.messages()[message_name_type::name];
+    auto& meth = *message_dispatch<min_class_type>::template find<message_name_type>(self->m_min_object);
     atoms as = meth();
 
     assert(as.size() == 3);
@@ -374,7 +475,7 @@ template <class min_class_type, class message_name_type>
 void wrapper_method_dictionary(max::t_object* o, const max::t_symbol* s)
 {
     auto self = wrapper_find_self<min_class_type>(o);
-    auto& meth = *self->m_min_object.messages()[message_name_type::name];
+    auto& meth = *message_dispatch<min_class_type>::template find<message_name_type>(self->m_min_object);
     auto d = dictobj_findregistered_retain(const_cast<max::t_symbol*>(s));
     atoms as = { atom(d) };
 
@@ -407,7 +508,13 @@ template <class min_class_type>
 void wrapper_method_generic(max::t_object* o, const max::t_symbol* s, const long ac, const max::t_atom* av)
 {
     auto self = wrapper_find_self<min_class_type>(o);
-    auto& meth = *self->m_min_object.messages()[s->s_name];
+    auto& meth = *message_dispatch<min_class_type>::find(self->m_min_object, s);
+
+    if (meth.has_reference_function()) {
+        meth.call_reference(atom_reference(ac, av));
+        return;
+    }
+
     atoms as(ac);
 
     for (auto i = 0; i < ac; ++i) {
@@ -421,13 +528,20 @@ template <class min_class_type>
 void wrapper_method_generic_typed(max::t_object* o, const max::t_symbol* s, const long ac, const max::t_atom* av, max::t_atom* rv)
 {
     auto self = wrapper_find_self<min_class_type>(o);
-    auto& meth = *self->m_min_object.messages()[s->s_name];
-    atoms as(ac);
+    auto& meth = *message_dispatch<min_class_type>::find(self->m_min_object, s);
+    atoms ra;
 
-    for (auto i = 0; i < ac; ++i) {
-        as[i] = av[i];
+    if (meth.has_reference_function()) {
+        ra = meth.call_reference(atom_reference(ac, av));
+    }
+    else {
+        atoms as(ac);
+
+        for (auto i = 0; i < ac; ++i) {
+            as[i] = av[i];
+        }
+        ra = meth(as);
     }
-    atoms ra = meth(as);
 
     if (rv) {
         *rv = ra[0];
@@ -536,6 +650,7 @@ MIN_WRAPPER_CREATE_TYPE_FROM_STRING(okclose)
 MIN_WRAPPER_CREATE_TYPE_FROM_STRING(oksize)
 MIN_WRAPPER_CREATE_TYPE_FROM_STRING(paint)
 MIN_WRAPPER_CREATE_TYPE_FROM_STRING(patchlineupdate)
+MIN_WRAPPER_CREATE_TYPE_FROM_STRING(savestate)
 
 // Simplify the meth switches in the following code to reduce excessive and tedious code duplication
 
@@ -544,6 +659,7 @@ MIN_WRAPPER_CREATE_TYPE_FROM_STRING(patchlineupdate)
         max::class_addmethod(c,                                                                                                                         \
                              reinterpret_cast<max::method>(wrapper_method_##wrappermethod<min_class_type, wrapper_message_name_##methname>), #methname, \
                              max::methtype, 0);                                                                                                         \
+        message_dispatch<min_class_type>::template resolve<wrapper_message_name_##methname>();                                                           \
     }
 
 // Shared class definition code for wrapping a Min class as a Max class
@@ -569,6 +685,8 @@ max::t_class* wrap_as_max_external_common(min_class_type& instance, const char*
 
     // messages
 
+    message_dispatch<min_class_type>::build(instance);
+
     for (auto& a_message : instance.messages()) {
         // clang-format off
         MIN_WRAPPER_ADDMETHOD(c, bang, zero, A_NOTHING)
@@ -608,10 +726,14 @@ max::t_class* wrap_as_max_external_common(min_class_type& instance, const char*
             max::class_addmethod(c, reinterpret_cast<method>(wrapper_method_ellipsis<min_class_type>), a_message.first.c_str(), max::A_CANT, 0);
         else if (a_message.first == "dspsetup"); // skip -- handle it in operator classes
         else if (a_message.first == "maxclass_setup"); // for min class construction only, do not add for exposure to max
-        else if (a_message.first == "savestate")
-            max::class_addmethod(c, reinterpret_cast<max::method>(wrapper_method_savestate<min_class_type>), "appendtodictionary", max::A_CANT, 0);
-        else if (a_message.first == "mousewheel")
+        else if (a_message.first == "savestate") {
+            max::class_addmethod(c, reinterpret_cast<max::method>(wrapper_method_savestate<min_class_type, wrapper_message_name_savestate>), "appendtodictionary", max::A_CANT, 0);
+            message_dispatch<min_class_type>::template resolve<wrapper_message_name_savestate>();
+        }
+        else if (a_message.first == "mousewheel") {
             max::class_addmethod(c, reinterpret_cast<max::method>(wrapper_method_mousewheel<min_class_type, wrapper_message_name_mousewheel>), "mousewheel", max::A_CANT, 0);
+            message_dispatch<min_class_type>::template resolve<wrapper_message_name_mousewheel>();
+        }
         // clang-format on
         else {
             if (a_message.second->type() == max::A_GIMMEBACK) {
@@ -917,18 +1039,24 @@ void wrap_as_max_external(const char* cppname, const char* cmaxname, void* resou
 
     // add special messages to max class, and object messages to jitter class
     // must happen pror to max_jit_class_wrap_standard call
+    message_dispatch<min_class_type>::build(*instance);
+
     for (auto& a_message : instance->messages()) {
         MIN_WRAPPER_ADDMETHOD(c, bang, zero, A_NOTHING)
-        else MIN_WRAPPER_ADDMETHOD(c, dblclick, zero, A_CANT) else MIN_WRAPPER_ADDMETHOD(c, dspstate, int, A_CANT) else MIN_WRAPPER_ADDMETHOD(c, okclose, zero, A_CANT) else MIN_WRAPPER_ADDMETHOD(c, edclose, zero, A_CANT) else MIN_WRAPPER_ADDMETHOD(c, loadbang, zero, A_CANT) else MIN_WRAPPER_ADDMETHOD(c, anything, anything, A_GIMME) else MIN_WRAPPER_ADDMETHOD(c, int, int, A_LONG) else MIN_WRAPPER_ADDMETHOD(c, float, float, A_FLOAT) else MIN_WRAPPER_ADDMETHOD(c, dictionary, dictionary, A_SYM) else MIN_WRAPPER_ADDMETHOD(c, notify, notify, A_CANT) else MIN_WRAPPER_ADDMETHOD(c, patchlineupdate, self_ptr_long_ptr_long_ptr_long, A_CANT) else MIN_WRAPPER_ADDMETHOD(c, fileusage, ptr, A_CANT) else MIN_WRAPPER_ADDMETHOD(c, paint, paint, A_CANT) else MIN_WRAPPER_ADDMETHOD(c, mouseenter, mouse, A_CANT) else MIN_WRAPPER_ADDMETHOD(c, mt_mouseenter, multitouch, A_CANT) else MIN_WRAPPER_ADDMETHOD(c, mouseleave, mouse, A_CANT) else MIN_WRAPPER_ADDMETHOD(c, mt_mouseleave, multitouch, A_CANT) else MIN_WRAPPER_ADDMETHOD(c, mousedown, mouse, A_CANT) else MIN_WRAPPER_ADDMETHOD(c, mt_mousedown, multitouch, A_CANT) else MIN_WRAPPER_ADDMETHOD(c, mouseup, self_ptr, A_CANT) else MIN_WRAPPER_ADDMETHOD(c, mt_mouseup, multitouch, A_CANT) else MIN_WRAPPER_ADDMETHOD(c, mousemove, mouse, A_CANT) else MIN_WRAPPER_ADDMETHOD(c, mt_mousemove, multitouch, A_CANT) else MIN_WRAPPER_ADDMETHOD(c, mousedrag, mouse, A_CANT) else MIN_WRAPPER_ADDMETHOD(c, mt_mousedrag, multitouch, A_CANT) else MIN_WRAPPER_ADDMETHOD(c, oksize, oksize, A_CANT) else MIN_WRAPPER_ADDMETHOD(c, mousedragdelta, mouse, A_CANT) else MIN_WRAPPER_ADDMETHOD(c, mousedoubleclick, mouse, A_CANT) else if (a_message.first == "savestate")
-            max::class_addmethod(c, reinterpret_cast<max::method>(wrapper_method_savestate<min_class_type>), "appendtodictionary", max::A_CANT, 0);
+        else MIN_WRAPPER_ADDMETHOD(c, dblclick, zero, A_CANT) else MIN_WRAPPER_ADDMETHOD(c, dspstate, int, A_CANT) else MIN_WRAPPER_ADDMETHOD(c, okclose, zero, A_CANT) else MIN_WRAPPER_ADDMETHOD(c, edclose, zero, A_CANT) else MIN_WRAPPER_ADDMETHOD(c, loadbang, zero, A_CANT) else MIN_WRAPPER_ADDMETHOD(c, anything, anything, A_GIMME) else MIN_WRAPPER_ADDMETHOD(c, int, int, A_LONG) else MIN_WRAPPER_ADDMETHOD(c, float, float, A_FLOAT) else MIN_WRAPPER_ADDMETHOD(c, dictionary, dictionary, A_SYM) else MIN_WRAPPER_ADDMETHOD(c, notify, notify, A_CANT) else MIN_WRAPPER_ADDMETHOD(c, patchlineupdate, self_ptr_long_ptr_long_ptr_long, A_CANT) else MIN_WRAPPER_ADDMETHOD(c, fileusage, ptr, A_CANT) else MIN_WRAPPER_ADDMETHOD(c, paint, paint, A_CANT) else MIN_WRAPPER_ADDMETHOD(c, mouseenter, mouse, A_CANT) else MIN_WRAPPER_ADDMETHOD(c, mt_mouseenter, multitouch, A_CANT) else MIN_WRAPPER_ADDMETHOD(c, mouseleave, mouse, A_CANT) else MIN_WRAPPER_ADDMETHOD(c, mt_mouseleave, multitouch, A_CANT) else MIN_WRAPPER_ADDMETHOD(c, mousedown, mouse, A_CANT) else MIN_WRAPPER_ADDMETHOD(c, mt_mousedown, multitouch, A_CANT) else MIN_WRAPPER_ADDMETHOD(c, mouseup, self_ptr, A_CANT) else MIN_WRAPPER_ADDMETHOD(c, mt_mouseup, multitouch, A_CANT) else MIN_WRAPPER_ADDMETHOD(c, mousemove, mouse, A_CANT) else MIN_WRAPPER_ADDMETHOD(c, mt_mousemove, multitouch, A_CANT) else MIN_WRAPPER_ADDMETHOD(c, mousedrag, mouse, A_CANT) else MIN_WRAPPER_ADDMETHOD(c, mt_mousedrag, multitouch, A_CANT) else MIN_WRAPPER_ADDMETHOD(c, oksize, oksize, A_CANT) else MIN_WRAPPER_ADDMETHOD(c, mousedragdelta, mouse, A_CANT) else MIN_WRAPPER_ADDMETHOD(c, mousedoubleclick, mouse, A_CANT) else if (a_message.first == "savestate") {
+            max::class_addmethod(c, reinterpret_cast<max::method>(wrapper_method_savestate<min_class_type, wrapper_message_name_savestate>), "appendtodictionary", max::A_CANT, 0);
+            message_dispatch<min_class_type>::template resolve<wrapper_message_name_savestate>();
+        }
         else if (a_message.first == "dspsetup"); // skip -- handle it in operator classes
         else if (a_message.first == "maxclass_setup"); // for min class construction only, do not add for exposure to max
         else if (a_message.first == "jitclass_setup"); // for min class construction only, do not add for exposure to max
         else if (a_message.first == "mop_setup"); // for min class construction only, do not add for exposure to max
         else if (a_message.first == "maxob_setup"); // for min class construction only, do not add for exposure to max
         else if (a_message.first == "setup"); // for min class construction only, do not add for exposure to max
-        else if (a_message.first == "mousewheel")
+        else if (a_message.first == "mousewheel") {
             max::class_addmethod(c, reinterpret_cast<max::method>(wrapper_method_mousewheel<min_class_type, wrapper_message_name_mousewheel>), "mousewheel", max::A_CANT, 0);
+            message_dispatch<min_class_type>::template resolve<wrapper_message_name_mousewheel>();
+        }
         else {
             if (a_message.second->type() == max::A_GIMMEBACK) {
                 // add handlers for gimmeback messages, allowing for return values in JS and max wrapper dumpout
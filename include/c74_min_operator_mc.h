@@ -7,19 +7,245 @@
 
 namespace c74::min {
 
-/// The base class for all template specializations of sample_operator.
+class channel_state;
+
+
+// The channel counts and per-channel state with which an mc_operator<> processes audio.
+// It is prepared as a whole on the main thread when the audio is compiled, and handed to the audio thread.
+struct mc_channel_layout
+{
+    long channel_count{ 1 };
+    vector<long> input_channel_counts;
+    vector<channel_state*> states;
+    vector<std::unique_ptr<sample_lanes<k_sample_lanes>[]>> storage; // for each state, padded to a whole number of packs
+};
+
+
+/// The base class for all template specializations of mc_operator.
+/// It keeps track of the number of channels of the object's multichannel inlets and outlets.
+///
+/// The channels are negotiated with Max on the main thread.
+/// When the audio is compiled the counts are handed to the audio thread together with the per-channel state,
+/// which switches to them at the start of its next vector.
 class mc_operator_base
-{};
+{
+  public:
+    /// The number of channels of each of the object's multichannel outlets, as negotiated on the main thread.
+    /// This follows the widest signal connected to the object's inlets.
+    /// In the audio routine use the channel counts of the audio_bundle instead.
+    /// @return	The number of output channels.
+    long channel_count() const
+    {
+        return m_channel_count;
+    }
+
+    /// The number of channels of the signal connected to an inlet, as negotiated on the main thread.
+    /// @param	inlet	The index of the inlet.
+    /// @return			The number of channels, or zero if nothing is connected.
+    long input_channel_count(const size_t inlet) const
+    {
+        return inlet < m_input_channel_counts.size() ? m_input_channel_counts[inlet] : 0;
+    }
+
+    // Called on the main thread when the number of channels connected to an inlet changes.
+    // Returns true if the number of output channels changes as a result.
+    bool update_input_channel_count(const size_t inlet, const long a_channel_count)
+    {
+        if (inlet >= m_input_channel_counts.size()) {
+            m_input_channel_counts.resize(inlet + 1, 0);
+        }
+        m_input_channel_counts[inlet] = a_channel_count;
+
+        long widest{ 1 };
+        for (auto count : m_input_channel_counts) {
+            widest = std::max(widest, count);
+        }
+
+        const auto changed{ widest != m_channel_count };
+        m_channel_count = widest;
+        return changed;
+    }
+
+    // The per-channel state of the object.
+    vector<channel_state*>& channel_states()
+    {
+        return m_channel_states;
+    }
+
+    // Called on the main thread when the audio is compiled.
+    // Hands the negotiated channel counts to the audio thread, with new per-channel state sized for them.
+    void prepare_channels();
+
+    // Called on the audio thread at the start of each vector.
+    // Switches to the channels prepared last, carrying over the state of the channels that remain.
+    void update_channels();
+
+    // The number of output channels the audio thread processes, after update_channels().
+    long compiled_channel_count() const
+    {
+        const auto layout{ m_layouts.current() };
+        return layout ? layout->channel_count : 0;
+    }
+
+    // The number of channels of an inlet the audio thread processes, after update_channels().
+    long compiled_input_channel_count(const size_t inlet) const
+    {
+        const auto layout{ m_layouts.current() };
+        return layout && inlet < layout->input_channel_counts.size() ? layout->input_channel_counts[inlet] : 0;
+    }
+
+  private:
+    long m_channel_count{ 1 };
+    vector<long> m_input_channel_counts;
+    vector<channel_state*> m_channel_states;
+    handoff<mc_channel_layout> m_layouts;
+};
+
+
+/// One sample of state for each channel processed by an mc_operator<>.
+///
+/// The values for all channels are stored next to each other, so that a state with several variables
+/// is a structure of arrays and a pack of channels can be loaded from it at once (see lane_processing).
+/// New storage is prepared when the audio is compiled, and the audio thread switches to it at the start of its next vector,
+/// keeping the values of existing channels.
+/// There is no state until the audio is first compiled: access it from the audio routine.
+///
+/// @code
+/// channel_state m_history { this };
+/// @endcode
+
+class channel_state
+{
+  public:
+    /// Create per-channel state.
+    /// @param	an_owner		The mc_operator<> owning the state. Typically you should pass 'this'.
+    /// @param	initial_value	The value of each channel when it is first created.
+    explicit channel_state(mc_operator_base* an_owner, const sample initial_value = 0.0)
+        : m_initial_value{ initial_value }
+    {
+        an_owner->channel_states().push_back(this);
+    }
+
+    // State cannot be copied: its owner holds on to it.
+    channel_state(const channel_state&) = delete;
+    channel_state& operator=(const channel_state& value) = delete;
+
+    /// Access the state for a single channel, or for a pack of channels starting with the given channel.
+    /// @tparam	T		Either sample or sample_lanes<k_sample_lanes>.
+    ///					For a pack the channel must be a multiple of k_sample_lanes.
+    /// @param	channel	The index of the (first) channel.
+    /// @return			A reference to the state.
+    template <class T = sample>
+    T& get(const size_t channel)
+    {
+        assert(channel < m_size); // no storage until the audio thread has taken the channels of the compiled audio
+        return *reinterpret_cast<T*>(m_samples + channel);
+    }
+
+    /// Access the state for a single channel.
+    /// @param	channel	The index of the channel.
+    /// @return			A reference to the state.
+    sample& operator[](const size_t channel)
+    {
+        assert(channel < m_size); // as for get()
+        return m_samples[channel];
+    }
+
+    /// The number of channels for which there is state, zero until the audio thread has taken the channels of the compiled audio.
+    /// @return	The number of channels.
+    size_t size() const
+    {
+        return m_size;
+    }
+
+    /// Set the state of all channels to the same value.
+    /// @param	value	The new value for all channels.
+    void fill(const sample value)
+    {
+        for (size_t channel = 0; channel < m_size; ++channel) {
+            m_samples[channel] = value;
+        }
+    }
+
+    /// The value of each channel when it is first created.
+    /// @return	The initial value.
+    sample initial_value() const
+    {
+        return m_initial_value;
+    }
+
+    // Called on the audio thread when it switches to new storage.
+    void attach(sample* samples, const size_t a_size)
+    {
+        m_samples = samples;
+        m_size = a_size;
+    }
+
+  private:
+    sample m_initial_value;
+    sample* m_samples{ nullptr }; // owned by the audio thread
+    size_t m_size{ 0 };
+};
+
+
+inline void mc_operator_base::prepare_channels()
+{
+    using pack = sample_lanes<k_sample_lanes>;
+
+    auto       layout{ std::make_unique<mc_channel_layout>() };
+    const auto pack_count{ (static_cast<size_t>(m_channel_count) + k_sample_lanes - 1) / k_sample_lanes };
+
+    layout->channel_count = m_channel_count;
+    layout->input_channel_counts = m_input_channel_counts;
+    layout->states = m_channel_states;
+
+    for (auto state : m_channel_states) {
+        auto storage{ std::make_unique<pack[]>(pack_count) };
+        auto samples{ reinterpret_cast<sample*>(storage.get()) };
+
+        std::fill(samples, samples + pack_count * k_sample_lanes, state->initial_value());
+        layout->storage.push_back(std::move(storage));
+    }
+
+    m_layouts.publish(std::move(layout));
+}
+
+
+inline void mc_operator_base::update_channels()
+{
+    m_layouts.update([](const mc_channel_layout* previous, mc_channel_layout& next) {
+        const auto size{ static_cast<size_t>(next.channel_count) };
+
+        for (size_t index = 0; index < next.states.size(); ++index) {
+            const auto samples{ reinterpret_cast<sample*>(next.storage[index].get()) };
 
-/// Inheriting from sample_operator extends your class functionality to processing audio
-/// by calculating samples one at a time using the call operator member of your class.
+            if (previous && index < previous->states.size()) {
+                const auto kept{ std::min(size, static_cast<size_t>(previous->channel_count)) };
+                const auto previous_samples{ reinterpret_cast<const sample*>(previous->storage[index].get()) };
+                std::copy(previous_samples, previous_samples + kept, samples);
+            }
+            next.states[index]->attach(samples, size);
+        }
+    });
+}
+
+
+/// Inheriting from mc_operator extends your class functionality to processing multichannel audio.
+///
+/// The number of channels of the object's outlets follows the widest signal connected to its inlets,
+/// and is negotiated with Max automatically.
 ///
-/// Your call operator must take the same number of parameters as the input_count template arg.
-/// Additionally, your call operator must return an array of samples of the same size as the output_count template arg.
-/// For example, if your object inherits from sample_operator<3,2> then your call operator will be prototyped as:
+/// Your class may implement the call operator taking two audio_bundle arguments, as for vector_operator<>,
+/// receiving the channels of all inlets and outlets.
+///
+/// Alternatively, inherit from lane_processing too and implement a call operator processing one sample of a channel:
 /// @code
-/// samples<2> operator() (sample input1, sample input2, sample input3);
+/// template <class T>
+/// T operator()(T input, size_t channel);
 /// @endcode
+/// The channels of the first inlet are then processed k_sample_lanes at a time (T being sample_lanes<k_sample_lanes>),
+/// with single samples (T being sample) for the remaining channels.
+/// Keep state for each channel in a channel_state, accessed with `get<T>(channel)`.
 ///
 /// @tparam vector_operator_placeholder_type Unused.
 template <placeholder vector_operator_placeholder_type = placeholder::none>
@@ -61,25 +287,251 @@ class mc_operator : public mc_operator_base
         return m_vector_size;
     }
 
-    // Ideally we would also declare a pure virtual function call operator
-    // for the inheriting class to implement.
-    // That is impossible, however, because we can't generically prototype N arguments
-    // where N = output_count_param.
-    //
-    // Some example prototypes:
-    //
-    // sample operator() (sample input);
-    // samples<2> operator() (sample input1, sample input2, sample input3);
-    // void operator() (sample input1, sample input2);
-
   private:
     double m_samplerate{ c74::max::sys_getsr() }; // initialized to the global samplerate, but updated to the local samplerate when the
                                                   // dsp chain is compiled.
     int m_vector_size{ c74::max::sys_getblksize() }; // ...
-    vector<std::pair<int, attribute_base*>> m_attributes_mapped_to_inlets;
 };
 
+/// Inherit from parallel_channels in addition to mc_operator<> and lane_processing to share the channels
+/// between the audio thread and a few worker threads.
+///
+/// The channels are split into groups, one for each thread, and the audio thread waits for all groups at the end of each vector.
+/// The worker threads are shared by all objects of an external asking for the same number of them,
+/// so that many objects do not compete with each other and the audio thread for the processors.
+/// An object whose audio runs while another uses the workers, on another audio thread, processes its channels alone.
+/// Vectors with fewer samples (channels times frames) than the minimum are processed on the audio thread alone,
+/// as the cost of handing out the work would outweigh the gain.
+///
+/// The call operator is then called from several threads at once, so it may only modify the state of its channels.
+
+class parallel_channels
+{
+  public:
+    /// The number of samples below which vectors are processed on the audio thread alone.
+    static constexpr long k_default_minimum_samples{ 8192 };
+
+    /// A worker for each processor in addition to the one running the audio thread, up to three.
+    /// @return	The default number of worker threads.
+    static size_t default_thread_count()
+    {
+        const auto processors{ std::max(std::thread::hardware_concurrency(), 1u) };
+        return std::min<size_t>(processors - 1, 3);
+    }
+
+    /// Set up the worker threads, or join those of other objects. They are started when the audio is compiled.
+    /// @param	a_thread_count		The number of threads in addition to the audio thread.
+    /// @param	minimum_samples		The number of samples below which vectors are processed on the audio thread alone.
+    explicit parallel_channels(const size_t a_thread_count = default_thread_count(), const long minimum_samples = k_default_minimum_samples)
+        : m_workers{ shared_workers(a_thread_count) }
+        , m_minimum_samples{ minimum_samples }
+    {
+    }
+
+    /// The threads sharing the processing of the channels, shared with other objects.
+    /// @return	The worker pool.
+    worker_pool& channel_workers()
+    {
+        return *m_workers;
+    }
+
+    /// The number of samples below which vectors are processed on the audio thread alone.
+    /// @return	The minimum number of samples (channels times frames).
+    long minimum_parallel_samples() const
+    {
+        return m_minimum_samples;
+    }
+
+  private:
+    std::shared_ptr<worker_pool> m_workers;
+    long m_minimum_samples;
+
+    // The pool with a number of threads, created for the first object asking for it and stopped with the last one.
+    static std::shared_ptr<worker_pool> shared_workers(const size_t a_thread_count)
+    {
+        static std::mutex mutex;
+        static std::unordered_map<size_t, std::weak_ptr<worker_pool>> pools;
+
+        std::lock_guard<std::mutex> lock{ mutex };
+        auto& pool{ pools[a_thread_count] };
+        auto workers{ pool.lock() };
+
+        if (!workers) {
+            workers = std::make_shared<worker_pool>(a_thread_count);
+            pool = workers;
+        }
+        return workers;
+    }
+};
+
+
 template <class min_class_type, enable_if_mc_operator<min_class_type> = 0>
 void min_dsp64_attrmap(minwrap<min_class_type>* self, const short* count) {}
 
+// Update the number of channels of each inlet and hand them to the audio thread with new per-channel state when the audio is compiled.
+template <class min_class_type, enable_if_mc_operator<min_class_type> = 0>
+void min_dsp64_channels(minwrap<min_class_type>* self, max::t_object* dsp64)
+{
+    auto& op{ self->m_min_object };
+
+    using namespace c74::max;
+    for (size_t i = 0; i < op.inlets().size(); ++i) {
+        const auto count{ object_method_direct(long, (max::t_object*, max::t_object*, long), dsp64, symbol("getnuminputchannels"),
+                                               self->maxobj(), static_cast<long>(i)) };
+        op.update_input_channel_count(i, count);
+    }
+
+    op.prepare_channels();
+
+    if constexpr (is_base_of<parallel_channels, min_class_type>::value) {
+        const auto vector_duration{ op.samplerate() > 0
+                                        ? std::chrono::microseconds{ static_cast<long long>(1e6 * op.vector_size() / op.samplerate()) }
+                                        : worker_pool::k_default_vector_duration };
+        op.channel_workers().start(vector_duration);
+    }
+}
+
+// The "multichanneloutputs" method: Max asks for the number of channels of an outlet.
+template <class min_class_type>
+long min_mc_multichanneloutputs(minwrap<min_class_type>* self, const long index)
+{
+    return self->m_min_object.channel_count();
+}
+
+// The "inputchanged" method: Max reports the number of channels connected to an inlet.
+// Returns true if the number of channels of the outlets changes as a result.
+template <class min_class_type>
+long min_mc_inputchanged(minwrap<min_class_type>* self, const long index, const long count)
+{
+    return self->m_min_object.update_input_channel_count(index, count);
+}
+
+
+// Process a range of channels with an mc_operator<> using lane_processing.
+// The first channel must be a multiple of k_sample_lanes.
+template <class min_class_type>
+void perform_channel_range(min_class_type& op, const double** in_chans, const long input_channels, double** out_chans, const long first_channel,
+                           const long end_channel, const long sampleframes)
+{
+    using pack = sample_lanes<k_sample_lanes>;
+    constexpr auto lane_count{ static_cast<long>(k_sample_lanes) };
+
+    long channel{ first_channel };
+
+    for (; channel + lane_count <= end_channel; channel += lane_count) {
+        const double* ins[k_sample_lanes];
+        double* outs[k_sample_lanes];
+
+        for (auto lane = 0; lane < lane_count; ++lane) {
+            ins[lane] = in_chans[(channel + lane) % input_channels];
+            outs[lane] = out_chans[channel + lane];
+        }
+
+        for (auto i = 0; i < sampleframes; ++i) {
+            pack x;
+            for (auto lane = 0; lane < lane_count; ++lane) {
+                x[lane] = ins[lane][i];
+            }
+
+            const pack y{ op(x, channel) };
+
+            for (auto lane = 0; lane < lane_count; ++lane) {
+                outs[lane][i] = y[lane];
+            }
+        }
+    }
+
+    for (; channel < end_channel; ++channel) {
+        auto in{ in_chans[channel % input_channels] };
+        auto out{ out_chans[channel] };
+
+        for (auto i = 0; i < sampleframes; ++i) {
+            out[i] = op(in[i], channel);
+        }
+    }
+}
+
+/// Process a vector of samples with an mc_operator<> using lane_processing.
+/// Each output channel is calculated from the input channel with the same index, wrapping around the input channels if there are fewer.
+/// Output channels are processed k_sample_lanes at a time, followed by the remaining channels one at a time.
+///
+/// @param	op					The mc operator.
+/// @param	in_chans			The input samples of the first inlet, one pointer for each channel.
+/// @param	input_channels		The number of input channels.
+/// @param	out_chans			The output samples, one pointer for each channel.
+/// @param	output_channels		The number of output channels.
+/// @param	sampleframes		The number of frames to process.
+template <class min_class_type>
+void perform_channel_lanes(min_class_type& op, const double** in_chans, const long input_channels, double** out_chans, const long output_channels,
+                           const long sampleframes)
+{
+    if (input_channels < 1) {
+        return;
+    }
+    perform_channel_range(op, in_chans, input_channels, out_chans, 0, output_channels, sampleframes);
+}
+
+/// Process a vector of samples with an mc_operator<> using lane_processing and parallel_channels.
+/// The channels are split into a group for each thread of the operator's worker pool and the audio thread.
+/// Parameters are as for perform_channel_lanes().
+template <class min_class_type>
+void perform_channel_lanes_parallel(min_class_type& op, const double** in_chans, const long input_channels, double** out_chans,
+                                    const long output_channels, const long sampleframes)
+{
+    auto& workers{ op.channel_workers() };
+    const auto packs{ static_cast<long>((output_channels + k_sample_lanes - 1) / k_sample_lanes) };
+    const auto threads{ std::min(static_cast<long>(workers.thread_count()) + 1, packs) };
+
+    if (input_channels < 1 || threads < 2 || !workers.running() || output_channels * sampleframes < op.minimum_parallel_samples()) {
+        perform_channel_lanes(op, in_chans, input_channels, out_chans, output_channels, sampleframes);
+        return;
+    }
+
+    const auto channels_per_task{ (packs + threads - 1) / threads * static_cast<long>(k_sample_lanes) };
+    auto task = [&](const size_t index) {
+        const auto first_channel{ static_cast<long>(index) * channels_per_task };
+        const auto end_channel{ std::min(first_channel + channels_per_task, output_channels) };
+
+        if (first_channel < end_channel) {
+            perform_channel_range(op, in_chans, input_channels, out_chans, first_channel, end_channel, sampleframes);
+        }
+    };
+
+    workers.run(threads, task);
+}
+
+// The performer class wraps the C callback routine for a Max audio "perform" method.
+// This specialization is for mc_operator<> classes that also inherit from lane_processing.
+// The signals of the first inlet are processed to the first outlet.
+template <class min_class_type>
+class performer<min_class_type,
+                typename enable_if<is_base_of<mc_operator_base, min_class_type>::value
+                                   && is_base_of<lane_processing, min_class_type>::value>::type>
+{
+  public:
+    static void perform(minwrap<min_class_type>* self, max::t_object* dsp64, const double** in_chans, const long numins, double** out_chans, const long numouts, const long sampleframes, const long, const void*)
+    {
+        auto& op{ self->m_min_object };
+
+        op.update_channels();
+
+        const auto input_channels{ std::min(op.compiled_input_channel_count(0), numins) };
+        const auto output_channels{ std::min(op.compiled_channel_count(), numouts) };
+
+        // more channels than there is state for, until the audio thread switches to the state prepared for them
+        for (auto channel = output_channels; channel < numouts; ++channel) {
+            std::fill(out_chans[channel], out_chans[channel] + sampleframes, 0.0);
+        }
+
+        apply_control_events(op, op.samplerate(), sampleframes);
+
+        if constexpr (is_base_of<parallel_channels, min_class_type>::value) {
+            perform_channel_lanes_parallel(op, in_chans, input_channels, out_chans, output_channels, sampleframes);
+        }
+        else {
+            perform_channel_lanes(op, in_chans, input_channels, out_chans, output_channels, sampleframes);
+        }
+    }
+};
+
 } // namespace c74::min
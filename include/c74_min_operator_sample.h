@@ -30,7 +30,7 @@ class sample_operator : public sample_operator_base
 
     sample_operator() {}
 
-    /// Get pointers to the attributes mapped to audio inlets
+    /// Get the attributes mapped to audio inlets
     auto& mapped_attributes()
     {
         return m_attributes_mapped_to_inlets;
@@ -82,6 +82,23 @@ class sample_operator : public sample_operator_base
         return m_vector_size;
     }
 
+    ///	Set the index of the frame being processed.
+    /// You will not typically have any need to call this.
+    /// It is called internally for each frame processed by your call operator.
+    /// @param	a_frame		The index of the frame in the current vector of samples.
+    void frame(const long a_frame)
+    {
+        m_frame = a_frame;
+    }
+
+    /// Return the index of the frame being processed by your call operator.
+    /// This is the offset to pass to an event_outlet when sending an event for the current sample.
+    /// @return	The index of the frame in the current vector of samples.
+    long frame() const
+    {
+        return m_frame;
+    }
+
     // Ideally we would also declare a pure virtual function call operator
     // for the inheriting class to implement.
     // That is impossible, however, because we can't generically prototype N arguments
@@ -97,7 +114,8 @@ class sample_operator : public sample_operator_base
     double m_samplerate{ c74::max::sys_getsr() }; // initialized to the global samplerate, but updated to the local samplerate when the
                                                   // dsp chain is compiled.
     int m_vector_size{ c74::max::sys_getblksize() }; // ...
-    vector<std::pair<int, attribute_base*>> m_attributes_mapped_to_inlets;
+    long m_frame{ 0 };
+    vector<mapped_attribute> m_attributes_mapped_to_inlets;
 };
 
 template <class min_class_type, enable_if_sample_operator<min_class_type> = 0>
@@ -111,7 +129,7 @@ void min_dsp64_attrmap(minwrap<min_class_type>* self, const short* count)
     for (auto i = 0; i < inlets.size(); ++i) {
         auto& inlet = inlets[i];
         if (inlet->has_signal_connection() && inlet->has_attribute_mapping()) {
-            attrs.push_back({ i, inlet->attribute() });
+            attrs.emplace_back(i, inlet->attribute());
         }
     }
 }
@@ -192,7 +210,8 @@ void perform_copy_output(minwrap<min_class_type>* self, const size_t index, doub
 // For sample_operator<> there are several versions of this wrapping/adapting callback.
 // This one is optimized for the most common case: a single input and a single output.
 template <class min_class_type>
-class performer<min_class_type, typename enable_if<is_base_of<sample_operator<1, 1>, min_class_type>::value>::type>
+class performer<min_class_type, typename enable_if<is_base_of<sample_operator<1, 1>, min_class_type>::value
+                                                   && !is_base_of<lane_processing, min_class_type>::value>::type>
 {
   public:
     // The traditional Max audio "perform" callback routine
@@ -201,18 +220,22 @@ class performer<min_class_type, typename enable_if<is_base_of<sample_operator<1,
         auto in_samps = in_chans[0];
         auto out_samps = out_chans[0];
 
-        for (auto i = 0; i < sampleframes; ++i) {
-            auto in = in_samps[i];
-            auto out = self->m_min_object(in);
-            out_samps[i] = out;
-        }
+        perform_with_control_events(self->m_min_object, self->m_min_object.samplerate(), sampleframes, [&](const long start, const long end) {
+            for (auto i = start; i < end; ++i) {
+                self->m_min_object.frame(i);
+                auto in = in_samps[i];
+                auto out = self->m_min_object(in);
+                out_samps[i] = out;
+            }
+        });
     }
 };
 
 // The performer class wraps the C callback routine for a Max audio "perform" method.
 // This specialization is for a single input with no outputs
 template <class min_class_type>
-class performer<min_class_type, typename enable_if<is_base_of<sample_operator<1, 0>, min_class_type>::value>::type>
+class performer<min_class_type, typename enable_if<is_base_of<sample_operator<1, 0>, min_class_type>::value
+                                                   && !is_base_of<lane_processing, min_class_type>::value>::type>
 {
   public:
     // The traditional Max audio "perform" callback routine
@@ -220,10 +243,13 @@ class performer<min_class_type, typename enable_if<is_base_of<sample_operator<1,
     {
         auto in_samps = in_chans[0];
 
-        for (auto i = 0; i < sampleframes; ++i) {
-            auto in = in_samps[i];
-            self->m_min_object(in);
-        }
+        perform_with_control_events(self->m_min_object, self->m_min_object.samplerate(), sampleframes, [&](const long start, const long end) {
+            for (auto i = start; i < end; ++i) {
+                self->m_min_object.frame(i);
+                auto in = in_samps[i];
+                self->m_min_object(in);
+            }
+        });
     }
 };
 
@@ -234,7 +260,8 @@ template <class min_class_type>
 class performer<min_class_type,
                 typename enable_if<is_base_of<sample_operator_base, min_class_type>::value
                                    && !is_base_of<sample_operator<1, 1>, min_class_type>::value
-                                   && !is_base_of<sample_operator<1, 0>, min_class_type>::value>::type>
+                                   && !is_base_of<sample_operator<1, 0>, min_class_type>::value
+                                   && !is_base_of<lane_processing, min_class_type>::value>::type>
 {
   public:
     static void perform(minwrap<min_class_type>* self, max::t_object* dsp64, const double** in_chans, const long numins, double** out_chans, const long numouts, const long sampleframes, const long, const void*)
@@ -242,49 +269,180 @@ class performer<min_class_type,
         auto& attrs{ self->m_min_object.mapped_attributes() };
         const auto input_count{ self->m_min_object.input_count() };
 
-        if (attrs.empty()) {
+        perform_with_control_events(self->m_min_object, self->m_min_object.samplerate(), sampleframes, [&](const long start, const long end) {
+            if (attrs.empty()) {
+
+                // the typical case:
+                for (auto i = start; i < end; ++i) {
+                    callable_samples<min_class_type, min_class_type::input_count()> ins(self);
+                    self->m_min_object.frame(i);
+
+                    for (auto chan = 0; chan < input_count; ++chan) {
+                        ins.set(chan, in_chans[chan][i]);
+                    }
 
-            // the typical case:
-            for (auto i = 0; i < sampleframes; ++i) {
-                callable_samples<min_class_type, min_class_type::input_count()> ins(self);
+                    auto out = ins.call();
 
-                for (auto chan = 0; chan < input_count; ++chan) {
-                    ins.set(chan, in_chans[chan][i]);
+                    if (numouts > 0) {
+                        perform_copy_output(self, i, out_chans, out);
+                    }
                 }
+            }
+            else {
+
+                // the case where audio inlets are mapped to attributes
+                for (auto i = start; i < end; ++i) {
+                    callable_samples<min_class_type, min_class_type::input_count()> ins(self);
+                    self->m_min_object.frame(i);
+
+                    for (auto& attr : attrs) {
+                        attr.set(in_chans[attr.inlet()][i]);
+                    }
+
+                    for (auto chan = 0; chan < input_count; ++chan) {
+                        ins.set(chan, in_chans[chan][i]);
+                    }
 
-                auto out = ins.call();
+                    auto out = ins.call();
 
-                if (numouts > 0) {
-                    perform_copy_output(self, i, out_chans, out);
+                    if (numouts > 0) {
+                        perform_copy_output(self, i, out_chans, out);
+                    }
                 }
             }
+        });
+    }
+};
+
+
+// Load the samples of one input for the call operator of a sample_operator<> using lane_processing:
+// a single sample for the remaining frames, or a pack of samples starting at the frame.
+template <class T>
+T perform_load_input(const sample* input)
+{
+    if constexpr (is_same<T, sample>::value) {
+        return *input;
+    }
+    else {
+        return T::load(input);
+    }
+}
+
+// Store the value returned from the call operator of a sample_operator<> using lane_processing.
+template <class T>
+void perform_store_output(const T& value, sample* output)
+{
+    if constexpr (is_same<T, sample>::value) {
+        *output = value;
+    }
+    else {
+        value.store(output);
+    }
+}
+
+template <class T, size_t count>
+void perform_store_outputs(const std::array<T, count>& values, double** out_chans, const long index)
+{
+    for (size_t chan = 0; chan < count; ++chan) {
+        perform_store_output(values[chan], out_chans[chan] + index);
+    }
+}
+
+template <class T>
+void perform_store_outputs(const T& value, double** out_chans, const long index)
+{
+    perform_store_output(value, out_chans[0] + index);
+}
+
+// Make one call to the call operator of a sample_operator<> using lane_processing,
+// with T being either a sample or a sample_lanes<>, and store its results.
+template <class T, class min_class_type, size_t... Is>
+void perform_lanes_call(min_class_type& op, const double** in_chans, double** out_chans, const long numouts, const long index,
+                        std::index_sequence<Is...>)
+{
+    if constexpr (std::is_void<decltype(op(perform_load_input<T>(in_chans[Is] + index)...))>::value) {
+        op(perform_load_input<T>(in_chans[Is] + index)...);
+    }
+    else {
+        auto out = op(perform_load_input<T>(in_chans[Is] + index)...);
+
+        if (numouts > 0) {
+            perform_store_outputs(out, out_chans, index);
         }
-        else {
+    }
+}
 
-            // the case where audio inlets are mapped to attributes
-            for (auto i = 0; i < sampleframes; ++i) {
-                callable_samples<min_class_type, min_class_type::input_count()> ins(self);
+/// Process a vector of samples with a sample_operator<> using lane_processing.
+/// Frames are processed k_sample_lanes at a time, followed by the remaining frames one at a time.
+/// While a pack is processed frame() is the index of its first frame.
+///
+/// @param	op				The sample operator.
+/// @param	in_chans		The input samples, one pointer for each of the operator's inputs.
+/// @param	out_chans		The output samples, one pointer for each of the operator's outputs.
+/// @param	numouts			The number of outputs connected.
+/// @param	start			The first frame to process.
+/// @param	end				The frame after the last frame to process.
+template <class min_class_type>
+void perform_lanes(min_class_type& op, const double** in_chans, double** out_chans, const long numouts, const long start, const long end)
+{
+    using lanes = std::make_index_sequence<min_class_type::input_count()>;
+    constexpr auto lane_count{ static_cast<long>(k_sample_lanes) };
+    long i{ start };
 
-                for (auto& inletnum_and_attr : attrs) {
-                    int inletnum{ inletnum_and_attr.first };
-                    attribute_base* attr{ inletnum_and_attr.second };
-                    auto value{ in_chans[inletnum][i] };
-                    atoms a{ { value } };
+    for (; i + lane_count <= end; i += lane_count) {
+        op.frame(i);
+        perform_lanes_call<sample_lanes<k_sample_lanes>>(op, in_chans, out_chans, numouts, i, lanes());
+    }
+    for (; i < end; ++i) {
+        op.frame(i);
+        perform_lanes_call<sample>(op, in_chans, out_chans, numouts, i, lanes());
+    }
+}
 
-                    attr->set(a, false, false);
-                }
+/// Process a vector of samples with a sample_operator<> using lane_processing.
+///
+/// @param	op				The sample operator.
+/// @param	in_chans		The input samples, one pointer for each of the operator's inputs.
+/// @param	out_chans		The output samples, one pointer for each of the operator's outputs.
+/// @param	numouts			The number of outputs connected.
+/// @param	sampleframes	The number of frames to process.
+template <class min_class_type>
+void perform_lanes(min_class_type& op, const double** in_chans, double** out_chans, const long numouts, const long sampleframes)
+{
+    perform_lanes(op, in_chans, out_chans, numouts, 0, sampleframes);
+}
 
-                for (auto chan = 0; chan < input_count; ++chan) {
-                    ins.set(chan, in_chans[chan][i]);
-                }
+// The performer class wraps the C callback routine for a Max audio "perform" method.
+// This specialization is for sample_operator<> classes that also inherit from lane_processing.
+template <class min_class_type>
+class performer<min_class_type,
+                typename enable_if<is_base_of<sample_operator_base, min_class_type>::value
+                                   && is_base_of<lane_processing, min_class_type>::value>::type>
+{
+  public:
+    static void perform(minwrap<min_class_type>* self, max::t_object* dsp64, const double** in_chans, const long numins, double** out_chans, const long numouts, const long sampleframes, const long, const void*)
+    {
+        auto& attrs{ self->m_min_object.mapped_attributes() };
+        using lanes = std::make_index_sequence<min_class_type::input_count()>;
 
-                auto out = ins.call();
+        perform_with_control_events(self->m_min_object, self->m_min_object.samplerate(), sampleframes, [&](const long start, const long end) {
+            if (attrs.empty()) {
+                perform_lanes(self->m_min_object, in_chans, out_chans, numouts, start, end);
+            }
+            else {
+
+                // attributes mapped to audio inlets may change with every frame, so frames are processed one at a time
+                for (auto i = start; i < end; ++i) {
+                    self->m_min_object.frame(i);
 
-                if (numouts > 0) {
-                    perform_copy_output(self, i, out_chans, out);
+                    for (auto& attr : attrs) {
+                        attr.set(in_chans[attr.inlet()][i]);
+                    }
+
+                    perform_lanes_call<sample>(self->m_min_object, in_chans, out_chans, numouts, i, lanes());
                 }
             }
-        }
+        });
     }
 };
 
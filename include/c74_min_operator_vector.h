@@ -7,7 +7,307 @@
 
 namespace c74::min {
 
+/// A view of the samples of one channel of an audio_bundle.
+class sample_span
+{
+  public:
+    /// Create a view of a vector of samples.
+    /// @param	samples		A pointer to the first sample.
+    /// @param	frame_count	The number of samples.
+    sample_span(sample* samples, const long frame_count)
+        : m_samples{ samples }
+        , m_frame_count{ frame_count }
+    {
+    }
+
+    /// Get a pointer to the samples.
+    /// @return	A pointer to the first sample.
+    sample* data() const
+    {
+        return m_samples;
+    }
+
+    /// Determine the number of samples.
+    /// @return	The number of samples.
+    long size() const
+    {
+        return m_frame_count;
+    }
+
+    sample& operator[](const long index) const
+    {
+        return m_samples[index];
+    }
+
+    sample* begin() const
+    {
+        return m_samples;
+    }
+
+    sample* end() const
+    {
+        return m_samples + m_frame_count;
+    }
+
+    /// Determine if two views share any samples.
+    /// When processing in place an output channel may be the same memory as an input channel.
+    /// @param	other	The other view.
+    /// @return			True if writing to one view may change the samples of the other.
+    bool overlaps(const sample_span& other) const
+    {
+        return m_samples < other.end() && other.m_samples < end();
+    }
+
+    // Bulk operations.
+    // These process k_sample_lanes frames at a time using sample_lanes, followed by the frames left over.
+    // Where another view is given it must have at least as many samples,
+    // and must be either the same samples as this view or not overlap it at all.
+
+    /// Set all samples to zero.
+    void clear() const
+    {
+        std::fill(begin(), end(), 0.0);
+    }
+
+    /// Copy the samples of another view to this view.
+    /// @param	source	The view from which to copy.
+    void copy(const sample_span& source) const
+    {
+        if (source.m_samples != m_samples) {
+            std::copy(source.m_samples, source.m_samples + m_frame_count, m_samples);
+        }
+    }
+
+    /// Add the samples of another view to this view.
+    /// @param	source	The view to add.
+    void add(const sample_span& source) const
+    {
+        long i{ 0 };
+        for (; i < pack_end(); i += k_sample_lanes) {
+            (pack::load(m_samples + i) + pack::load(source.m_samples + i)).store(m_samples + i);
+        }
+        for (; i < m_frame_count; ++i) {
+            m_samples[i] += source.m_samples[i];
+        }
+    }
+
+    /// Multiply all samples by a gain.
+    /// @param	gain	The gain.
+    void scale(const sample gain) const
+    {
+        long i{ 0 };
+        for (; i < pack_end(); i += k_sample_lanes) {
+            (pack::load(m_samples + i) * gain).store(m_samples + i);
+        }
+        for (; i < m_frame_count; ++i) {
+            m_samples[i] *= gain;
+        }
+    }
+
+    /// Add the samples of another view, multiplied by a gain, to this view.
+    /// @param	source	The view to add.
+    /// @param	gain	The gain applied to the source.
+    void mix(const sample_span& source, const sample gain) const
+    {
+        long i{ 0 };
+        for (; i < pack_end(); i += k_sample_lanes) {
+            (pack::load(m_samples + i) + pack::load(source.m_samples + i) * gain).store(m_samples + i);
+        }
+        for (; i < m_frame_count; ++i) {
+            m_samples[i] += source.m_samples[i] * gain;
+        }
+    }
+
+    /// Multiply the samples by a gain moving in a straight line from one value to another.
+    /// Frame i is multiplied by `start + (end - start) * i / size()`,
+    /// so that a following vector starting at `end` continues the line without a step.
+    /// @param	start	The gain for the first frame.
+    /// @param	end		The gain at the end of the vector.
+    void ramp(const sample start, const sample end) const
+    {
+        if (m_frame_count < 1) {
+            return;
+        }
+
+        const auto step{ (end - start) / m_frame_count };
+        pack       steps;
+        for (size_t lane = 0; lane < k_sample_lanes; ++lane) {
+            steps[lane] = step * lane;
+        }
+
+        long i{ 0 };
+        for (; i < pack_end(); i += k_sample_lanes) {
+            (pack::load(m_samples + i) * (steps + (start + step * i))).store(m_samples + i);
+        }
+        for (; i < m_frame_count; ++i) {
+            m_samples[i] *= start + step * i;
+        }
+    }
+
+    /// Find the largest absolute sample value.
+    /// @return	The peak value, or zero if there are no samples.
+    sample peak() const
+    {
+        using std::abs;
+        using std::max;
+
+        pack peaks{ 0.0 };
+        long i{ 0 };
+        for (; i < pack_end(); i += k_sample_lanes) {
+            peaks = max(peaks, abs(pack::load(m_samples + i)));
+        }
+
+        sample result{ 0.0 };
+        for (size_t lane = 0; lane < k_sample_lanes; ++lane) {
+            result = max(result, peaks[lane]);
+        }
+        for (; i < m_frame_count; ++i) {
+            result = max(result, abs(m_samples[i]));
+        }
+        return result;
+    }
+
+    /// Sum the squares of the samples.
+    /// @return	The sum of the squares of the samples.
+    sample sum_of_squares() const
+    {
+        pack sums{ 0.0 };
+        long i{ 0 };
+        for (; i < pack_end(); i += k_sample_lanes) {
+            const auto x{ pack::load(m_samples + i) };
+            sums += x * x;
+        }
+
+        sample result{ 0.0 };
+        for (size_t lane = 0; lane < k_sample_lanes; ++lane) {
+            result += sums[lane];
+        }
+        for (; i < m_frame_count; ++i) {
+            result += m_samples[i] * m_samples[i];
+        }
+        return result;
+    }
+
+    /// Find the root-mean-square of the samples.
+    /// @return	The RMS value, or zero if there are no samples.
+    sample rms() const
+    {
+        return m_frame_count > 0 ? std::sqrt(sum_of_squares() / m_frame_count) : 0.0;
+    }
+
+    /// Find out if all samples are finite, i.e. none of them are NaN or infinite.
+    /// @return	True if all samples are finite.
+    bool finite() const
+    {
+        // x - x is zero for a finite sample and NaN otherwise, so a sum of them is only zero if all samples are finite
+        pack differences{ 0.0 };
+        long i{ 0 };
+        for (; i < pack_end(); i += k_sample_lanes) {
+            const auto x{ pack::load(m_samples + i) };
+            differences += x - x;
+        }
+
+        sample result{ 0.0 };
+        for (size_t lane = 0; lane < k_sample_lanes; ++lane) {
+            result += differences[lane];
+        }
+        for (; i < m_frame_count; ++i) {
+            result += m_samples[i] - m_samples[i];
+        }
+        return result == 0.0;
+    }
+
+  private:
+    using pack = sample_lanes<k_sample_lanes>;
+
+    sample* m_samples;
+    long m_frame_count;
+
+    // The end of the frames that can be processed as whole packs.
+    long pack_end() const
+    {
+        return m_frame_count - m_frame_count % static_cast<long>(k_sample_lanes);
+    }
+};
+
+
+/// A range over the channels of an audio_bundle, in the form of a sample_span for each channel.
+/// @code
+/// for (auto channel : output.channels())
+///     std::fill(channel.begin(), channel.end(), 0.0);
+/// @endcode
+class channel_range
+{
+  public:
+    class iterator
+    {
+      public:
+        iterator(double* const* channel, const long frame_count)
+            : m_channel{ channel }
+            , m_frame_count{ frame_count }
+        {
+        }
+
+        sample_span operator*() const
+        {
+            return { *m_channel, m_frame_count };
+        }
+
+        iterator& operator++()
+        {
+            ++m_channel;
+            return *this;
+        }
+
+        bool operator!=(const iterator& other) const
+        {
+            return m_channel != other.m_channel;
+        }
+
+        bool operator==(const iterator& other) const
+        {
+            return m_channel == other.m_channel;
+        }
+
+      private:
+        double* const* m_channel;
+        long m_frame_count;
+    };
+
+    channel_range(double* const* samples, const long channel_count, const long frame_count)
+        : m_samples{ samples }
+        , m_channel_count{ channel_count }
+        , m_frame_count{ frame_count }
+    {
+    }
+
+    iterator begin() const
+    {
+        return { m_samples, m_frame_count };
+    }
+
+    iterator end() const
+    {
+        return { m_samples + m_channel_count, m_frame_count };
+    }
+
+    long size() const
+    {
+        return m_channel_count;
+    }
+
+  private:
+    double* const* m_samples;
+    long m_channel_count;
+    long m_frame_count;
+};
+
+
 /// An audio bundle is a container for N channels of M-sized vectors of audio sample values.
+///
+/// If the object processes in place (see inplace_processing) the channels of the input and output bundles may be the same memory.
+/// Use the sample_span views returned by channel() and channels() together with sample_span::overlaps() or shares_memory_with()
+/// to find out, e.g. to read all inputs for a frame before writing the outputs for that frame.
 struct audio_bundle
 {
 
@@ -41,6 +341,38 @@ struct audio_bundle
         return m_samples[channel];
     }
 
+    /// Get a view of the samples for a specific channel.
+    /// @param	channel		The channel for which to fetch the view.
+    ///						NOTE: No bounds checking is performed!
+    /// @return				A view of the samples in the specified channel.
+    sample_span channel(const size_t channel) const
+    {
+        return { m_samples[channel], m_frame_count };
+    }
+
+    /// Get a range of views of the samples of each channel.
+    /// @return	The range of channels.
+    channel_range channels() const
+    {
+        return { m_samples, m_channel_count, m_frame_count };
+    }
+
+    /// Determine if any channel of this bundle is the same memory as any channel of another bundle.
+    /// This is the case for an input and output bundle when the object processes in place.
+    /// @param	other	The other bundle.
+    /// @return			True if writing to one bundle may change the samples of the other.
+    bool shares_memory_with(const audio_bundle& other) const
+    {
+        for (auto a_channel : channels()) {
+            for (auto other_channel : other.channels()) {
+                if (a_channel.overlaps(other_channel)) {
+                    return true;
+                }
+            }
+        }
+        return false;
+    }
+
     /// Determine the number of channels in an audio bundle.
     /// @return		The number of channels in the audio bundle.
     // The return type is a long because that is what the callback from Max provides us.
@@ -60,11 +392,83 @@ struct audio_bundle
     /// Zero-out the data in the entire audio bundle.
     void clear()
     {
+        for (auto channel : channels()) {
+            channel.clear();
+        }
+    }
+
+    /// Add the contents of another audio bundle to this one, channel by channel.
+    /// The other bundle must have at least as many channels and the same frame count.
+    /// @param	other	The audio_bundle to add.
+    void add(const audio_bundle& other)
+    {
+        assert(m_channel_count <= other.m_channel_count);
+        assert(m_frame_count == other.m_frame_count);
+
         for (auto channel = 0; channel < m_channel_count; ++channel) {
-            for (auto i = 0; i < m_frame_count; ++i) {
-                m_samples[channel][i] = 0.0;
-            }
+            this->channel(channel).add(other.channel(channel));
+        }
+    }
+
+    /// Multiply the entire audio bundle by a gain.
+    /// @param	gain	The gain.
+    void scale(const sample gain)
+    {
+        for (auto channel : channels()) {
+            channel.scale(gain);
+        }
+    }
+
+    /// Add the contents of another audio bundle, multiplied by a gain, to this one, channel by channel.
+    /// The other bundle must have at least as many channels and the same frame count.
+    /// @param	other	The audio_bundle to add.
+    /// @param	gain	The gain applied to the other bundle.
+    void mix(const audio_bundle& other, const sample gain)
+    {
+        assert(m_channel_count <= other.m_channel_count);
+        assert(m_frame_count == other.m_frame_count);
+
+        for (auto channel = 0; channel < m_channel_count; ++channel) {
+            this->channel(channel).mix(other.channel(channel), gain);
+        }
+    }
+
+    /// Multiply the entire audio bundle by a gain moving in a straight line from one value to another,
+    /// e.g. to fade or to change gain without clicks. See sample_span::ramp().
+    /// @param	start	The gain for the first frame.
+    /// @param	end		The gain at the end of the vector.
+    void ramp(const sample start, const sample end)
+    {
+        for (auto channel : channels()) {
+            channel.ramp(start, end);
+        }
+    }
+
+    /// Find the largest absolute sample value in any channel.
+    /// @return	The peak value.
+    sample peak() const
+    {
+        sample result{ 0.0 };
+        for (auto channel : channels()) {
+            result = std::max(result, channel.peak());
         }
+        return result;
+    }
+
+    /// Find the root-mean-square of the samples of all channels together.
+    /// Use channel(n).rms() for the RMS of a single channel.
+    /// @return	The RMS value.
+    sample rms() const
+    {
+        if (m_channel_count < 1 || m_frame_count < 1) {
+            return 0.0;
+        }
+
+        sample sum{ 0.0 };
+        for (auto channel : channels()) {
+            sum += channel.sum_of_squares();
+        }
+        return std::sqrt(sum / (static_cast<sample>(m_channel_count) * m_frame_count));
     }
 
     /// Copy an audio_bundle to another audio_bundle without resizing the destination
@@ -85,9 +489,7 @@ struct audio_bundle
         assert(m_frame_count == other.m_frame_count);
 
         for (auto channel = 0; channel < m_channel_count; ++channel) {
-            for (auto i = 0; i < m_frame_count; ++i) {
-                m_samples[channel][i] = other.m_samples[channel][i];
-            }
+            this->channel(channel).copy(other.channel(channel)); // skipped when processing in place
         }
         return *this;
     }
@@ -98,6 +500,18 @@ struct audio_bundle
     long m_frame_count{};
 };
 
+/// Inherit from inplace_processing in addition to your audio operator to allow Max to use the same memory for
+/// your object's inputs and outputs, saving a buffer for each output.
+/// Your object must then be written such that writing an output does not change inputs it has yet to read.
+///
+/// A sample_operator<> reads all of its inputs for a frame before writing the outputs for that frame,
+/// so it may always process in place.
+/// For a vector_operator<> or mc_operator<> see audio_bundle::shares_memory_with() and sample_span::overlaps().
+
+class inplace_processing
+{};
+
+
 // A specialization of "minwrap" (the container of the Max t_object together with the Min class)
 // for audio objects (both vector_operator and sample_operator)
 //
@@ -115,14 +529,18 @@ struct minwrap<min_class_type, type_enable_if_audio_class<min_class_type>>
 
         if (m_min_object.is_ui_class()) {
             max::t_pxjbox* x = m_max_header;
-            x->z_misc |= Z_NO_INPLACE;
+            if (!is_base_of<inplace_processing, min_class_type>::value) {
+                x->z_misc |= Z_NO_INPLACE;
+            }
             if (is_base_of<mc_operator_base, min_class_type>::value) {
                 x->z_misc |= Z_MC_INLETS;
             }
         }
         else {
             max::t_pxobject* x = m_max_header;
-            x->z_misc |= Z_NO_INPLACE;
+            if (!is_base_of<inplace_processing, min_class_type>::value) {
+                x->z_misc |= Z_NO_INPLACE;
+            }
             if (is_base_of<mc_operator_base, min_class_type>::value) {
                 x->z_misc |= Z_MC_INLETS;
             }
@@ -238,9 +656,42 @@ class performer
     // The traditional Max audio "perform" callback routine
     static void perform(minwrap<min_class_type>* self, max::t_object* dsp64, double** in_chans, const long numins, double** out_chans, const long numouts, const long sampleframes, const long, const void*)
     {
-        audio_bundle input{ in_chans, numins, sampleframes };
-        audio_bundle output{ out_chans, numouts, sampleframes };
-        self->m_min_object(input, output);
+        auto& op{ self->m_min_object };
+
+        if constexpr (is_base_of<mc_operator_base, min_class_type>::value) {
+            op.update_channels();
+        }
+
+        if (op.control_event_queues().empty()) {
+            audio_bundle input{ in_chans, numins, sampleframes };
+            audio_bundle output{ out_chans, numouts, sampleframes };
+            op(input, output);
+        }
+        else if (numins > k_max_segment_channels || numouts > k_max_segment_channels) {
+            apply_control_events(op, op.samplerate(), sampleframes);
+
+            audio_bundle input{ in_chans, numins, sampleframes };
+            audio_bundle output{ out_chans, numouts, sampleframes };
+            op(input, output);
+        }
+        else {
+            // each segment between control events is processed as a shorter vector
+            std::array<double*, k_max_segment_channels> segment_ins;
+            std::array<double*, k_max_segment_channels> segment_outs;
+
+            perform_with_control_events(op, op.samplerate(), sampleframes, [&](const long start, const long end) {
+                for (auto chan = 0; chan < numins; ++chan) {
+                    segment_ins[chan] = in_chans[chan] + start;
+                }
+                for (auto chan = 0; chan < numouts; ++chan) {
+                    segment_outs[chan] = out_chans[chan] + start;
+                }
+
+                audio_bundle input{ segment_ins.data(), numins, end - start };
+                audio_bundle output{ segment_outs.data(), numouts, end - start };
+                op(input, output);
+            });
+        }
     }
 };
 
@@ -283,6 +734,112 @@ struct has_m_dspsetup
     static const bool value = is_same<std::true_type, decltype(test<min_class_type>(nullptr))>::value;
 };
 
+/// The signal connections of an audio object's inlets and outlets, passed to a typed dspsetup() when the audio is compiled.
+/// Use it to allocate only what the connected inlets and outlets need.
+
+class signal_connections
+{
+  public:
+    signal_connections(const short* count, const size_t inlet_count, const size_t outlet_count)
+        : m_count{ count }
+        , m_inlet_count{ inlet_count }
+        , m_outlet_count{ outlet_count }
+    {
+    }
+
+    /// The number of inlets of the object.
+    /// @return	The number of inlets.
+    size_t inlet_count() const
+    {
+        return m_inlet_count;
+    }
+
+    /// The number of outlets of the object.
+    /// @return	The number of outlets.
+    size_t outlet_count() const
+    {
+        return m_outlet_count;
+    }
+
+    /// The number of signals connected to an inlet.
+    /// @param	index	The index of the inlet.
+    /// @return			The number of connected signals.
+    long inlet_connections(const size_t index) const
+    {
+        return m_count && index < m_inlet_count ? m_count[index] : 0;
+    }
+
+    /// The number of signals connected to an outlet.
+    /// @param	index	The index of the outlet.
+    /// @return			The number of connected signals.
+    long outlet_connections(const size_t index) const
+    {
+        return m_count && index < m_outlet_count ? m_count[m_inlet_count + index] : 0;
+    }
+
+    /// The number of inlets with a signal connected.
+    /// @return	The number of connected inlets.
+    size_t connected_inlet_count() const
+    {
+        size_t connected{ 0 };
+        for (size_t i = 0; i < m_inlet_count; ++i) {
+            connected += inlet_connections(i) != 0;
+        }
+        return connected;
+    }
+
+    /// The number of outlets with a signal connected.
+    /// @return	The number of connected outlets.
+    size_t connected_outlet_count() const
+    {
+        size_t connected{ 0 };
+        for (size_t i = 0; i < m_outlet_count; ++i) {
+            connected += outlet_connections(i) != 0;
+        }
+        return connected;
+    }
+
+  private:
+    const short* m_count;
+    size_t m_inlet_count;
+    size_t m_outlet_count;
+};
+
+// SFINAE implementation used internally to determine if the Min class has a typed dspsetup() member function,
+// taking the samplerate and the vector size and optionally the signal_connections, and returning void.
+// A dspsetup message returns atoms, so it is not mistaken for one.
+template <typename min_class_type, class = void>
+struct has_typed_dspsetup_with_connections : std::false_type
+{};
+
+template <typename min_class_type>
+struct has_typed_dspsetup_with_connections<min_class_type,
+    typename enable_if<std::is_void<decltype(std::declval<min_class_type&>().dspsetup(
+        std::declval<double>(), std::declval<long>(), std::declval<const signal_connections&>()))>::value>::type> : std::true_type
+{};
+
+template <typename min_class_type, class = void>
+struct has_typed_dspsetup : has_typed_dspsetup_with_connections<min_class_type>
+{};
+
+template <typename min_class_type>
+struct has_typed_dspsetup<min_class_type,
+    typename enable_if<std::is_void<decltype(std::declval<min_class_type&>().dspsetup(std::declval<double>(), std::declval<long>()))>::value>::type>
+    : std::true_type
+{};
+
+// Call the typed dspsetup() of an object, with or without the signal connections.
+template <class min_class_type>
+void call_typed_dspsetup(min_class_type& an_object, const double samplerate, const long vector_size, const signal_connections& connections)
+{
+    if constexpr (has_typed_dspsetup_with_connections<min_class_type>::value) {
+        an_object.dspsetup(samplerate, vector_size, connections);
+    }
+    else {
+        an_object.dspsetup(samplerate, vector_size);
+    }
+}
+
 // The "dsp64" method for Max audio objects is split up into several components here.
 // The main "dsp64" method is min_dsp64(), which needs to obey basic C rules because it is called by Max.
 // This in-turn then calls min_dsp64_sel() which is a templated C++ function that is specialized based on the properties of the Min
@@ -312,26 +869,141 @@ void min_dsp64_attrmap(minwrap<min_class_type>* self, const short* count)
 {
 }
 
+// Only mc_operator<> classes have channels to negotiate (see c74_min_operator_mc.h).
+template <class min_class_type, typename enable_if<!is_base_of<mc_operator_base, min_class_type>::value, int>::type = 0>
+void min_dsp64_channels(minwrap<min_class_type>* self, max::t_object* dsp64)
+{
+}
+
+/// Silence the output channels with NaN or infinite samples, counting the vector if there were any.
+/// This is done after each vector for objects inheriting from check_outputs.
+///
+/// @param	checker		The object whose outputs are checked.
+/// @param	output		The outgoing audio.
+/// @return				True if all samples were finite.
+inline bool perform_check_outputs(check_outputs& checker, const audio_bundle& output)
+{
+    auto finite{ true };
+
+    for (auto channel : output.channels()) {
+        if (!channel.finite()) {
+            channel.clear();
+            finite = false;
+        }
+    }
+    if (!finite) {
+        checker.count_nonfinite();
+    }
+    return finite;
+}
+
+// The perform routine for oversampled<> objects.
+// Implemented in c74_min_oversampled.h.
+class oversampling_base;
+
+template <class min_class_type>
+class oversampled_performer;
+
+// The perform routine for objects inheriting from flush_denormals or check_outputs,
+// guarding the perform routine of the performer class above.
+template <class min_class_type>
+class guarded_performer
+{
+  public:
+    static void perform(minwrap<min_class_type>* self, max::t_object* dsp64, double** in_chans, const long numins, double** out_chans, const long numouts, const long sampleframes, const long flags, void* userparam)
+    {
+        if constexpr (is_base_of<flush_denormals, min_class_type>::value) {
+            scoped_flush_denormals flush;
+            perform_unguarded(self, dsp64, in_chans, numins, out_chans, numouts, sampleframes, flags, userparam);
+        }
+        else {
+            perform_unguarded(self, dsp64, in_chans, numins, out_chans, numouts, sampleframes, flags, userparam);
+        }
+
+        if constexpr (is_base_of<check_outputs, min_class_type>::value) {
+            perform_check_outputs(self->m_min_object, audio_bundle{ out_chans, numouts, sampleframes });
+        }
+    }
+
+  private:
+    // The performers for sample_operator<> and mc_operator<> classes take their inputs as const.
+    static void perform_unguarded(minwrap<min_class_type>* self, max::t_object* dsp64, double** in_chans, const long numins, double** out_chans, const long numouts, const long sampleframes, const long flags, void* userparam)
+    {
+        if constexpr (is_base_of<oversampling_base, min_class_type>::value) {
+            oversampled_performer<min_class_type>::perform(self, dsp64, in_chans, numins, out_chans, numouts, sampleframes, flags, userparam);
+        }
+        else if constexpr (std::is_invocable<decltype(&performer<min_class_type>::perform), minwrap<min_class_type>*, max::t_object*, double**, long, double**, long, long, long, void*>::value) {
+            performer<min_class_type>::perform(self, dsp64, in_chans, numins, out_chans, numouts, sampleframes, flags, userparam);
+        }
+        else {
+            performer<min_class_type>::perform(self, dsp64, const_cast<const double**>(in_chans), numins, out_chans, numouts, sampleframes, flags, userparam);
+        }
+    }
+};
+
 // The min_dsp64_add_perform function handles adding the perform method to the signal chain (see performer class above)
 template <class min_class_type>
 void min_dsp64_add_perform(minwrap<min_class_type>* self, max::t_object* dsp64)
 {
+    min_dsp64_add_scratch_arenas(self, dsp64);
+
     // find the perform method and add it
     using namespace c74::max;
+    auto perform{ reinterpret_cast<max::t_perfroutine64>(performer<min_class_type>::perform) };
+    if constexpr (is_base_of<oversampling_base, min_class_type>::value) {
+        self->m_min_object.prepare_oversampling();
+        perform = reinterpret_cast<max::t_perfroutine64>(oversampled_performer<min_class_type>::perform);
+    }
+    if constexpr (is_base_of<flush_denormals, min_class_type>::value || is_base_of<check_outputs, min_class_type>::value) {
+        perform = reinterpret_cast<max::t_perfroutine64>(guarded_performer<min_class_type>::perform);
+    }
     object_method_direct(void, (void*, max::t_object*, const max::t_perfroutine64, const long, const void*), dsp64, symbol("dsp_add64"),
-                         self->maxobj(), reinterpret_cast<max::t_perfroutine64>(performer<min_class_type>::perform), 0, NULL);
+                         self->maxobj(), perform, 0, NULL);
+
+    min_dsp64_add_event_outlets(self, dsp64);
+}
+
+// Let the attributes of the object prepare for audio, e.g. a smoothed_attribute taking the samplerate.
+template <class min_class_type>
+void min_dsp64_prepare_attributes(minwrap<min_class_type>* self)
+{
+    for (auto& an_attribute : self->m_min_object.attributes()) {
+        an_attribute.second->prepare(self->m_min_object.samplerate());
+    }
+}
+
+// A specialization of min_dsp64_sel for classes that have a typed dspsetup() member function.
+// No atoms are built and no message is dispatched.
+template <class min_class_type>
+typename enable_if<has_typed_dspsetup<min_class_type>::value>::type
+min_dsp64_sel(minwrap<min_class_type>* self, max::t_object* dsp64, const short* count, const double samplerate, const long maxvectorsize, const long flags)
+{
+    self->m_min_object.samplerate(samplerate);
+    self->m_min_object.vector_size(maxvectorsize);
+    min_dsp64_io(self, count);
+    min_dsp64_channels(self, dsp64);
+    min_dsp64_attrmap(self, count);
+    min_dsp64_prepare_attributes(self);
+
+    const signal_connections connections{ count, self->m_min_object.inlets().size(), self->m_min_object.outlets().size() };
+    call_typed_dspsetup(self->m_min_object, samplerate, maxvectorsize, connections);
+
+    min_dsp64_add_perform(self, dsp64);
 }
 
 // A specialization of min_dsp64_sel for classes that have a custom "dspsetup" message.
 template <class min_class_type>
-typename enable_if<has_dspsetup<min_class_type>::value
-                   || has_m_dspsetup<min_class_type>::value>::type
+typename enable_if<(has_dspsetup<min_class_type>::value
+                   || has_m_dspsetup<min_class_type>::value)
+                   && !has_typed_dspsetup<min_class_type>::value>::type
 min_dsp64_sel(minwrap<min_class_type>* self, max::t_object* dsp64, const short* count, const double samplerate, const long maxvectorsize, const long flags)
 {
     self->m_min_object.samplerate(samplerate);
     self->m_min_object.vector_size(maxvectorsize);
     min_dsp64_io(self, count);
+    min_dsp64_channels(self, dsp64);
     min_dsp64_attrmap(self, count);
+    min_dsp64_prepare_attributes(self);
 
     atoms args;
     args.push_back(atom(samplerate));
@@ -345,13 +1017,16 @@ min_dsp64_sel(minwrap<min_class_type>* self, max::t_object* dsp64, const short*
 // (which is most audio classes).
 template <class min_class_type>
 typename enable_if<!has_dspsetup<min_class_type>::value
-                   && !has_m_dspsetup<min_class_type>::value>::type
+                   && !has_m_dspsetup<min_class_type>::value
+                   && !has_typed_dspsetup<min_class_type>::value>::type
 min_dsp64_sel(minwrap<min_class_type>* self, max::t_object* dsp64, const short* count, const double samplerate, const long maxvectorsize, const long flags)
 {
     self->m_min_object.samplerate(samplerate);
     self->m_min_object.vector_size(maxvectorsize);
     min_dsp64_io(self, count);
+    min_dsp64_channels(self, dsp64);
     min_dsp64_attrmap(self, count);
+    min_dsp64_prepare_attributes(self);
     min_dsp64_add_perform(self, dsp64);
 }
 
@@ -363,6 +1038,14 @@ min_dsp64(minwrap<min_class_type>* self, max::t_object* dsp64, const short* coun
     min_dsp64_sel<min_class_type>(self, dsp64, count, samplerate, maxvectorsize, flags);
 }
 
+// Methods negotiating the number of channels with Max for mc_operator<> classes.
+// Implemented in c74_min_operator_mc.h.
+template <class min_class_type>
+long min_mc_multichanneloutputs(minwrap<min_class_type>* self, const long index);
+
+template <class min_class_type>
+long min_mc_inputchanged(minwrap<min_class_type>* self, const long index, const long count);
+
 // Add audio support to a Max external when the max::t_class is being setup.
 // A call to wrap_as_max_external_audio() will be called for all externals when wrapping the Min class.
 // Only in cases where the class is actually and audio class (inherits from vector_operator or sample_operator)
@@ -371,6 +1054,10 @@ template <class min_class_type, enable_if_audio_class<min_class_type> = 0>
 void wrap_as_max_external_audio(max::t_class* c)
 {
     max::class_addmethod(c, reinterpret_cast<max::method>(min_dsp64<min_class_type>), "dsp64", max::A_CANT, 0);
+    if constexpr (is_base_of<mc_operator_base, min_class_type>::value) {
+        max::class_addmethod(c, reinterpret_cast<max::method>(min_mc_multichanneloutputs<min_class_type>), "multichanneloutputs", max::A_CANT, 0);
+        max::class_addmethod(c, reinterpret_cast<max::method>(min_mc_inputchanged<min_class_type>), "inputchanged", max::A_CANT, 0);
+    }
     if (is_base_of<ui_operator_base, min_class_type>::value) {
         max::class_dspinitjbox(c);
     }
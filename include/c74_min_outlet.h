@@ -50,6 +50,15 @@ inline void outlet_do_send<double>(const t_max_outlet maxoutlet, const double& v
     max::outlet_float(maxoutlet, value);
 }
 
+// outlet_do_send_message() sends a message whose selector is known by the caller.
+// Unlike outlet_do_send() there is no inspection of the atoms to choose between a list and a message.
+// The first atom is the selector, followed by the arguments of the message.
+template <size_t count>
+inline void outlet_do_send_message(const t_max_outlet maxoutlet, const std::array<atom, count>& value)
+{
+    max::outlet_anything(maxoutlet, value[0], static_cast<short>(count - 1), count > 1 ? (max::t_atom*)&value[1] : nullptr);
+}
+
 #ifdef MAC_VERSION
 #pragma mark -
 #endif
@@ -68,17 +77,79 @@ inline void outlet_do_send<double>(const t_max_outlet maxoutlet, const double& v
 // * last:		Schedule or defer the call to the appropriate thread,
 //				if multiple sends are received before the call is serviced then only send the last one.
 // * fifo:		Schedule or defer the call to the appropriate thread,
-//				if multiple sends are received before the call is serviced they are put in a fifo and all are delivered.
+//				if multiple sends are received before the call is serviced they are put in a fifo and delivered in order.
+//				The fifo holds 256 values by default; further values are dropped until it is serviced (see configure_queue()).
 //
 // The outlet_queue inherits from thread_trigger.
 // The thread_trigger manages the internal t_qelem or t_clock used to trigger the callback.
 
+// A value held by an outlet_queue until it can be sent on the right thread.
+// Lists are copied into atoms which keep their capacity, so that holding a value does not allocate once it has been reserved.
+struct queued_outlet_value
+{
+    message_type type{ message_type::gimme };
+    max::t_atom_long int_value{};
+    double float_value{};
+    atoms list;
+
+    void set(const max::t_atom_long a_value)
+    {
+        type = message_type::int_argument;
+        int_value = a_value;
+    }
+
+    void set(const double a_value)
+    {
+        type = message_type::float_argument;
+        float_value = a_value;
+    }
+
+    void set(const atoms& as)
+    {
+        type = message_type::gimme;
+        list.assign(as.begin(), as.end());
+    }
+
+    template <size_t count>
+    void set(const std::array<atom, count>& as)
+    {
+        type = message_type::gimme;
+        list.assign(as.begin(), as.end());
+    }
+
+    void set(const message_type a_type, const atoms& as)
+    {
+        if (a_type == message_type::int_argument) {
+            set(static_cast<max::t_atom_long>(as[0]));
+        }
+        else if (a_type == message_type::float_argument) {
+            set(static_cast<double>(as[0]));
+        }
+        else {
+            set(as);
+        }
+    }
+
+    void send(const t_max_outlet maxoutlet) const
+    {
+        if (type == message_type::int_argument) {
+            outlet_do_send<max::t_atom_long>(maxoutlet, int_value);
+        }
+        else if (type == message_type::float_argument) {
+            outlet_do_send<double>(maxoutlet, float_value);
+        }
+        else {
+            outlet_do_send(maxoutlet, list);
+        }
+    }
+};
+
 // ASSERT: default thread_action is to assert, which means no queue at all...
 template <thread_check check, thread_action action>
 class outlet_queue : public thread_trigger<t_max_outlet, check>
 {
   public:
-    explicit outlet_queue(const t_max_outlet a_maxoutlet)
+    explicit outlet_queue(const t_max_outlet a_maxoutlet, const size_t an_atom_count = 1)
         : thread_trigger<t_max_outlet, check>(a_maxoutlet)
     {
     }
@@ -89,102 +160,222 @@ class outlet_queue : public thread_trigger<t_max_outlet, check>
 };
 
 // FIRST: store only the first value and discard additional values (opposite of usurp)
+// The value is held in a single preallocated slot.
+// The first producer to claim the empty slot writes into it, and the slot is released again once the value has been sent.
 template <thread_check check>
 class outlet_queue<check, thread_action::first> : public thread_trigger<t_max_outlet, check>
 {
+    enum slot_state { empty, writing, full };
+
   public:
-    explicit outlet_queue(const t_max_outlet a_maxoutlet)
+    explicit outlet_queue(const t_max_outlet a_maxoutlet, const size_t an_atom_count = 1)
         : thread_trigger<t_max_outlet, check>(a_maxoutlet)
     {
+        m_value.list.reserve(an_atom_count);
     }
 
     void callback()
     {
-        outlet_do_send(this->m_baton, m_value);
-        m_set = false;
+        take([this](const queued_outlet_value& value) { value.send(this->m_baton); });
+    }
+
+    // Hand the value waiting to be sent, if there is one, to a function. This is how callback() sends it.
+    template <class F>
+    void take(F&& a_function)
+    {
+        if (m_state.load(std::memory_order_acquire) == full) {
+            a_function(static_cast<const queued_outlet_value&>(m_value));
+            m_state.store(empty, std::memory_order_release);
+        }
+    }
+
+    template <typename outlet_type>
+    void push(const outlet_type& a_value)
+    {
+        auto expected{ empty };
+        if (!m_state.compare_exchange_strong(expected, writing, std::memory_order_acquire)) {
+            return; // a value is already waiting to be sent
+        }
+
+        m_value.set(a_value);
+        m_state.store(full, std::memory_order_release);
+        thread_trigger<t_max_outlet, check>::set();
     }
 
     void push(const message_type a_type, const atoms& as)
     {
-        if (!m_set) {
-            m_value = as;
-            m_set = true;
-            thread_trigger<t_max_outlet, check>::set();
+        auto expected{ empty };
+        if (!m_state.compare_exchange_strong(expected, writing, std::memory_order_acquire)) {
+            return;
         }
+
+        m_value.set(a_type, as);
+        m_state.store(full, std::memory_order_release);
+        thread_trigger<t_max_outlet, check>::set();
     }
 
   private:
-    atoms m_value;
-    bool m_set{ false };
+    queued_outlet_value m_value;
+    std::atomic<slot_state> m_state{ empty };
 };
 
 // LAST: store only the last value received (usurp)
+// The value is held in one of a few preallocated slots. A producer claims a free slot, writes its value into it
+// and then swaps it in as the latest value, freeing the value it replaces. The callback swaps the latest value out and sends it.
+// Neither side waits for the other and no memory is allocated once the slots have been reserved.
+// Values sent from several threads at once are written, and the one swapped in last is the one sent.
+// Only if every slot is in use, which takes at least two other threads writing at that moment, is a new value dropped:
+// it is treated as having been sent just before theirs.
 template <thread_check check>
 class outlet_queue<check, thread_action::last> : public thread_trigger<t_max_outlet, check>
 {
+    static constexpr int k_none{ -1 };
+
   public:
-    explicit outlet_queue(const t_max_outlet a_maxoutlet)
+    explicit outlet_queue(const t_max_outlet a_maxoutlet, const size_t an_atom_count = 1)
         : thread_trigger<t_max_outlet, check>(a_maxoutlet)
     {
+        for (auto& value : m_values) {
+            value.list.reserve(an_atom_count);
+        }
     }
 
     void callback()
     {
-        outlet_do_send(this->m_maxoutlet, m_value);
+        m_pending = false; // values pushed from here on need another callback
+
+        take([this](const queued_outlet_value& value) { value.send(this->m_baton); });
+    }
+
+    // Hand the latest value, if there is one not sent yet, to a function. This is how callback() sends it.
+    template <class F>
+    void take(F&& a_function)
+    {
+        const auto latest{ m_latest.exchange(k_none, std::memory_order_acq_rel) };
+        if (latest != k_none) {
+            a_function(static_cast<const queued_outlet_value&>(m_values[latest]));
+            m_busy[latest].store(false, std::memory_order_release);
+        }
+    }
+
+    template <typename outlet_type>
+    void push(const outlet_type& a_value)
+    {
+        const auto slot{ claim() };
+        if (slot == k_none) {
+            return;
+        }
+        m_values[slot].set(a_value);
+        publish(slot);
     }
 
     void push(const message_type a_type, const atoms& as)
     {
-        m_value = as;
-        thread_trigger<t_max_outlet, check>::set();
+        const auto slot{ claim() };
+        if (slot == k_none) {
+            return;
+        }
+        m_values[slot].set(a_type, as);
+        publish(slot);
     }
 
   private:
-    atoms m_value;
+    // enough for the latest value, the one being sent and two threads writing at once
+    std::array<queued_outlet_value, 4> m_values;
+    std::array<std::atomic<bool>, 4> m_busy{};
+    std::atomic<int> m_latest{ k_none };
+    std::atomic<bool> m_pending{ false };
+
+    // Find a free slot, or k_none if other threads are writing into all of those that are not latest or being sent.
+    int claim()
+    {
+        for (auto slot = 0; slot < static_cast<int>(m_busy.size()); ++slot) {
+            auto expected{ false };
+            if (m_busy[slot].compare_exchange_strong(expected, true, std::memory_order_acquire)) {
+                return slot;
+            }
+        }
+        return k_none;
+    }
+
+    void publish(const int slot)
+    {
+        const auto replaced{ m_latest.exchange(slot, std::memory_order_acq_rel) };
+        if (replaced != k_none) {
+            m_busy[replaced].store(false, std::memory_order_release); // never sent: a later value took its place
+        }
+
+        if (!m_pending.exchange(true)) {
+            thread_trigger<t_max_outlet, check>::set();
+        }
+    }
 };
 
 // FIFO: defer all values
+// Values are written into a preallocated ring, with their type chosen at compile time by the overload of push().
+// However many values are queued, they are all sent by a single callback.
 template <thread_check check>
 class outlet_queue<check, thread_action::fifo> : public thread_trigger<t_max_outlet, check>
 {
+  public:
+    static constexpr size_t k_default_capacity{ 256 };
 
-    struct tagged_atoms
+    explicit outlet_queue(const t_max_outlet a_maxoutlet, const size_t an_atom_count = 1)
+        : thread_trigger<t_max_outlet, check>(a_maxoutlet)
+        , m_atom_count{ an_atom_count }
     {
-        message_type m_type;
-        atoms m_as;
-    };
+        configure(k_default_capacity, overflow_policy::drop_newest);
+    }
 
-  public:
-    explicit outlet_queue(const t_max_outlet a_maxoutlet)
-        : thread_trigger<t_max_outlet, check>(a_maxoutlet)
+    void configure(const size_t capacity, const overflow_policy policy)
     {
+        const auto atom_count = m_atom_count;
+        m_values.configure(capacity, policy, [atom_count](queued_outlet_value& value) { value.list.reserve(atom_count); });
+    }
+
+    size_t dropped() const
+    {
+        return m_values.dropped();
     }
 
     void callback()
     {
-        tagged_atoms tas;
-        while (m_values.try_dequeue(tas)) {
-            if (tas.m_type == message_type::int_argument) {
-                outlet_do_send<max::t_atom_long>(this->m_baton, tas.m_as[0]);
-            }
-            else if (tas.m_type == message_type::float_argument) {
-                outlet_do_send<double>(this->m_baton, tas.m_as[0]);
-            }
-            else {
-                outlet_do_send(this->m_baton, tas.m_as);
-            }
-        }
+        m_pending = false; // values pushed from here on need another callback
+
+        take([this](const queued_outlet_value& value) { value.send(this->m_baton); });
+    }
+
+    // Hand all the values waiting to be sent to a function, in order. This is how callback() sends them.
+    template <class F>
+    void take(F&& a_function)
+    {
+        m_values.pop_all([&a_function](queued_outlet_value& value) { a_function(static_cast<const queued_outlet_value&>(value)); });
+    }
+
+    template <typename outlet_type>
+    void push(const outlet_type& a_value)
+    {
+        m_values.push([&a_value](queued_outlet_value& value) { value.set(a_value); });
+        trigger();
     }
 
     void push(const message_type a_type, const atoms& as)
     {
-        tagged_atoms tas{ a_type, as };
-        m_values.enqueue(tas);
-        thread_trigger<t_max_outlet, check>::set();
+        m_values.push([a_type, &as](queued_outlet_value& value) { value.set(a_type, as); });
+        trigger();
     }
 
   private:
-    fifo<tagged_atoms> m_values;
+    lockfree_queue<queued_outlet_value> m_values;
+    size_t m_atom_count;
+    std::atomic<bool> m_pending{ false };
+
+    void trigger()
+    {
+        if (!m_pending.exchange(true)) {
+            thread_trigger<t_max_outlet, check>::set();
+        }
+    }
 };
 
 #ifdef MAC_VERSION
@@ -214,18 +405,9 @@ template <thread_check check_type, thread_action action_type, typename outlet_ty
 class handle_unsafe_outlet_send
 {
   public:
-    handle_unsafe_outlet_send(outlet<check_type, thread_action::fifo>* an_outlet, const outlet_type& a_value)
+    handle_unsafe_outlet_send(outlet<check_type, action_type>* an_outlet, const outlet_type& a_value)
     {
-        if (typeid(outlet_type) == typeid(max::t_atom_long)) {
-            an_outlet->queue_storage().push(message_type::int_argument, a_value);
-        }
-        else if (typeid(outlet_type) == typeid(double)) {
-            an_outlet->queue_storage().push(message_type::float_argument, a_value);
-        }
-        else // atoms
-        {
-            an_outlet->queue_storage().push(message_type::gimme, a_value);
-        }
+        an_outlet->queue_storage().push(a_value); // the overload for outlet_type is chosen at compile time
     }
 };
 
@@ -274,31 +456,6 @@ class outlet_base : public port
 template <thread_check check, thread_action action>
 class outlet : public outlet_base
 {
-
-    // utility: queue an argument of any type for output
-    template <typename argument_type>
-    void queue_argument(const argument_type& arg) noexcept
-    {
-        m_accumulated_output.push_back(arg);
-    }
-
-    // utility: empty argument handling (required for all recursive variadic templates)
-    void handle_arguments() noexcept
-    {
-        ;
-    }
-
-    // utility: handle N arguments of any type by recursively working through them
-    //	and matching them to the type-matched routine above.
-    template <typename FIRST_ARG, typename... REMAINING_ARGS>
-    void handle_arguments(FIRST_ARG const& first, REMAINING_ARGS const&... args) noexcept
-    {
-        queue_argument(first);
-        if (sizeof...(args)) {
-            handle_arguments(args...); // recurse
-        }
-    }
-
   public:
     /// Create an outlet
     /// @param an_owner			The Min object instance that owns this outlet. Typically you should pass 'this'.
@@ -308,9 +465,9 @@ class outlet : public outlet_base
     ///							When greater than 1, defining this allows memory to be pre-allocated to improve performance.
     outlet(object_base* an_owner, const string& a_description, const string& a_type = "", const size_t an_atom_count = 1)
         : outlet_base(an_owner, a_description, a_type)
+        , m_queue_storage{ this->m_instance, an_atom_count }
     {
         m_owner->outlets().push_back(this);
-        m_accumulated_output.reserve(an_atom_count);
     }
 
     /// Create an outlet
@@ -413,13 +570,42 @@ class outlet : public outlet_base
     }
 
     /// Send values out an outlet
+    /// The values are gathered on the stack rather than in storage shared by all calls,
+    /// so a send may safely trigger another send from the same outlet (e.g. through a feedback loop downstream).
     /// @param args The values to send.
     template <typename... ARGS>
     void send(ARGS... args)
     {
-        handle_arguments(args...);
-        send(m_accumulated_output);
-        m_accumulated_output.clear();
+        if constexpr (sizeof...(ARGS) > 0) {
+            using list_type = std::array<atom, sizeof...(ARGS)>;
+            const list_type as{ atom(args)... };
+
+            if (outlet_call_is_safe<check>()) {
+                outlet_do_send(m_instance, as);
+            }
+            else {
+                handle_unsafe_outlet_send<check, action, list_type>(this, as);
+            }
+        }
+    }
+
+    /// Send a message with a known selector out an outlet, e.g. `note 60 100`.
+    /// Define the selector once, e.g. as a static const symbol, so that it is not looked up for every send.
+    /// The message is sent without inspecting the values to determine whether they form a list or a message.
+    /// @param selector	The name of the message.
+    /// @param args		The arguments of the message.
+    template <typename... ARGS>
+    void send_message(const symbol& selector, ARGS... args)
+    {
+        using list_type = std::array<atom, sizeof...(ARGS) + 1>;
+        const list_type as{ atom(selector), atom(args)... };
+
+        if (outlet_call_is_safe<check>()) {
+            outlet_do_send_message(m_instance, as);
+        }
+        else {
+            handle_unsafe_outlet_send<check, action, list_type>(this, as);
+        }
     }
 
     /// Send values out an outlet
@@ -430,9 +616,42 @@ class outlet : public outlet_base
         send(args...);
     }
 
+    /// Set the size of the queue holding values sent from other threads, and how it behaves when it is full.
+    /// Only outlets using thread_action::fifo have a queue.
+    /// By default 256 values are queued, and new values are dropped while the queue is full and counted by dropped().
+    /// Call this in your object's constructor.
+    ///
+    /// With overflow_policy::grow no values are dropped, but sending a value while the queue is full locks a mutex
+    /// and allocates memory, so it must not be used for outlets sent to from the audio thread.
+    ///
+    /// @param capacity	The number of values that can be queued. Rounded up to a power of two.
+    /// @param policy	What to do with a new value when the queue is full.
+    void configure_queue(const size_t capacity, const overflow_policy policy = overflow_policy::drop_newest)
+    {
+        static_assert(action == thread_action::fifo, "only outlets using thread_action::fifo have a queue");
+        m_queue_storage.configure(capacity, policy);
+    }
+
+    /// The number of values dropped because the queue was full.
+    /// Only outlets using thread_action::fifo with a policy other than overflow_policy::grow drop values.
+    /// @return	The number of dropped values.
+    size_t dropped() const
+    {
+        static_assert(action == thread_action::fifo, "only outlets using thread_action::fifo have a queue");
+        return m_queue_storage.dropped();
+    }
+
+    // DO NOT USE
+    // The queue holding values sent from other threads until they are sent on the right thread.
+    // Values are pushed by handle_unsafe_outlet_send(), and tests may take them without sending them.
+
+    outlet_queue<check, action>& queue_storage()
+    {
+        return m_queue_storage;
+    }
+
   private:
-    atoms m_accumulated_output;
-    outlet_queue<check, action> m_queue_storage{ this->m_instance };
+    outlet_queue<check, action> m_queue_storage;
 
     // called by object_base::create_outlets() when the owning object is constructed
     void create() override
@@ -445,15 +664,6 @@ class outlet : public outlet_base
         }
         m_queue_storage.update_baton(m_instance);
     }
-
-    // outlet_queue is drained by handle_unsafe_outlet_send()
-    template <thread_check check_type, thread_action action_type, typename outlet_type>
-    friend class handle_unsafe_outlet_send;
-
-    outlet_queue<check, action>& queue_storage()
-    {
-        return m_queue_storage;
-    }
 };
 
 } // namespace c74::min
@@ -0,0 +1,427 @@
+/// @file
+///	@ingroup 	minapi
+///	@copyright	Copyright 2018 The Min-API Authors. All rights reserved.
+///	@license	Use of this source code is governed by the MIT License found in the License.md file.
+
+#pragma once
+
+namespace c74::min {
+
+namespace detail {
+    constexpr double k_pi{ 3.14159265358979323846 };
+
+    constexpr double constexpr_sqrt(const double x)
+    {
+        if (x <= 0.0) {
+            return 0.0;
+        }
+        auto root{ x > 1.0 ? x : 1.0 };
+        for (auto i = 0; i < 64; ++i) {
+            root = 0.5 * (root + x / root);
+        }
+        return root;
+    }
+
+    // The modified Bessel function of the first kind of order zero, for the Kaiser window.
+    constexpr double bessel_i0(const double x)
+    {
+        auto sum{ 1.0 };
+        auto term{ 1.0 };
+        for (auto k = 1; k < 50; ++k) {
+            term *= x / (2.0 * k);
+            sum += term * term;
+        }
+        return sum;
+    }
+} // namespace detail
+
+
+/// The coefficients of a half-band lowpass filter, designed with a Kaiser window.
+/// Every other coefficient of a half-band filter is zero and the center one is 0.5,
+/// so only those at the odd distances 1, 3, 5... from the center are stored, one side of the symmetrical filter.
+/// The coefficients are scaled for a gain of exactly one at DC.
+///
+/// @tparam	half_length		The number of coefficients stored. The filter is 4 * half_length - 1 samples long.
+/// @param	beta			The shape of the Kaiser window, trading the width of the transition band for stopband attenuation.
+/// @return					The coefficients.
+
+template <size_t half_length>
+constexpr std::array<sample, half_length> halfband_coefficients(const double beta)
+{
+    std::array<sample, half_length> coefficients{};
+    auto                            sum{ 0.0 };
+
+    for (size_t j = 0; j < half_length; ++j) {
+        const auto distance{ 2.0 * j + 1.0 };
+        const auto position{ distance / (2.0 * half_length) };
+        const auto window{ detail::bessel_i0(beta * detail::constexpr_sqrt(1.0 - position * position)) / detail::bessel_i0(beta) };
+
+        coefficients[j] = (j % 2 == 0 ? 1.0 : -1.0) / (detail::k_pi * distance) * window;
+        sum += coefficients[j];
+    }
+
+    // the center coefficient is 0.5, and the others add up to 0.5 on both sides together
+    for (auto& coefficient : coefficients) {
+        coefficient *= 0.25 / sum;
+    }
+    return coefficients;
+}
+
+
+/// The first stage of oversampling, next to the object's samplerate, which must reject images and aliases close to its Nyquist frequency.
+static constexpr auto k_halfband_steep{ halfband_coefficients<16>(8.0) };
+
+/// The further stages of oversampling, which only need to reject what lies above the passband of the first stage.
+static constexpr auto k_halfband_short{ halfband_coefficients<8>(8.0) };
+
+
+/// Calculate the symmetrical part of a half-band filter for a number of frames,
+/// `sum(g[j] * (x[i - M - j] + x[i - M + 1 + j]))` for coefficients g, half length M, and each frame i.
+/// The sums are calculated k_sample_lanes frames at a time, followed by the remaining frames one at a time.
+///
+/// @param	coefficients	The coefficients of the filter.
+/// @param	half_length		The number of coefficients.
+/// @param	x				The first frame, preceded by 2 * half_length frames of history.
+/// @param	frame_count		The number of frames.
+/// @param	store			A function called with the index of the frame and its sum,
+///							either a sample or a sample_lanes<> for the frames starting at the index.
+
+template <class F>
+void halfband_sums(const sample* coefficients, const long half_length, const sample* x, const long frame_count, F&& store)
+{
+    using pack = sample_lanes<k_sample_lanes>;
+    constexpr auto lane_count{ static_cast<long>(k_sample_lanes) };
+    long i{ 0 };
+
+    for (; i + lane_count <= frame_count; i += lane_count) {
+        pack sums{ 0.0 };
+        for (long j = 0; j < half_length; ++j) {
+            sums += (pack::load(x + i - half_length - j) + pack::load(x + i - half_length + 1 + j)) * coefficients[j];
+        }
+        store(i, sums);
+    }
+    for (; i < frame_count; ++i) {
+        sample sum{ 0.0 };
+        for (long j = 0; j < half_length; ++j) {
+            sum += (x[i - half_length - j] + x[i - half_length + 1 + j]) * coefficients[j];
+        }
+        store(i, sum);
+    }
+}
+
+
+/// The base class of oversampled<>, used to find oversampled objects.
+/// You will not typically use this class directly.
+
+class oversampling_base
+{};
+
+
+/// Process a sample_operator<> at a multiple of the samplerate, reducing the aliasing of nonlinear processes
+/// such as waveshapers and saturators.
+///
+/// Inherit from oversampled<> in place of the sample_operator<> it wraps. Your call operator stays the same,
+/// and is called for each frame at the higher samplerate.
+/// The inputs are upsampled and the outputs downsampled with polyphase half-band filters, a stage for each factor of two,
+/// whose coefficients are calculated at compile time.
+/// The memory for the filters is allocated when the audio is compiled, and the audio thread switches to it
+/// at the start of its next vector, carrying over the history of the filters.
+///
+/// While your object is oversampled, samplerate() and vector_size() are those at which your call operator is called,
+/// and frame() is the index of the frame in the oversampled vector.
+/// The filters delay the audio by latency() samples (at the object's samplerate).
+///
+/// @tparam	factor			The oversampling factor: 2, 4 or 8.
+/// @tparam	operator_type	The sample_operator<> to oversample.
+///
+/// @code
+/// class saturator : public object<saturator>, public oversampled<4, sample_operator<1, 1>> {
+///     // ...
+///     sample operator()(sample x) {
+///         return std::tanh(x * m_drive);
+///     }
+/// };
+/// @endcode
+
+template <size_t factor, class operator_type>
+class oversampled : public operator_type, public oversampling_base
+{
+    static_assert(factor == 2 || factor == 4 || factor == 8, "the oversampling factor must be 2, 4 or 8");
+    static_assert(is_base_of<sample_operator_base, operator_type>::value, "only a sample_operator<> can be oversampled");
+
+    static constexpr size_t k_stage_count{ factor == 2 ? 1 : factor == 4 ? 2 : 3 };
+    static constexpr size_t k_input_count{ operator_type::input_count() };
+    static constexpr size_t k_output_count{ operator_type::output_count() };
+
+  public:
+    using operator_type::samplerate;
+    using operator_type::vector_size;
+
+    /// The oversampling factor.
+    /// @return	The number of frames processed for each frame of audio.
+    static constexpr size_t oversampling_factor()
+    {
+        return factor;
+    }
+
+    /// The delay of the audio caused by the filters.
+    /// @return	The latency in samples at the object's samplerate, which may be fractional.
+    static constexpr double latency()
+    {
+        auto samples{ 0.0 };
+        for (size_t stage = 0; stage < k_stage_count; ++stage) {
+            samples += (2.0 * stage_half_length(stage) - 1.0) / (1 << stage);
+        }
+        return samples;
+    }
+
+    ///	Set a new samplerate.
+    /// You will not typically have any need to call this.
+    /// It is called internally any time the dsp chain containing your object is compiled.
+    /// @param	a_samplerate	The samplerate of the object, which is multiplied by the oversampling factor.
+    void samplerate(const double a_samplerate)
+    {
+        operator_type::samplerate(a_samplerate * factor);
+    }
+
+    ///	Set a new vector size.
+    /// You will not typically have any need to call this.
+    /// It is called internally any time the dsp chain containing your object is compiled.
+    /// @param	a_vector_size	The vector size of the object, which is multiplied by the oversampling factor.
+    void vector_size(const int a_vector_size)
+    {
+        operator_type::vector_size(a_vector_size * static_cast<int>(factor));
+    }
+
+    // Allocate the memory for the filters and the oversampled audio, on the main thread when the audio is compiled.
+    // The audio thread switches to it at the start of its next vector, carrying over the history of the filters.
+    void prepare_oversampling()
+    {
+        m_filters.publish(std::make_unique<filters>(this->vector_size() / static_cast<long>(factor)));
+    }
+
+    /// Process a vector of audio at the higher samplerate.
+    /// This is called by the performer of the object. It is primarily useful for unit testing.
+    ///
+    /// @param	in_chans			The input samples, one pointer for each of the operator's inputs.
+    /// @param	numins				The number of inputs.
+    /// @param	out_chans			The output samples, one pointer for each of the operator's outputs.
+    /// @param	numouts				The number of outputs.
+    /// @param	sampleframes		The number of frames, at the object's samplerate.
+    /// @param	perform_frames		A function processing the oversampled audio, called with the inputs, the outputs and the number of frames.
+
+    template <class F>
+    void perform_oversampled(const double** in_chans, const long numins, double** out_chans, const long numouts, const long sampleframes,
+                             F&& perform_frames)
+    {
+        m_filters.update([](const filters* previous, filters& next) {
+            if (previous) {
+                next.continue_from(*previous);
+            }
+        });
+
+        const auto f{ m_filters.current() };
+
+        if (!f || sampleframes > f->frame_count) {
+            for (auto channel = 0; channel < numouts; ++channel) {
+                std::fill(out_chans[channel], out_chans[channel] + sampleframes, 0.0);
+            }
+            return;
+        }
+
+        for (size_t channel = 0; channel < k_input_count; ++channel) {
+            if (channel < static_cast<size_t>(numins)) {
+                upsample(*f, channel, in_chans[channel], sampleframes);
+            }
+            else {
+                std::fill(f->oversampled_inputs[channel], f->oversampled_inputs[channel] + sampleframes * factor, 0.0);
+            }
+        }
+
+        perform_frames(const_cast<const double**>(f->oversampled_inputs.data()), f->oversampled_outputs.data(), static_cast<long>(sampleframes * factor));
+
+        for (size_t channel = 0; channel < k_output_count && channel < static_cast<size_t>(numouts); ++channel) {
+            downsample(*f, channel, out_chans[channel], sampleframes);
+        }
+    }
+
+  private:
+    // The memory for the filters and the oversampled audio for one vector size, handed to the audio thread as a whole.
+    struct filters
+    {
+        explicit filters(const long a_frame_count)
+            : frame_count{ a_frame_count }
+        {
+            size_t size{ 0 };
+            for (size_t stage = 0; stage < k_stage_count; ++stage) {
+                const auto stage_frames{ static_cast<size_t>(frame_count) << stage };
+                const auto history{ static_cast<size_t>(2 * stage_half_length(stage)) };
+
+                size += k_input_count * ((stage_frames * 2) + (history + stage_frames));
+                size += k_output_count * ((stage_frames * 2) + 2 * (history + stage_frames));
+            }
+            storage.reset(size ? new sample[size]() : nullptr);
+
+            auto memory{ storage.get() };
+            auto take = [&memory](const size_t count) {
+                const auto taken{ memory };
+                memory += count;
+                return taken;
+            };
+
+            for (size_t stage = 0; stage < k_stage_count; ++stage) {
+                const auto stage_frames{ static_cast<size_t>(frame_count) << stage };
+                const auto history{ static_cast<size_t>(2 * stage_half_length(stage)) };
+
+                for (size_t channel = 0; channel < k_input_count; ++channel) {
+                    input_levels[channel][stage] = take(stage_frames * 2);
+                    interpolation[channel][stage] = take(history + stage_frames);
+                }
+                for (size_t channel = 0; channel < k_output_count; ++channel) {
+                    output_levels[channel][stage] = take(stage_frames * 2);
+                    decimation_even[channel][stage] = take(history + stage_frames);
+                    decimation_odd[channel][stage] = take(history + stage_frames);
+                }
+            }
+
+            for (size_t channel = 0; channel < k_input_count; ++channel) {
+                oversampled_inputs[channel] = input_levels[channel][k_stage_count - 1];
+            }
+            for (size_t channel = 0; channel < k_output_count; ++channel) {
+                oversampled_outputs[channel] = output_levels[channel][k_stage_count - 1];
+            }
+        }
+
+        // Carry over the history of the filters, on the audio thread, so that the audio continues without a click.
+        void continue_from(const filters& previous)
+        {
+            if (!previous.storage || !storage) {
+                return;
+            }
+
+            for (size_t stage = 0; stage < k_stage_count; ++stage) {
+                const auto history{ 2 * stage_half_length(stage) };
+
+                for (size_t channel = 0; channel < k_input_count; ++channel) {
+                    std::copy(previous.interpolation[channel][stage], previous.interpolation[channel][stage] + history, interpolation[channel][stage]);
+                }
+                for (size_t channel = 0; channel < k_output_count; ++channel) {
+                    std::copy(previous.decimation_even[channel][stage], previous.decimation_even[channel][stage] + history, decimation_even[channel][stage]);
+                    std::copy(previous.decimation_odd[channel][stage], previous.decimation_odd[channel][stage] + history, decimation_odd[channel][stage]);
+                }
+            }
+        }
+
+        std::unique_ptr<sample[]> storage;
+        long frame_count;
+
+        // for each channel and stage: the output of the stage, and the working memory of its filter starting with its history
+        std::array<std::array<sample*, k_stage_count>, k_input_count> input_levels{};
+        std::array<std::array<sample*, k_stage_count>, k_input_count> interpolation{};
+        std::array<std::array<sample*, k_stage_count>, k_output_count> output_levels{};
+        std::array<std::array<sample*, k_stage_count>, k_output_count> decimation_even{};
+        std::array<std::array<sample*, k_stage_count>, k_output_count> decimation_odd{};
+        std::array<sample*, k_input_count> oversampled_inputs{};
+        std::array<sample*, k_output_count> oversampled_outputs{};
+    };
+
+    handoff<filters> m_filters;
+
+    static constexpr long stage_half_length(const size_t stage)
+    {
+        return static_cast<long>(stage == 0 ? k_halfband_steep.size() : k_halfband_short.size());
+    }
+
+    static constexpr const sample* stage_coefficients(const size_t stage)
+    {
+        return stage == 0 ? k_halfband_steep.data() : k_halfband_short.data();
+    }
+
+    // Double the samplerate of an input through each stage.
+    static void upsample(filters& f, const size_t channel, const sample* input, const long sampleframes)
+    {
+        auto source{ input };
+        auto frame_count{ sampleframes };
+
+        for (size_t stage = 0; stage < k_stage_count; ++stage) {
+            const auto half_length{ stage_half_length(stage) };
+            const auto history{ 2 * half_length };
+            const auto work{ f.interpolation[channel][stage] };
+            const auto x{ work + history };
+            const auto output{ f.input_levels[channel][stage] };
+
+            std::copy(source, source + frame_count, x);
+
+            // the even frames are interpolated, and the odd frames are the input (delayed)
+            halfband_sums(stage_coefficients(stage), half_length, x, frame_count, [&](const long i, const auto& sums) {
+                if constexpr (is_same<std::decay_t<decltype(sums)>, sample>::value) {
+                    output[2 * i] = 2.0 * sums;
+                    output[2 * i + 1] = x[i - half_length + 1];
+                }
+                else {
+                    for (size_t lane = 0; lane < k_sample_lanes; ++lane) {
+                        output[2 * (i + lane)] = 2.0 * sums[lane];
+                        output[2 * (i + lane) + 1] = x[i + lane - half_length + 1];
+                    }
+                }
+            });
+
+            std::copy(work + frame_count, work + frame_count + history, work);
+
+            source = output;
+            frame_count *= 2;
+        }
+    }
+
+    // Halve the samplerate of an output through each stage, in reverse order.
+    static void downsample(filters& f, const size_t channel, sample* output, const long sampleframes)
+    {
+        for (auto stage = static_cast<long>(k_stage_count) - 1; stage >= 0; --stage) {
+            const auto half_length{ stage_half_length(stage) };
+            const auto history{ 2 * half_length };
+            const auto frame_count{ sampleframes << stage };
+            const auto source{ f.output_levels[channel][stage] };
+            const auto destination{ stage == 0 ? output : f.output_levels[channel][stage - 1] };
+            const auto even{ f.decimation_even[channel][stage] + history };
+            const auto odd{ f.decimation_odd[channel][stage] + history };
+
+            for (long i = 0; i < frame_count; ++i) {
+                even[i] = source[2 * i];
+                odd[i] = source[2 * i + 1];
+            }
+
+            // the even frames are filtered, and the odd frames meet the center coefficient
+            halfband_sums(stage_coefficients(stage), half_length, even, frame_count, [&](const long i, const auto& sums) {
+                using pack = std::decay_t<decltype(sums)>;
+
+                if constexpr (is_same<pack, sample>::value) {
+                    destination[i] = sums + 0.5 * odd[i - half_length];
+                }
+                else {
+                    (sums + pack::load(odd + i - half_length) * 0.5).store(destination + i);
+                }
+            });
+
+            std::copy(even - history + frame_count, even + frame_count, even - history);
+            std::copy(odd - history + frame_count, odd + frame_count, odd - history);
+        }
+    }
+};
+
+
+// The perform routine for oversampled<> objects, wrapping the perform routine of the performer class for their sample_operator<>.
+template <class min_class_type>
+class oversampled_performer
+{
+  public:
+    static void perform(minwrap<min_class_type>* self, max::t_object* dsp64, double** in_chans, const long numins, double** out_chans, const long numouts, const long sampleframes, const long flags, void* userparam)
+    {
+        self->m_min_object.perform_oversampled(const_cast<const double**>(in_chans), numins, out_chans, numouts, sampleframes,
+            [&](const double** oversampled_ins, double** oversampled_outs, const long oversampled_frames) {
+                performer<min_class_type>::perform(self, dsp64, oversampled_ins, min_class_type::input_count(), oversampled_outs,
+                                                   numouts > 0 ? min_class_type::output_count() : 0, oversampled_frames, flags, userparam);
+            });
+    }
+};
+
+} // namespace c74::min
@@ -0,0 +1,249 @@
+/// @file
+///	@ingroup 	minapi
+///	@copyright	Copyright 2018 The Min-API Authors. All rights reserved.
+///	@license	Use of this source code is governed by the MIT License found in the License.md file.
+
+#pragma once
+
+namespace c74::min {
+
+/// The number of frames processed together by sample operators using lane_processing.
+/// It is the same whatever instructions the code is compiled for, as the layout of sample_lanes<k_sample_lanes> is shared
+/// between translation units (e.g. in the storage of channel_state). Four doubles fill an AVX register,
+/// or two SSE2 or NEON registers, which the compiler processes one after the other.
+static constexpr size_t k_sample_lanes{ 4 };
+
+
+/// A pack of samples from consecutive frames, processed together.
+/// The arithmetic operators work on all lanes at once and are written such that the compiler turns them into SIMD instructions.
+/// A single sample is converted to a pack with the same value in every lane, so that expressions like `x * 0.5` work as they do for a sample.
+///
+/// @tparam	count	The number of lanes.
+
+template <size_t count>
+struct alignas(count * sizeof(sample)) sample_lanes
+{
+    sample lane[count]{};
+
+    sample_lanes() = default;
+
+    sample_lanes(const sample value)
+    {
+        for (size_t i = 0; i < count; ++i) {
+            lane[i] = value;
+        }
+    }
+
+    /// Read a pack from consecutive samples.
+    /// @param	source	The address of the first sample.
+    /// @return			The pack of samples.
+    static sample_lanes load(const sample* source)
+    {
+        sample_lanes result;
+        for (size_t i = 0; i < count; ++i) {
+            result.lane[i] = source[i];
+        }
+        return result;
+    }
+
+    /// Write the pack to consecutive samples.
+    /// @param	destination		The address of the first sample.
+    void store(sample* destination) const
+    {
+        for (size_t i = 0; i < count; ++i) {
+            destination[i] = lane[i];
+        }
+    }
+
+    /// The number of lanes.
+    static constexpr size_t size()
+    {
+        return count;
+    }
+
+    sample& operator[](const size_t index)
+    {
+        return lane[index];
+    }
+
+    const sample& operator[](const size_t index) const
+    {
+        return lane[index];
+    }
+
+    sample_lanes& operator+=(const sample_lanes& other)
+    {
+        for (size_t i = 0; i < count; ++i) {
+            lane[i] += other.lane[i];
+        }
+        return *this;
+    }
+
+    sample_lanes& operator-=(const sample_lanes& other)
+    {
+        for (size_t i = 0; i < count; ++i) {
+            lane[i] -= other.lane[i];
+        }
+        return *this;
+    }
+
+    sample_lanes& operator*=(const sample_lanes& other)
+    {
+        for (size_t i = 0; i < count; ++i) {
+            lane[i] *= other.lane[i];
+        }
+        return *this;
+    }
+
+    sample_lanes& operator/=(const sample_lanes& other)
+    {
+        for (size_t i = 0; i < count; ++i) {
+            lane[i] /= other.lane[i];
+        }
+        return *this;
+    }
+
+    friend sample_lanes operator+(const sample_lanes& a, const sample_lanes& b)
+    {
+        sample_lanes result{ a };
+        return result += b;
+    }
+
+    friend sample_lanes operator-(const sample_lanes& a, const sample_lanes& b)
+    {
+        sample_lanes result{ a };
+        return result -= b;
+    }
+
+    friend sample_lanes operator*(const sample_lanes& a, const sample_lanes& b)
+    {
+        sample_lanes result{ a };
+        return result *= b;
+    }
+
+    friend sample_lanes operator/(const sample_lanes& a, const sample_lanes& b)
+    {
+        sample_lanes result{ a };
+        return result /= b;
+    }
+
+    // Mixed with a single sample, so that anything convertible to a sample (e.g. an attribute<number>) works too.
+
+    friend sample_lanes operator+(const sample_lanes& a, const sample b)
+    {
+        return a + sample_lanes(b);
+    }
+
+    friend sample_lanes operator+(const sample a, const sample_lanes& b)
+    {
+        return sample_lanes(a) + b;
+    }
+
+    friend sample_lanes operator-(const sample_lanes& a, const sample b)
+    {
+        return a - sample_lanes(b);
+    }
+
+    friend sample_lanes operator-(const sample a, const sample_lanes& b)
+    {
+        return sample_lanes(a) - b;
+    }
+
+    friend sample_lanes operator*(const sample_lanes& a, const sample b)
+    {
+        return a * sample_lanes(b);
+    }
+
+    friend sample_lanes operator*(const sample a, const sample_lanes& b)
+    {
+        return sample_lanes(a) * b;
+    }
+
+    friend sample_lanes operator/(const sample_lanes& a, const sample b)
+    {
+        return a / sample_lanes(b);
+    }
+
+    friend sample_lanes operator/(const sample a, const sample_lanes& b)
+    {
+        return sample_lanes(a) / b;
+    }
+
+    friend sample_lanes operator-(const sample_lanes& a)
+    {
+        sample_lanes result;
+        for (size_t i = 0; i < count; ++i) {
+            result.lane[i] = -a.lane[i];
+        }
+        return result;
+    }
+
+    // Apply a function of one sample to each lane.
+    template <class F>
+    friend sample_lanes transform(const sample_lanes& a, F&& fn)
+    {
+        sample_lanes result;
+        for (size_t i = 0; i < count; ++i) {
+            result.lane[i] = fn(a.lane[i]);
+        }
+        return result;
+    }
+
+    // Apply a function of two samples to each pair of lanes.
+    template <class F>
+    friend sample_lanes transform(const sample_lanes& a, const sample_lanes& b, F&& fn)
+    {
+        sample_lanes result;
+        for (size_t i = 0; i < count; ++i) {
+            result.lane[i] = fn(a.lane[i], b.lane[i]);
+        }
+        return result;
+    }
+
+    // The following are found by argument-dependent lookup, so that an operator written as
+    // `using std::abs; return abs(x);` works for both samples and sample_lanes.
+
+    friend sample_lanes abs(const sample_lanes& a)
+    {
+        return transform(a, [](const sample x) { return std::abs(x); });
+    }
+
+    friend sample_lanes sqrt(const sample_lanes& a)
+    {
+        return transform(a, [](const sample x) { return std::sqrt(x); });
+    }
+
+    friend sample_lanes min(const sample_lanes& a, const sample_lanes& b)
+    {
+        return transform(a, b, [](const sample x, const sample y) { return y < x ? y : x; });
+    }
+
+    friend sample_lanes max(const sample_lanes& a, const sample_lanes& b)
+    {
+        return transform(a, b, [](const sample x, const sample y) { return x < y ? y : x; });
+    }
+};
+
+
+/// Inherit from lane_processing in addition to sample_operator<> to have your call operator process k_sample_lanes frames at a time.
+/// Your call operator must then be a template that works for both a sample and a sample_lanes<k_sample_lanes>,
+/// returning the same type (or a std::array of it for several outputs).
+/// The frames left over at the end of a vector are processed one at a time.
+///
+/// Frames are processed together, so this is only suitable for operators with no state carried from one sample to the next
+/// (e.g. gain, mixing, waveshaping -- but not filters).
+///
+/// @code
+/// class gain : public object<gain>, public sample_operator<1, 1>, public lane_processing {
+///     // ...
+///     template <class T>
+///     T operator()(T x) {
+///         return x * m_gain;
+///     }
+/// };
+/// @endcode
+
+class lane_processing
+{};
+
+} // namespace c74::min
@@ -0,0 +1,258 @@
+/// @file
+///	@ingroup 	minapi
+///	@copyright	Copyright 2018 The Min-API Authors. All rights reserved.
+///	@license	Use of this source code is governed by the MIT License found in the License.md file.
+
+#pragma once
+
+// Checks for writes past the end of scratch arena allocations are made in debug builds,
+// or when C74_MIN_SCRATCH_ARENA_CHECKS is defined as 1.
+#ifndef C74_MIN_SCRATCH_ARENA_CHECKS
+#ifdef NDEBUG
+#define C74_MIN_SCRATCH_ARENA_CHECKS 0
+#else
+#define C74_MIN_SCRATCH_ARENA_CHECKS 1
+#endif
+#endif
+
+namespace c74::min {
+
+/// Temporary memory for the audio routine of an object, allocated when the audio is compiled.
+///
+/// Declare how much memory your audio routine needs, in vectors of samples (of the object's vector size) and in bytes.
+/// The memory is allocated when the audio is compiled, after dspsetup, and the audio routine switches to it at the start of its next call.
+/// During each call of your audio routine take pieces of it with allocate() or vector(),
+/// which only move a position forward. Everything is given back before the next call.
+///
+/// Each allocation is aligned to 64 bytes, and takes its size rounded up to 64 bytes.
+/// If the arena is used up, allocate() returns nullptr and counts the failure in exhausted().
+/// When checks are enabled (in debug builds) allocations are followed by a guard, up to one per reserved vector
+/// and k_checked_allocations more, and writes past the end of an allocation are counted in overruns() at the start of the next call.
+/// The guards have room of their own, so checks do not change which allocations succeed.
+///
+/// @code
+/// scratch_arena scratch { this, 2 };
+///
+/// void operator()(audio_bundle input, audio_bundle output) {
+///     auto wet = scratch.vector(input.frame_count());
+///     auto dry = scratch.vector(input.frame_count());
+///     // ...
+/// }
+/// @endcode
+
+class scratch_arena
+{
+    struct alignas(64) block
+    {
+        unsigned char bytes[64];
+    };
+
+    // The memory for one vector size, prepared on the main thread and handed to the audio thread as a whole.
+    struct storage
+    {
+        std::unique_ptr<block[]> blocks;
+        size_t capacity{ 0 }; // the bytes available for allocations
+        size_t size{ 0 }; // the bytes of storage, with room for guards when checks are enabled
+        std::vector<size_t> guards; // positions of the guards of this call's allocations, when checks are enabled
+        size_t guard_count{ 0 }; // the number of guards there is room for
+
+        unsigned char* data()
+        {
+            return blocks ? blocks[0].bytes : nullptr;
+        }
+    };
+
+  public:
+    /// The alignment of allocations in bytes.
+    static constexpr size_t k_alignment{ sizeof(block) };
+
+    /// The number of allocations, beyond one per reserved vector, that have room for a guard when checks are enabled.
+    static constexpr size_t k_checked_allocations{ 16 };
+
+    /// Create a scratch arena.
+    /// @param	an_owner		The Min object instance that owns this arena. Typically you should pass 'this'.
+    /// @param	a_vector_count	The number of vectors of samples needed in each call of the audio routine.
+    /// @param	a_byte_count	Additional bytes needed in each call of the audio routine.
+    explicit scratch_arena(object_base* an_owner, const size_t a_vector_count = 0, const size_t a_byte_count = 0)
+        : m_vector_count{ a_vector_count }
+        , m_byte_count{ a_byte_count }
+    {
+        an_owner->scratch_arenas().push_back(this);
+    }
+
+    // Arenas cannot be copied: the owner holds on to them.
+    scratch_arena(const scratch_arena&) = delete;
+    scratch_arena& operator=(const scratch_arena& value) = delete;
+
+    /// Change how much memory is needed, e.g. from dspsetup.
+    /// The memory is allocated when the audio is next compiled.
+    /// @param	a_vector_count	The number of vectors of samples needed in each call of the audio routine.
+    /// @param	a_byte_count	Additional bytes needed in each call of the audio routine.
+    void reserve(const size_t a_vector_count, const size_t a_byte_count = 0)
+    {
+        m_vector_count = a_vector_count;
+        m_byte_count = a_byte_count;
+    }
+
+    /// Take memory for a number of values from the arena.
+    /// Call this from the audio routine.
+    /// @tparam	T		The type of the values, which must not need destroying.
+    /// @param	count	The number of values.
+    /// @return			The memory for the values (uninitialized), or nullptr if the arena is used up.
+    template <class T = sample>
+    T* allocate(const size_t count)
+    {
+        static_assert(std::is_trivially_destructible<T>::value, "scratch arena memory is given back without destroying its contents");
+        static_assert(alignof(T) <= k_alignment, "scratch arena allocations are aligned to 64 bytes");
+
+        const auto bytes{ round_up(count * sizeof(T)) };
+        const auto s{ m_storage.current() };
+
+        if (!s || m_allocated + bytes > s->capacity) {
+            m_exhausted.fetch_add(1, std::memory_order_relaxed);
+            return nullptr;
+        }
+
+        const auto memory{ s->data() + m_used };
+        m_allocated += bytes;
+        m_used += bytes;
+
+        // Guards only take the room set aside for them, so the same allocations succeed with and without checks.
+        // Once it is used up further allocations go unchecked.
+        if constexpr (C74_MIN_SCRATCH_ARENA_CHECKS) {
+            if (s->guards.size() < s->guard_count) {
+                std::fill(s->data() + m_used, s->data() + m_used + k_alignment, k_guard_byte);
+                s->guards.push_back(m_used);
+                m_used += k_alignment;
+            }
+        }
+        return reinterpret_cast<T*>(memory);
+    }
+
+    /// Take a vector of samples from the arena.
+    /// Call this from the audio routine.
+    /// @param	frame_count		The number of samples.
+    /// @return					A view of the samples (uninitialized), which is empty if the arena is used up.
+    sample_span vector(const long frame_count)
+    {
+        const auto samples{ allocate<sample>(static_cast<size_t>(frame_count)) };
+        return { samples, samples ? frame_count : 0 };
+    }
+
+    /// Give back everything allocated, and switch to the memory prepared last if it has changed.
+    /// This happens automatically before each call of the audio routine.
+    void reset()
+    {
+        if constexpr (C74_MIN_SCRATCH_ARENA_CHECKS) {
+            if (const auto s{ m_storage.current() }) {
+                for (auto position : s->guards) {
+                    const auto guard{ s->data() + position };
+                    if (std::any_of(guard, guard + k_alignment, [](const unsigned char x) { return x != k_guard_byte; })) {
+                        m_overruns.fetch_add(1, std::memory_order_relaxed);
+                    }
+                }
+                s->guards.clear();
+            }
+        }
+        m_storage.update();
+        m_allocated = 0;
+        m_used = 0;
+    }
+
+    /// The size of the arena.
+    /// Call this from the audio routine.
+    /// @return	The number of bytes available in each call of the audio routine.
+    size_t capacity() const
+    {
+        const auto s{ m_storage.current() };
+        return s ? s->capacity : 0;
+    }
+
+    /// The memory taken so far.
+    /// @return	The number of bytes allocated since the last reset, including rounding.
+    size_t used() const
+    {
+        return m_allocated;
+    }
+
+    /// The number of allocations that failed because the arena was used up.
+    /// @return	The number of failed allocations.
+    size_t exhausted() const
+    {
+        return m_exhausted.load(std::memory_order_relaxed);
+    }
+
+    /// The number of allocations found to have been written past their end.
+    /// Always zero unless checks are enabled.
+    /// @return	The number of overruns.
+    size_t overruns() const
+    {
+        return m_overruns.load(std::memory_order_relaxed);
+    }
+
+    // Allocate the memory for the vector size, on the main thread when the audio is compiled.
+    // The audio thread switches to it at its next reset().
+    void prepare(const long a_vector_size)
+    {
+        auto s{ std::make_unique<storage>() };
+
+        s->capacity = m_vector_count * round_up(a_vector_size * sizeof(sample)) + round_up(m_byte_count);
+        if (C74_MIN_SCRATCH_ARENA_CHECKS && s->capacity) {
+            s->guard_count = m_vector_count + k_checked_allocations;
+            s->guards.reserve(s->guard_count);
+        }
+        s->size = s->capacity + s->guard_count * k_alignment;
+        if (s->size) {
+            s->blocks.reset(new block[s->size / k_alignment]);
+        }
+
+        m_storage.publish(std::move(s));
+    }
+
+    // Perform routine added to the signal chain before the object's own to reset all of its arenas.
+    static void perform_reset(max::t_object*, max::t_object*, double**, long, double**, long, long, long, void* an_owner)
+    {
+        for (auto an_arena : static_cast<object_base*>(an_owner)->scratch_arenas()) {
+            an_arena->reset();
+        }
+    }
+
+  private:
+    static constexpr unsigned char k_guard_byte{ 0xFD };
+
+    size_t m_vector_count;
+    size_t m_byte_count;
+    handoff<storage> m_storage;
+    size_t m_allocated{ 0 }; // owned by the audio thread
+    size_t m_used{ 0 }; // owned by the audio thread, the position of the next allocation
+    std::atomic<size_t> m_exhausted{ 0 };
+    std::atomic<size_t> m_overruns{ 0 };
+
+    static size_t round_up(const size_t bytes)
+    {
+        return (bytes + k_alignment - 1) / k_alignment * k_alignment;
+    }
+};
+
+
+// Allocate the scratch arenas of an object and add the perform routine resetting them to the signal chain.
+// Called for audio objects when the signal chain is compiled, before adding their own perform routine.
+template <class min_class_type>
+void min_dsp64_add_scratch_arenas(minwrap<min_class_type>* self, max::t_object* dsp64)
+{
+    auto& scratch_arenas{ self->m_min_object.scratch_arenas() };
+
+    if (scratch_arenas.empty()) {
+        return;
+    }
+
+    for (auto an_arena : scratch_arenas) {
+        an_arena->prepare(self->m_min_object.vector_size());
+    }
+
+    using namespace c74::max;
+    object_method_direct(void, (void*, max::t_object*, const max::t_perfroutine64, const long, const void*), dsp64, symbol("dsp_add64"),
+                         self->maxobj(), scratch_arena::perform_reset, 0, static_cast<object_base*>(&self->m_min_object));
+}
+
+} // namespace c74::min
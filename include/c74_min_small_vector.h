@@ -0,0 +1,543 @@
+/// @file
+///	@ingroup 	minapi
+///	@copyright	Copyright 2018 The Min-API Authors. All rights reserved.
+///	@license	Use of this source code is governed by the MIT License found in the License.md file.
+
+#pragma once
+
+namespace c74::min {
+
+/// A contiguous container with the interface of std::vector that stores up to N items inline.
+/// Only when the container grows beyond N items is memory allocated from the heap.
+/// This is used as the storage for the atoms container when C74_MIN_SMALL_ATOMS is defined,
+/// so that short lists (the vast majority of messages) can be passed around without allocation.
+///
+/// @tparam	T	The type of the items in the container.
+/// @tparam	N	The number of items that can be stored without allocating.
+
+template <class T, std::size_t N>
+class small_vector
+{
+    static_assert(N > 0, "small_vector requires an inline capacity of at least one item");
+
+  public:
+    using value_type = T;
+    using size_type = std::size_t;
+    using difference_type = std::ptrdiff_t;
+    using reference = T&;
+    using const_reference = const T&;
+    using pointer = T*;
+    using const_pointer = const T*;
+    using iterator = T*;
+    using const_iterator = const T*;
+    using reverse_iterator = std::reverse_iterator<iterator>;
+    using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+
+    /// The number of items that can be stored without allocating.
+    static constexpr size_type inline_capacity = N;
+
+    small_vector() noexcept
+        : m_data{ inline_data() }
+    {
+    }
+
+    explicit small_vector(const size_type count)
+        : small_vector()
+    {
+        resize(count);
+    }
+
+    small_vector(const size_type count, const T& value)
+        : small_vector()
+    {
+        assign(count, value);
+    }
+
+    template <class InputIt, typename enable_if<!std::is_integral<InputIt>::value, int>::type = 0>
+    small_vector(InputIt first, InputIt last)
+        : small_vector()
+    {
+        assign(first, last);
+    }
+
+    small_vector(std::initializer_list<T> init)
+        : small_vector()
+    {
+        assign(init.begin(), init.end());
+    }
+
+    small_vector(const small_vector& other)
+        : small_vector()
+    {
+        assign(other.begin(), other.end());
+    }
+
+    small_vector(small_vector&& other) noexcept(std::is_nothrow_move_constructible<T>::value)
+        : small_vector()
+    {
+        take(std::move(other));
+    }
+
+    ~small_vector()
+    {
+        clear();
+        release();
+    }
+
+    small_vector& operator=(const small_vector& other)
+    {
+        if (this != &other) {
+            assign(other.begin(), other.end());
+        }
+        return *this;
+    }
+
+    small_vector& operator=(small_vector&& other) noexcept(std::is_nothrow_move_constructible<T>::value)
+    {
+        if (this != &other) {
+            clear();
+            release();
+            take(std::move(other));
+        }
+        return *this;
+    }
+
+    small_vector& operator=(std::initializer_list<T> init)
+    {
+        assign(init.begin(), init.end());
+        return *this;
+    }
+
+    void assign(const size_type count, const T& value)
+    {
+        const T copy{ value }; // value may refer to one of our own items
+        clear();
+        reserve(count);
+        std::uninitialized_fill_n(m_data, count, copy);
+        m_size = count;
+    }
+
+    template <class InputIt, typename enable_if<!std::is_integral<InputIt>::value, int>::type = 0>
+    void assign(InputIt first, InputIt last)
+    {
+        clear();
+        if constexpr (std::is_base_of<std::forward_iterator_tag, typename std::iterator_traits<InputIt>::iterator_category>::value) {
+            reserve(static_cast<size_type>(std::distance(first, last)));
+        }
+        for (; first != last; ++first) {
+            emplace_back(*first);
+        }
+    }
+
+    void assign(std::initializer_list<T> init)
+    {
+        assign(init.begin(), init.end());
+    }
+
+    // element access
+
+    reference at(const size_type pos)
+    {
+        if (pos >= m_size) {
+            throw std::out_of_range("small_vector index out of range");
+        }
+        return m_data[pos];
+    }
+
+    const_reference at(const size_type pos) const
+    {
+        if (pos >= m_size) {
+            throw std::out_of_range("small_vector index out of range");
+        }
+        return m_data[pos];
+    }
+
+    reference operator[](const size_type pos)
+    {
+        return m_data[pos];
+    }
+
+    const_reference operator[](const size_type pos) const
+    {
+        return m_data[pos];
+    }
+
+    reference front()
+    {
+        return m_data[0];
+    }
+
+    const_reference front() const
+    {
+        return m_data[0];
+    }
+
+    reference back()
+    {
+        return m_data[m_size - 1];
+    }
+
+    const_reference back() const
+    {
+        return m_data[m_size - 1];
+    }
+
+    T* data() noexcept
+    {
+        return m_data;
+    }
+
+    const T* data() const noexcept
+    {
+        return m_data;
+    }
+
+    // iterators
+
+    iterator begin() noexcept
+    {
+        return m_data;
+    }
+
+    const_iterator begin() const noexcept
+    {
+        return m_data;
+    }
+
+    const_iterator cbegin() const noexcept
+    {
+        return m_data;
+    }
+
+    iterator end() noexcept
+    {
+        return m_data + m_size;
+    }
+
+    const_iterator end() const noexcept
+    {
+        return m_data + m_size;
+    }
+
+    const_iterator cend() const noexcept
+    {
+        return m_data + m_size;
+    }
+
+    reverse_iterator rbegin() noexcept
+    {
+        return reverse_iterator(end());
+    }
+
+    const_reverse_iterator rbegin() const noexcept
+    {
+        return const_reverse_iterator(end());
+    }
+
+    reverse_iterator rend() noexcept
+    {
+        return reverse_iterator(begin());
+    }
+
+    const_reverse_iterator rend() const noexcept
+    {
+        return const_reverse_iterator(begin());
+    }
+
+    // capacity
+
+    bool empty() const noexcept
+    {
+        return m_size == 0;
+    }
+
+    size_type size() const noexcept
+    {
+        return m_size;
+    }
+
+    size_type max_size() const noexcept
+    {
+        return std::numeric_limits<difference_type>::max() / sizeof(T);
+    }
+
+    size_type capacity() const noexcept
+    {
+        return m_capacity;
+    }
+
+    void reserve(const size_type new_capacity)
+    {
+        if (new_capacity > m_capacity) {
+            auto new_data = allocate(new_capacity);
+            relocate_to(new_data);
+            m_capacity = new_capacity;
+        }
+    }
+
+    /// Return heap storage if the items fit inline again.
+    void shrink_to_fit()
+    {
+        if (!is_inline() && m_size <= N) {
+            auto old_data = m_data;
+            std::uninitialized_move(old_data, old_data + m_size, inline_data());
+            std::destroy(old_data, old_data + m_size);
+            ::operator delete(old_data);
+            m_data = inline_data();
+            m_capacity = N;
+        }
+    }
+
+    /// Determine if the items are currently stored inline (i.e. no heap memory is in use).
+    /// @return	True if no memory has been allocated.
+    bool is_inline() const noexcept
+    {
+        return m_data == inline_data();
+    }
+
+    // modifiers
+
+    void clear() noexcept
+    {
+        std::destroy(m_data, m_data + m_size);
+        m_size = 0;
+    }
+
+    iterator insert(const_iterator pos, const T& value)
+    {
+        return emplace(pos, value);
+    }
+
+    iterator insert(const_iterator pos, T&& value)
+    {
+        return emplace(pos, std::move(value));
+    }
+
+    iterator insert(const_iterator pos, const size_type count, const T& value)
+    {
+        return insert_at(pos - begin(), small_vector(count, value));
+    }
+
+    template <class InputIt, typename enable_if<!std::is_integral<InputIt>::value, int>::type = 0>
+    iterator insert(const_iterator pos, InputIt first, InputIt last)
+    {
+        return insert_at(pos - begin(), small_vector(first, last));
+    }
+
+    iterator insert(const_iterator pos, std::initializer_list<T> init)
+    {
+        return insert_at(pos - begin(), small_vector(init));
+    }
+
+    template <class... ARGS>
+    iterator emplace(const_iterator pos, ARGS&&... args)
+    {
+        const auto index = pos - begin();
+
+        emplace_back(std::forward<ARGS>(args)...);
+        std::rotate(begin() + index, end() - 1, end());
+        return begin() + index;
+    }
+
+    iterator erase(const_iterator pos)
+    {
+        return erase(pos, pos + 1);
+    }
+
+    iterator erase(const_iterator first, const_iterator last)
+    {
+        const auto index = first - begin();
+        const auto count = static_cast<size_type>(last - first);
+
+        if (count) {
+            std::move(begin() + index + count, end(), begin() + index);
+            std::destroy(end() - count, end());
+            m_size -= count;
+        }
+        return begin() + index;
+    }
+
+    void push_back(const T& value)
+    {
+        emplace_back(value);
+    }
+
+    void push_back(T&& value)
+    {
+        emplace_back(std::move(value));
+    }
+
+    template <class... ARGS>
+    reference emplace_back(ARGS&&... args)
+    {
+        if (m_size == m_capacity) {
+            // construct the new item before moving the old ones: args may refer to one of our own items
+            const auto new_capacity = grown_capacity(m_size + 1);
+            auto new_data = allocate(new_capacity);
+
+            try {
+                ::new (static_cast<void*>(new_data + m_size)) T(std::forward<ARGS>(args)...);
+            }
+            catch (...) {
+                ::operator delete(new_data);
+                throw;
+            }
+            relocate_to(new_data);
+            m_capacity = new_capacity;
+        }
+        else {
+            ::new (static_cast<void*>(m_data + m_size)) T(std::forward<ARGS>(args)...);
+        }
+        return m_data[m_size++];
+    }
+
+    void pop_back()
+    {
+        --m_size;
+        std::destroy_at(m_data + m_size);
+    }
+
+    void resize(const size_type count)
+    {
+        if (count < m_size) {
+            erase(begin() + count, end());
+        }
+        else if (count > m_size) {
+            reserve(count);
+            std::uninitialized_value_construct(m_data + m_size, m_data + count);
+            m_size = count;
+        }
+    }
+
+    void resize(const size_type count, const T& value)
+    {
+        if (count < m_size) {
+            erase(begin() + count, end());
+        }
+        else if (count > m_size) {
+            const T copy{ value }; // value may refer to one of our own items
+            reserve(count);
+            std::uninitialized_fill(m_data + m_size, m_data + count, copy);
+            m_size = count;
+        }
+    }
+
+    void swap(small_vector& other)
+    {
+        small_vector temp{ std::move(other) };
+        other = std::move(*this);
+        *this = std::move(temp);
+    }
+
+  private:
+    alignas(T) unsigned char m_inline[N * sizeof(T)];
+    T* m_data;
+    size_type m_size{ 0 };
+    size_type m_capacity{ N };
+
+    T* inline_data() noexcept
+    {
+        return reinterpret_cast<T*>(m_inline);
+    }
+
+    const T* inline_data() const noexcept
+    {
+        return reinterpret_cast<const T*>(m_inline);
+    }
+
+    static T* allocate(const size_type capacity)
+    {
+        return static_cast<T*>(::operator new(capacity * sizeof(T)));
+    }
+
+    size_type grown_capacity(const size_type minimum) const
+    {
+        return std::max(minimum, m_capacity * 2);
+    }
+
+    // move the items to new storage, freeing the old storage if it was allocated
+    void relocate_to(T* new_data)
+    {
+        std::uninitialized_move(m_data, m_data + m_size, new_data);
+        std::destroy(m_data, m_data + m_size);
+        release();
+        m_data = new_data;
+    }
+
+    void release() noexcept
+    {
+        if (!is_inline()) {
+            ::operator delete(m_data);
+            m_data = inline_data();
+            m_capacity = N;
+        }
+    }
+
+    // assumes we are empty and inline
+    void take(small_vector&& other)
+    {
+        if (other.is_inline()) {
+            std::uninitialized_move(other.begin(), other.end(), inline_data());
+            m_size = other.m_size;
+            other.clear();
+        }
+        else {
+            m_data = other.m_data;
+            m_size = other.m_size;
+            m_capacity = other.m_capacity;
+            other.m_data = other.inline_data();
+            other.m_size = 0;
+            other.m_capacity = N;
+        }
+    }
+
+    iterator insert_at(const difference_type index, small_vector&& values)
+    {
+        const auto count = values.size();
+
+        if (m_size + count > m_capacity) {
+            reserve(grown_capacity(m_size + count));
+        }
+        std::uninitialized_move(values.begin(), values.end(), end());
+        m_size += count;
+        std::rotate(begin() + index, end() - count, end());
+        return begin() + index;
+    }
+};
+
+
+/// Type trait to determine if a type is a small_vector.
+template <class T>
+struct is_small_vector : std::false_type
+{};
+
+template <class T, std::size_t N>
+struct is_small_vector<small_vector<T, N>> : std::true_type
+{};
+
+
+template <class T, std::size_t N>
+bool operator==(const small_vector<T, N>& a, const small_vector<T, N>& b)
+{
+    return a.size() == b.size() && std::equal(a.begin(), a.end(), b.begin());
+}
+
+template <class T, std::size_t N>
+bool operator!=(const small_vector<T, N>& a, const small_vector<T, N>& b)
+{
+    return !(a == b);
+}
+
+template <class T, std::size_t N>
+bool operator<(const small_vector<T, N>& a, const small_vector<T, N>& b)
+{
+    return std::lexicographical_compare(a.begin(), a.end(), b.begin(), b.end());
+}
+
+template <class T, std::size_t N>
+void swap(small_vector<T, N>& a, small_vector<T, N>& b)
+{
+    a.swap(b);
+}
+
+} // namespace c74::min
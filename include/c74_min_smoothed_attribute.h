@@ -0,0 +1,305 @@
+/// @file
+///	@ingroup 	minapi
+///	@copyright	Copyright 2018 The Min-API Authors. All rights reserved.
+///	@license	Use of this source code is governed by the MIT License found in the License.md file.
+
+#pragma once
+
+namespace c74::min {
+
+/// How a smoothed_attribute moves from its current value to a new one.
+/// @ingroup attributes
+
+enum class smoothing
+{
+    linear, ///< Move in a straight line, arriving at the new value after the ramp time.
+    exponential, ///< Move as a one-pole lowpass filter, arriving within -60 dB of the new value after the ramp time.
+    block ///< Jump to the new value the next time the audio thread reads it, e.g. at the start of a vector.
+};
+
+
+/// A number attribute whose changes are smoothed for use in audio, avoiding zipper noise.
+///
+/// The attribute is set like any other attribute.
+/// The audio thread reads the smoothed value with next() for each sample, fill() for a vector of samples,
+/// or advance() for a value per vector.
+/// New values are handed to the audio thread through an atomic, without locking or allocating.
+/// Only the audio thread may read the smoothed value: reading advances the ramp.
+///
+/// @ingroup	attributes
+/// @tparam		mode			How changes are smoothed.
+/// @tparam		threadsafety	As for attribute<>.
+/// @tparam		limit_type		As for attribute<>.
+///
+/// @code
+/// smoothed_attribute<> gain { this, "gain", 1.0, 20.0, range {0.0, 2.0} };
+///
+/// sample operator()(sample x) {
+///     return x * gain.next();
+/// }
+/// @endcode
+
+template <smoothing mode = smoothing::linear, threadsafe threadsafety = threadsafe::undefined, template <typename> class limit_type = limit::none>
+class smoothed_attribute : public attribute<number, threadsafety, limit_type>
+{
+    using base = attribute<number, threadsafety, limit_type>;
+    using pack = sample_lanes<k_sample_lanes>;
+
+  public:
+    /// Create a smoothed attribute.
+    /// @param an_owner			The instance pointer for the owning C++ class, typically you will pass 'this'
+    /// @param a_name			A string specifying the name of the attribute when dynamically addressed or inspected.
+    /// @param a_default_value	The default value of the attribute, which is where the smoothed value starts.
+    /// @param a_ramp_time		The time in milliseconds taken to move to a new value.
+    /// @param args				N arguments specifying optional properties of an attribute such as setter, label, style, etc.
+
+    template <typename... ARGS>
+    smoothed_attribute(object_base* an_owner, const std::string a_name, const number a_default_value, const number a_ramp_time, ARGS... args)
+        : base{ an_owner, a_name, a_default_value, args... }
+        , m_target{ a_default_value }
+        , m_ramp_time{ a_ramp_time }
+        , m_current{ a_default_value }
+        , m_ramp_target{ a_default_value }
+    {
+        // Publish each value as it is assigned, on whichever thread that happens.
+        const setter user_setter{ this->m_setter };
+
+        this->m_setter = [this, user_setter](const atoms& args, const int inlet) -> atoms {
+            const auto value{ user_setter ? user_setter(args, inlet) : args };
+            if (!value.empty()) {
+                m_target.store(value[0], std::memory_order_relaxed);
+            }
+            return value;
+        };
+    }
+
+    using base::operator=;
+
+    /// Set the time taken to move to a new value.
+    /// @param	a_ramp_time		The ramp time in milliseconds.
+
+    void ramp_time(const number a_ramp_time)
+    {
+        m_ramp_time.store(a_ramp_time, std::memory_order_relaxed);
+    }
+
+    /// Get the time taken to move to a new value.
+    /// @return	The ramp time in milliseconds.
+
+    number ramp_time() const
+    {
+        return m_ramp_time.load(std::memory_order_relaxed);
+    }
+
+    /// Get the smoothed value for the next sample.
+    /// Call this once for each sample, from the audio thread.
+    /// @return	The smoothed value.
+
+    sample next()
+    {
+        update();
+
+        if (m_remaining > 0) {
+            --m_remaining;
+            if (m_remaining == 0) {
+                m_current = m_ramp_target;
+            }
+            else if constexpr (mode == smoothing::exponential) {
+                m_current = m_ramp_target + (m_current - m_ramp_target) * m_coefficient;
+            }
+            else {
+                m_current += m_step;
+            }
+        }
+        return m_current;
+    }
+
+    /// Write the smoothed values for a number of samples, as next() would for each of them.
+    /// Call this from the audio thread.
+    /// @param	output		The samples to write.
+    /// @param	frame_count	The number of samples.
+
+    void fill(sample* output, const long frame_count)
+    {
+        update();
+
+        long i{ 0 };
+
+        if (m_remaining > 0) {
+            const auto ramp_end{ std::min<long>(frame_count, m_remaining) };
+            const auto pack_end{ ramp_end - ramp_end % static_cast<long>(k_sample_lanes) };
+
+            if constexpr (mode == smoothing::exponential) {
+                // y[n] = target + (y[0] - target) * c^n, with the powers of c for a pack of frames at a time
+                pack powers;
+                auto power{ 1.0 };
+                for (size_t lane = 0; lane < k_sample_lanes; ++lane) {
+                    power *= m_coefficient;
+                    powers[lane] = power;
+                }
+
+                auto distance{ m_current - m_ramp_target };
+                for (; i < pack_end; i += k_sample_lanes) {
+                    (m_ramp_target + powers * distance).store(output + i);
+                    distance *= power;
+                }
+                for (; i < ramp_end; ++i) {
+                    distance *= m_coefficient;
+                    output[i] = m_ramp_target + distance;
+                }
+                m_current = m_ramp_target + distance;
+            }
+            else {
+                pack steps;
+                for (size_t lane = 0; lane < k_sample_lanes; ++lane) {
+                    steps[lane] = m_step * (lane + 1);
+                }
+
+                for (; i < pack_end; i += k_sample_lanes) {
+                    (steps + (m_current + m_step * i)).store(output + i);
+                }
+                for (; i < ramp_end; ++i) {
+                    output[i] = m_current + m_step * (i + 1);
+                }
+                m_current += m_step * ramp_end;
+            }
+
+            m_remaining -= ramp_end;
+            if (m_remaining == 0) {
+                m_current = m_ramp_target;
+                output[ramp_end - 1] = m_current;
+            }
+        }
+
+        std::fill(output + i, output + frame_count, m_current);
+    }
+
+    /// Write the smoothed values for the samples of a view, as next() would for each of them.
+    /// @param	output	The samples to write.
+
+    void fill(const sample_span& output)
+    {
+        fill(output.data(), output.size());
+    }
+
+    /// Get the smoothed value for a vector and move on to the next vector.
+    /// Use this when the value is only needed once per vector, e.g. to calculate filter coefficients.
+    /// Call this from the audio thread.
+    /// @param	frame_count		The number of samples in the vector.
+    /// @return					The smoothed value at the start of the vector.
+
+    sample advance(const long frame_count)
+    {
+        update();
+
+        const auto value{ m_current };
+
+        if (m_remaining > 0) {
+            const auto frames{ std::min<long>(frame_count, m_remaining) };
+
+            m_remaining -= frames;
+            if (m_remaining == 0) {
+                m_current = m_ramp_target;
+            }
+            else if constexpr (mode == smoothing::exponential) {
+                m_current = m_ramp_target + (m_current - m_ramp_target) * std::pow(m_coefficient, frames);
+            }
+            else {
+                m_current += m_step * frames;
+            }
+        }
+        return value;
+    }
+
+    /// Is the value moving?
+    /// Call this from the audio thread, e.g. to use the unsmoothed value while it is not.
+    /// @return	True if the value is still moving towards the last value set.
+
+    bool ramping() const
+    {
+        return m_remaining > 0 || m_target.load(std::memory_order_relaxed) != m_ramp_target;
+    }
+
+    // Called when the audio is compiled, on the main thread.
+    // The smoothed value starts from the current value rather than ramping from the value of the previous run.
+
+    void prepare(const double a_samplerate) override
+    {
+        m_samplerate.store(a_samplerate, std::memory_order_relaxed);
+        m_reset.store(true, std::memory_order_release);
+    }
+
+    // Signals mapped to the attribute are limited as for other numeric attributes,
+    // publishing each sample to the audio thread as the new target.
+    // Only the atomic target is written: the value itself belongs to the main thread.
+
+    attribute_base::sample_setter resolve_sample_setter() override
+    {
+        if (!this->writable() || (!is_same<limit_type<number>, limit::none<number>>::value && this->range_ref().size() < 2)) {
+            return nullptr;
+        }
+        return [](attribute_base* an_attribute, const double value) {
+            auto& self{ *static_cast<smoothed_attribute*>(an_attribute) };
+
+            if constexpr (is_same<limit_type<number>, limit::none<number>>::value) {
+                self.m_target.store(value, std::memory_order_relaxed);
+            }
+            else {
+                self.m_target.store(limit_type<number>::apply(value, self.range_ref()[0], self.range_ref()[1]), std::memory_order_relaxed);
+            }
+        };
+    }
+
+  private:
+    // shared with the threads setting the attribute
+    std::atomic<number> m_target;
+    std::atomic<number> m_ramp_time;
+    std::atomic<double> m_samplerate{ c74::max::sys_getsr() };
+    std::atomic<bool> m_reset{ false };
+
+    // owned by the audio thread
+    sample m_current;
+    sample m_ramp_target;
+    sample m_step{ 0.0 };
+    sample m_coefficient{ 0.0 };
+    long m_remaining{ 0 };
+
+    // Start moving towards a new value if one has been set.
+    void update()
+    {
+        const auto target{ m_target.load(std::memory_order_relaxed) };
+
+        if (m_reset.exchange(false, std::memory_order_acquire)) {
+            m_current = target;
+            m_ramp_target = target;
+            m_remaining = 0;
+            return;
+        }
+
+        if (target == m_ramp_target) {
+            return;
+        }
+        m_ramp_target = target;
+
+        const auto ramp_samples{ static_cast<long>(m_ramp_time.load(std::memory_order_relaxed) * 0.001 * m_samplerate.load(std::memory_order_relaxed)) };
+
+        if constexpr (mode == smoothing::block) {
+            m_remaining = 0;
+        }
+        else {
+            m_remaining = std::max<long>(ramp_samples, 0);
+        }
+
+        if (m_remaining == 0) {
+            m_current = target;
+        }
+        else if constexpr (mode == smoothing::exponential) {
+            m_coefficient = std::exp(std::log(0.001) / m_remaining);
+        }
+        else {
+            m_step = (target - m_current) / m_remaining;
+        }
+    }
+};
+
+} // namespace c74::min
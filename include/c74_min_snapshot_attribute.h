@@ -0,0 +1,218 @@
+/// @file
+///	@ingroup 	minapi
+///	@copyright	Copyright 2018 The Min-API Authors. All rights reserved.
+///	@license	Use of this source code is governed by the MIT License found in the License.md file.
+
+#pragma once
+
+namespace c74::min {
+
+/// A value shared with the audio thread as a series of snapshots (read-copy-update).
+///
+/// Each new value is copied into a new snapshot which replaces the current one in a single atomic operation.
+/// Reading is wait-free and does not allocate, so it is safe on the audio thread for any type of value.
+/// Replaced snapshots are freed later on the main thread, once no reader can still be looking at them.
+///
+/// Any number of threads may read at once. Publishing may happen on any thread except the audio thread, as it allocates.
+///
+/// @tparam	T	The type of the value.
+
+template <class T>
+class snapshot
+{
+  public:
+    /// A snapshot being read.
+    /// The snapshot stays valid until the reader is destroyed, so do not keep readers beyond the current vector.
+
+    class reader
+    {
+      public:
+        explicit reader(const snapshot& a_snapshot)
+            : m_readers{ a_snapshot.m_readers }
+        {
+            m_readers.fetch_add(1);
+            m_value = a_snapshot.m_current.load();
+        }
+
+        ~reader()
+        {
+            m_readers.fetch_sub(1, std::memory_order_release);
+        }
+
+        reader(const reader&) = delete;
+        reader& operator=(const reader&) = delete;
+
+        const T& operator*() const
+        {
+            return *m_value;
+        }
+
+        const T* operator->() const
+        {
+            return m_value;
+        }
+
+      private:
+        std::atomic<int>& m_readers;
+        const T* m_value;
+    };
+
+    /// Create a snapshot.
+    /// @param	a_value		The initial value.
+    explicit snapshot(const T& a_value)
+        : m_current{ new T(a_value) }
+    {
+    }
+
+    ~snapshot()
+    {
+        delete m_current.load();
+        for (auto a_snapshot : m_retired) {
+            delete a_snapshot;
+        }
+    }
+
+    // Snapshots cannot be copied: readers hold on to them.
+    snapshot(const snapshot&) = delete;
+    snapshot& operator=(const snapshot& value) = delete;
+
+    /// Make a new value current.
+    /// Readers that started before this returns may still see the previous value until they are done.
+    /// Do not call this from the audio thread.
+    /// @param	a_value		The new value.
+
+    void publish(const T& a_value)
+    {
+        const auto replacement{ new T(a_value) };
+
+        {
+            std::lock_guard<std::mutex> lock{ m_retired_mutex };
+            m_retired.push_back(m_current.exchange(replacement));
+        }
+        m_trigger.set();
+    }
+
+    /// Read the current value.
+    /// Call this from the audio thread (or any other).
+    /// @return	A reader for the current snapshot.
+
+    reader read() const
+    {
+        return reader{ *this };
+    }
+
+    /// Free replaced snapshots if no reader can be using them.
+    /// This is called on the main thread after each publish(), and again after a while as long as a reader may be using them.
+    /// @return	True if there is nothing left to free.
+
+    bool reclaim()
+    {
+        std::lock_guard<std::mutex> lock{ m_retired_mutex };
+
+        if (m_retired.empty()) {
+            return true;
+        }
+
+        // Every snapshot retired so far was replaced before this check,
+        // so a reader starting from here on can only get the current one.
+        if (m_readers.load() != 0) {
+            return false;
+        }
+
+        for (auto a_snapshot : m_retired) {
+            delete a_snapshot;
+        }
+        m_retired.clear();
+        return true;
+    }
+
+    /// The number of replaced snapshots waiting to be freed.
+    /// @return	The number of snapshots.
+
+    size_t retired_count()
+    {
+        std::lock_guard<std::mutex> lock{ m_retired_mutex };
+        return m_retired.size();
+    }
+
+  private:
+    std::atomic<T*> m_current;
+    mutable std::atomic<int> m_readers{ 0 };
+
+    std::mutex m_retired_mutex;
+    vector<T*> m_retired;
+    reclaim_trigger<snapshot> m_trigger{ this };
+};
+
+
+/// An attribute whose value may be read from the audio thread, whatever its type.
+///
+/// Reading an attribute while another thread sets it is a data race, and for types such as vectors, symbols or numbers
+/// setting it may free memory that the audio thread is reading.
+/// A snapshot_attribute is set and read on the main thread like any other attribute,
+/// and in addition publishes each value as a snapshot that the audio thread reads with snapshot().
+///
+/// @ingroup	attributes
+/// @tparam		T				The type of the data saved in the attribute.
+/// @tparam		threadsafety	As for attribute<>.
+/// @tparam		limit_type		As for attribute<>.
+/// @tparam		repetitions		As for attribute<>.
+///
+/// @code
+/// snapshot_attribute<numbers> gains { this, "gains", { 1.0, 1.0 } };
+///
+/// void operator()(audio_bundle input, audio_bundle output) {
+///     auto current_gains = gains.snapshot();
+///     for (auto channel = 0; channel < output.channel_count(); ++channel)
+///         output.channel(channel).scale((*current_gains)[channel % current_gains->size()]);
+/// }
+/// @endcode
+
+template <typename T, threadsafe threadsafety = threadsafe::undefined, template <typename> class limit_type = limit::none,
+          allow_repetitions repetitions = allow_repetitions::yes>
+class snapshot_attribute : public attribute<T, threadsafety, limit_type, repetitions>
+{
+    using base = attribute<T, threadsafety, limit_type, repetitions>;
+
+  public:
+    /// Create a snapshot attribute.
+    /// The arguments are the same as for attribute<>.
+
+    template <typename... ARGS>
+    snapshot_attribute(object_base* an_owner, const std::string a_name, const T a_default_value, ARGS... args)
+        : base{ an_owner, a_name, a_default_value, args... }
+        , m_snapshot{ this->get() }
+    {
+        // Publish each value as it is assigned, on whichever thread that happens.
+        const setter user_setter{ this->m_setter };
+
+        this->m_setter = [this, user_setter](const atoms& args, const int inlet) -> atoms {
+            const auto value{ user_setter ? user_setter(args, inlet) : args };
+            m_snapshot.publish(from_atoms<T>(value));
+            return value;
+        };
+    }
+
+    using base::operator=;
+
+    /// Read the value from the audio thread.
+    /// @return	A reader for the current value, valid until the reader is destroyed.
+
+    typename c74::min::snapshot<T>::reader snapshot() const
+    {
+        return m_snapshot.read();
+    }
+
+    // DO NOT USE
+    // Free snapshots that have been replaced. This happens automatically on the main thread.
+
+    bool reclaim()
+    {
+        return m_snapshot.reclaim();
+    }
+
+  private:
+    c74::min::snapshot<T> m_snapshot;
+};
+
+} // namespace c74::min
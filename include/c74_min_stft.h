@@ -0,0 +1,251 @@
+/// @file
+///	@ingroup 	minapi
+///	@copyright	Copyright 2018 The Min-API Authors. All rights reserved.
+///	@license	Use of this source code is governed by the MIT License found in the License.md file.
+
+#pragma once
+
+namespace c74::min {
+
+/// A short-time Fourier transform, for the spectral processing of audio in a vector_operator<>.
+///
+/// The audio of each channel is cut into overlapping frames of fft_size() samples, each starting hop_size() samples
+/// after the previous one, whatever the vector size.
+/// Each frame is windowed and transformed, and your function is called with its spectrum to modify in place.
+/// The spectrum is then transformed back, windowed again, and added to the output.
+/// The analysis and synthesis windows are sine windows, whose product is a Hann window, and the output is scaled
+/// such that it is the input when the spectra are left alone, delayed by latency() samples.
+///
+/// The memory is allocated when the stft is created or resized, e.g. in dspsetup, and processing does not allocate.
+/// The audio thread switches to the new sizes at the start of its next vector.
+///
+/// @code
+/// stft spectral { 1024, 4, 2, [](spectrum bins, size_t channel) {
+///     for (auto& bin : bins)
+///         if (std::abs(bin) < 0.01)
+///             bin = 0.0;
+/// }};
+///
+/// void operator()(audio_bundle input, audio_bundle output) {
+///     spectral(input, output);
+/// }
+/// @endcode
+
+class stft
+{
+    // Everything that depends on the sizes, swapped as a whole when they change.
+    struct state
+    {
+        state(const size_t a_fft_size, const size_t an_overlap, const size_t a_channel_count)
+            : transform{ a_fft_size }
+            , fft_size{ a_fft_size }
+            , hop_size{ a_fft_size / an_overlap }
+            , channel_count{ a_channel_count }
+            , window(a_fft_size)
+            , frame(a_fft_size)
+            , bins(transform.bin_count())
+            , input(a_fft_size * a_channel_count)
+            , output(a_fft_size * a_channel_count)
+        {
+            const auto pi{ std::acos(-1.0) };
+
+            for (size_t i = 0; i < fft_size; ++i) {
+                window[i] = std::sin(pi * i / fft_size);
+            }
+
+            // the windows overlap to a constant, by which the synthesis window is divided
+            auto overlap_sum{ 0.0 };
+            for (size_t i = 0; i < fft_size; i += hop_size) {
+                overlap_sum += window[i] * window[i];
+            }
+            synthesis_gain = overlap_sum > 0.0 ? 1.0 / overlap_sum : 0.0;
+        }
+
+        fft transform;
+        size_t fft_size;
+        size_t hop_size;
+        size_t channel_count;
+        vector<sample> window;
+        vector<sample> frame;
+        vector<complex_sample> bins;
+        vector<sample> input; // a ring of the last fft_size samples for each channel
+        vector<sample> output; // a ring of the overlapping output for each channel, read fft_size samples after it was written
+        sample synthesis_gain;
+        size_t position{ 0 }; // the index in the rings of the current sample
+        size_t hop_remaining{ 0 };
+    };
+
+  public:
+    /// The function called with the spectrum of each frame and the index of its channel, on the audio thread.
+    using handler = std::function<void(spectrum, size_t)>;
+
+    /// Create a short-time Fourier transform.
+    /// @param	a_fft_size		The number of samples in each frame. A power of two of at least 4.
+    /// @param	an_overlap		The number of frames overlapping each sample. A power of two of at least 2, and at most the fft size.
+    /// @param	a_channel_count	The number of channels processed.
+    /// @param	a_handler		The function processing the spectrum of each frame.
+    stft(const size_t a_fft_size, const size_t an_overlap, const size_t a_channel_count, const handler& a_handler)
+        : m_handler{ a_handler }
+    {
+        resize(a_fft_size, an_overlap, a_channel_count);
+    }
+
+    // The stft cannot be copied: the audio thread holds on to its memory.
+    stft(const stft&) = delete;
+    stft& operator=(const stft& value) = delete;
+
+    /// Change the sizes, allocating new memory. Call this on the main thread, e.g. from dspsetup.
+    /// The audio thread switches at the start of its next vector, and the frames start again from silence.
+    /// Invalid sizes are an error, leaving the sizes as they were.
+    /// @param	a_fft_size		The number of samples in each frame. A power of two of at least 4.
+    /// @param	an_overlap		The number of frames overlapping each sample. A power of two of at least 2, and at most the fft size.
+    /// @param	a_channel_count	The number of channels processed.
+    void resize(const size_t a_fft_size, const size_t an_overlap, const size_t a_channel_count)
+    {
+        if (a_fft_size < 4 || (a_fft_size & (a_fft_size - 1)) != 0) {
+            error("stft fft size must be a power of two of at least 4");
+            return;
+        }
+        if (an_overlap < 2 || an_overlap > a_fft_size || (an_overlap & (an_overlap - 1)) != 0) {
+            error("stft overlap must be a power of two of at least 2, and at most the fft size");
+            return;
+        }
+
+        auto replacement{ std::make_unique<state>(a_fft_size, an_overlap, a_channel_count) };
+        replacement->hop_remaining = replacement->hop_size;
+
+        m_fft_size = a_fft_size;
+        m_hop_size = replacement->hop_size;
+        m_channel_count = a_channel_count;
+        m_states.publish(std::move(replacement));
+    }
+
+    /// The number of samples in each frame.
+    /// @return	The fft size.
+    size_t fft_size() const
+    {
+        return m_fft_size;
+    }
+
+    /// The number of samples between the starts of frames.
+    /// @return	The hop size.
+    size_t hop_size() const
+    {
+        return m_hop_size;
+    }
+
+    /// The number of bins in the spectrum of each frame.
+    /// @return	fft_size() / 2 + 1
+    size_t bin_count() const
+    {
+        return m_fft_size / 2 + 1;
+    }
+
+    /// The number of channels processed.
+    /// @return	The number of channels.
+    size_t channel_count() const
+    {
+        return m_channel_count;
+    }
+
+    /// The delay of the output.
+    /// @return	The latency in samples.
+    size_t latency() const
+    {
+        return m_fft_size;
+    }
+
+    /// Process a vector of audio.
+    /// Channels of the input beyond channel_count() are ignored, and those of the output are silenced.
+    /// @param	input	The incoming audio.
+    /// @param	output	The outgoing audio. It may share memory with the input.
+    void operator()(audio_bundle input, audio_bundle output)
+    {
+        m_states.update();
+
+        if (!m_states.current()) {
+            output.clear();
+            return;
+        }
+
+        auto&      s{ *m_states.current() };
+        const auto channels{ static_cast<size_t>(std::min(input.channel_count(), output.channel_count())) };
+        const auto processed{ std::min(channels, s.channel_count) };
+        const auto frame_count{ static_cast<size_t>(output.frame_count()) };
+
+        for (auto channel = static_cast<long>(processed); channel < output.channel_count(); ++channel) {
+            output.channel(channel).clear();
+        }
+
+        size_t done{ 0 };
+        while (done < frame_count) {
+            // up to the end of the vector, the end of the rings or the next frame, whichever comes first
+            const auto chunk{ std::min({ frame_count - done, s.fft_size - s.position, s.hop_remaining }) };
+
+            for (size_t channel = 0; channel < processed; ++channel) {
+                const auto in{ input.samples(channel) + done };
+                const auto out{ output.samples(channel) + done };
+                const auto input_ring{ s.input.data() + channel * s.fft_size + s.position };
+                const auto output_ring{ s.output.data() + channel * s.fft_size + s.position };
+
+                std::copy(in, in + chunk, input_ring);
+                std::copy(output_ring, output_ring + chunk, out);
+                std::fill(output_ring, output_ring + chunk, 0.0);
+            }
+
+            done += chunk;
+            s.position = (s.position + chunk) % s.fft_size;
+            s.hop_remaining -= chunk;
+
+            if (s.hop_remaining == 0) {
+                s.hop_remaining = s.hop_size;
+                for (size_t channel = 0; channel < processed; ++channel) {
+                    process_frame(s, channel);
+                }
+            }
+        }
+    }
+
+  private:
+    handler m_handler;
+    handoff<state> m_states;
+    size_t m_fft_size{ 0 }; // the sizes set last, on the main thread
+    size_t m_hop_size{ 0 };
+    size_t m_channel_count{ 0 };
+
+    // Transform the last fft_size samples of a channel, let the handler process the spectrum,
+    // and add the result to the output, to be read from the next sample on.
+    void process_frame(state& s, const size_t channel)
+    {
+        const auto input_ring{ s.input.data() + channel * s.fft_size };
+        const auto output_ring{ s.output.data() + channel * s.fft_size };
+        const auto oldest{ s.position }; // the oldest sample in the ring, whose slot in the output is read next
+
+        const auto wrap{ s.fft_size - oldest }; // the frame reaches the end of the rings after this many samples
+
+        for (size_t i = 0; i < wrap; ++i) {
+            s.frame[i] = input_ring[oldest + i] * s.window[i];
+        }
+        for (size_t i = wrap; i < s.fft_size; ++i) {
+            s.frame[i] = input_ring[i - wrap] * s.window[i];
+        }
+
+        s.transform.forward(s.frame.data(), s.bins.data());
+        if (m_handler) {
+            m_handler(spectrum{ s.bins.data(), s.bins.size() }, channel);
+        }
+        s.transform.inverse(s.bins.data(), s.frame.data());
+
+        for (size_t i = 0; i < s.fft_size; ++i) {
+            s.frame[i] *= s.window[i] * s.synthesis_gain;
+        }
+        for (size_t i = 0; i < wrap; ++i) {
+            output_ring[oldest + i] += s.frame[i];
+        }
+        for (size_t i = wrap; i < s.fft_size; ++i) {
+            output_ring[i - wrap] += s.frame[i];
+        }
+    }
+};
+
+} // namespace c74::min
@@ -0,0 +1,352 @@
+/// @file
+///	@ingroup 	minapi
+///	@copyright	Copyright 2018 The Min-API Authors. All rights reserved.
+///	@license	Use of this source code is governed by the MIT License found in the License.md file.
+
+#pragma once
+
+#if defined(_WIN32)
+#include <climits>
+#elif defined(__APPLE__)
+#include <dispatch/dispatch.h>
+#include <mach/mach.h>
+#include <mach/mach_time.h>
+#include <mach/thread_policy.h>
+#include <pthread.h>
+#elif !defined(_WIN32)
+#include <cerrno>
+#include <pthread.h>
+#include <sched.h>
+#include <semaphore.h>
+#endif
+
+namespace c74::min {
+
+// Hint to the processor that we are in a spin-wait loop.
+inline void spin_pause()
+{
+#if defined(_WIN32)
+    YieldProcessor();
+#elif (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+    __builtin_ia32_pause();
+#elif (defined(__GNUC__) || defined(__clang__)) && defined(__aarch64__)
+    __asm__ __volatile__("yield");
+#endif
+}
+
+
+// A counting semaphore of the operating system. Posting does not lock, and only enters the kernel to wake a waiting thread,
+// so it may be called from the audio thread.
+class semaphore
+{
+  public:
+    semaphore()
+    {
+#if defined(_WIN32)
+        m_handle = CreateSemaphore(nullptr, 0, LONG_MAX, nullptr);
+#elif defined(__APPLE__)
+        m_handle = dispatch_semaphore_create(0);
+#else
+        sem_init(&m_handle, 0, 0);
+#endif
+    }
+
+    ~semaphore()
+    {
+#if defined(_WIN32)
+        CloseHandle(m_handle);
+#elif defined(__APPLE__)
+        dispatch_release(m_handle);
+#else
+        sem_destroy(&m_handle);
+#endif
+    }
+
+    semaphore(const semaphore&) = delete;
+    semaphore& operator=(const semaphore& value) = delete;
+
+    void post()
+    {
+#if defined(_WIN32)
+        ReleaseSemaphore(m_handle, 1, nullptr);
+#elif defined(__APPLE__)
+        dispatch_semaphore_signal(m_handle);
+#else
+        sem_post(&m_handle);
+#endif
+    }
+
+    void wait()
+    {
+#if defined(_WIN32)
+        WaitForSingleObject(m_handle, INFINITE);
+#elif defined(__APPLE__)
+        dispatch_semaphore_wait(m_handle, DISPATCH_TIME_FOREVER);
+#else
+        while (sem_wait(&m_handle) == -1 && errno == EINTR) {
+        }
+#endif
+    }
+
+  private:
+#if defined(_WIN32)
+    HANDLE m_handle;
+#elif defined(__APPLE__)
+    dispatch_semaphore_t m_handle;
+#else
+    sem_t m_handle;
+#endif
+};
+
+
+// Give a thread the realtime priority of audio processing, for vectors of a duration.
+// This needs no permission on macOS and Windows. On Linux it needs permission to use SCHED_FIFO, and fails silently without it.
+inline void make_realtime(std::thread& a_thread, const std::chrono::microseconds a_vector_duration)
+{
+#if defined(_WIN32)
+    SetThreadPriority(a_thread.native_handle(), THREAD_PRIORITY_TIME_CRITICAL);
+#elif defined(__APPLE__)
+    mach_timebase_info_data_t timebase;
+    mach_timebase_info(&timebase);
+    const auto period{ static_cast<uint32_t>(std::chrono::nanoseconds(a_vector_duration).count() * timebase.denom / timebase.numer) };
+
+    // as CoreAudio does for its own threads: the work of a vector may take up to half of it, and must be done within it
+    thread_time_constraint_policy_data_t policy{ period, period / 2, period, true };
+    thread_policy_set(pthread_mach_thread_np(a_thread.native_handle()), THREAD_TIME_CONSTRAINT_POLICY,
+                      reinterpret_cast<thread_policy_t>(&policy), THREAD_TIME_CONSTRAINT_POLICY_COUNT);
+#else
+    (void)a_vector_duration;
+    sched_param parameters{};
+    parameters.sched_priority = sched_get_priority_max(SCHED_FIFO) - 1;
+    pthread_setschedparam(a_thread.native_handle(), SCHED_FIFO, &parameters);
+#endif
+}
+
+
+/// A small, fixed set of threads sharing the work of the thread calling run().
+///
+/// The calling thread (typically the audio thread) processes tasks too, and run() returns when all tasks are done.
+/// Tasks are handed out one at a time, so the calling thread never waits for a worker that has not started.
+/// The workers run at realtime priority, so that the audio thread waiting for them is not held up by other threads.
+/// Running does not allocate or lock: workers spin for a short while after finishing,
+/// then sleep on a semaphore of their own, which run() posts to wake them.
+///
+/// A pool may be shared, e.g. by several objects: when one thread is running tasks, another thread calling run()
+/// does all of its tasks itself rather than wait.
+
+class worker_pool
+{
+    // A worker's way of sleeping until the next run.
+    struct sleeper
+    {
+        semaphore wake;
+        std::atomic<bool> asleep{ false }; // set by the worker before it waits, cleared by whoever posts
+    };
+
+  public:
+    /// The time workers spin waiting for more work before they sleep.
+    /// Well below the duration of a vector, so that workers do not take a core from other threads between vectors.
+    static constexpr std::chrono::microseconds k_default_spin_time{ 100 };
+
+    /// The duration of a vector assumed for the priority of the workers when none is given, about 64 samples at 44.1 kHz.
+    static constexpr std::chrono::microseconds k_default_vector_duration{ 1500 };
+
+    /// Create a pool. The threads are not started until start() is called.
+    /// @param	a_thread_count	The number of threads in addition to the one calling run().
+    /// @param	a_spin_time		How long workers keep spinning for more work before they sleep.
+    explicit worker_pool(const size_t a_thread_count, const std::chrono::microseconds a_spin_time = k_default_spin_time)
+        : m_thread_count{ a_thread_count }
+        , m_spin_time{ a_spin_time }
+        , m_sleepers{ std::make_unique<sleeper[]>(a_thread_count) }
+    {
+    }
+
+    ~worker_pool()
+    {
+        stop();
+    }
+
+    // Pools cannot be copied: the threads hold on to them.
+    worker_pool(const worker_pool&) = delete;
+    worker_pool& operator=(const worker_pool& value) = delete;
+
+    /// Start the threads, if they are not running already, and give them the priority of audio processing.
+    /// Call this from the main thread, e.g. when the audio is compiled.
+    /// @param	a_vector_duration	The duration of the vectors processed, for the priority of the threads.
+    void start(const std::chrono::microseconds a_vector_duration = k_default_vector_duration)
+    {
+        if (!m_running) {
+            m_stopping = false;
+            for (size_t i = 0; i < m_thread_count; ++i) {
+                m_threads.emplace_back([this, i] { work(m_sleepers[i]); });
+            }
+            m_running = true;
+        }
+
+        for (auto& thread : m_threads) {
+            make_realtime(thread, a_vector_duration);
+        }
+    }
+
+    /// Stop the threads and wait for them to finish.
+    void stop()
+    {
+        m_running = false;
+        m_stopping = true;
+        wake_sleepers();
+
+        for (auto& thread : m_threads) {
+            thread.join();
+        }
+        m_threads.clear();
+    }
+
+    /// The number of threads in addition to the one calling run().
+    /// @return	The number of worker threads.
+    size_t thread_count() const
+    {
+        return m_thread_count;
+    }
+
+    /// Are the threads running? This may be asked from any thread.
+    /// @return	True if start() has been called.
+    bool running() const
+    {
+        return m_running;
+    }
+
+    /// Call a function for each of a number of tasks, sharing the calls between this thread and the workers.
+    /// Returns when all tasks are done. If another thread is running tasks already, all calls are made on this thread.
+    ///
+    /// @param	task_count	The number of tasks.
+    /// @param	task		A function called with the index of each task. It is called from several threads at once.
+    template <class F>
+    void run(const size_t task_count, F& task)
+    {
+        if (m_busy.exchange(true, std::memory_order_acquire)) {
+            for (size_t i = 0; i < task_count; ++i) {
+                task(i);
+            }
+            return;
+        }
+
+        m_task = [](void* context, const size_t index) { (*static_cast<F*>(context))(index); };
+        m_context = &task;
+        m_task_count = task_count;
+        m_next_task.store(0, std::memory_order_relaxed);
+        m_completed.store(0, std::memory_order_relaxed);
+        m_open = true;
+        m_generation.fetch_add(1);
+
+        wake_sleepers();
+        process();
+
+        for (auto spins = 0; m_completed.load(std::memory_order_acquire) < task_count; ++spins) {
+            pause(spins);
+        }
+
+        // make sure no worker is still looking at this run before the next one is set up
+        m_open = false;
+        for (auto spins = 0; m_active > 0; ++spins) {
+            pause(spins);
+        }
+        m_busy.store(false, std::memory_order_release);
+    }
+
+  private:
+    size_t m_thread_count;
+    std::chrono::microseconds m_spin_time;
+    vector<std::thread> m_threads; // used on the main thread only
+    std::unique_ptr<sleeper[]> m_sleepers;
+    std::atomic<bool> m_running{ false };
+    std::atomic<bool> m_busy{ false }; // set by the thread calling run() for the duration of its run
+
+    // the current run, written only while no worker is active
+    void (*m_task)(void* context, size_t index){ nullptr };
+    void* m_context{ nullptr };
+    size_t m_task_count{ 0 };
+
+    std::atomic<size_t> m_next_task{ 0 };
+    std::atomic<size_t> m_completed{ 0 };
+    std::atomic<bool> m_open{ false };
+    std::atomic<uint64_t> m_generation{ 0 };
+    std::atomic<int> m_active{ 0 };
+    std::atomic<bool> m_stopping{ false };
+
+    static void pause(const int spins)
+    {
+        if (spins < 64) {
+            spin_pause();
+        }
+        else {
+            std::this_thread::yield(); // the thread we are waiting for may need this core
+        }
+    }
+
+    void process()
+    {
+        for (;;) {
+            const auto index{ m_next_task.fetch_add(1, std::memory_order_relaxed) };
+            if (index >= m_task_count) {
+                return;
+            }
+            m_task(m_context, index);
+            m_completed.fetch_add(1, std::memory_order_release);
+        }
+    }
+
+    // Post the semaphore of each worker that has gone to sleep, after a new run or stopping has been announced.
+    // A worker sets its flag before checking for either one, so it either sees it or is seen here.
+    void wake_sleepers()
+    {
+        for (size_t i = 0; i < m_thread_count; ++i) {
+            auto& s{ m_sleepers[i] };
+            if (s.asleep.load() && s.asleep.exchange(false)) {
+                s.wake.post();
+            }
+        }
+    }
+
+    void sleep(sleeper& s, const uint64_t seen)
+    {
+        s.asleep = true;
+        if (m_generation != seen || m_stopping) {
+            if (s.asleep.exchange(false)) {
+                return; // nobody is posting
+            }
+            // run() or stop() cleared the flag, so a post is coming: take it
+        }
+        s.wake.wait();
+    }
+
+    void work(sleeper& s)
+    {
+        uint64_t seen{ m_generation };
+
+        for (;;) {
+            auto spin_until{ std::chrono::steady_clock::now() + m_spin_time };
+
+            for (auto spins = 0; m_generation == seen && !m_stopping; ++spins) {
+                if (std::chrono::steady_clock::now() >= spin_until) {
+                    sleep(s, seen);
+                    spin_until = std::chrono::steady_clock::now() + m_spin_time;
+                }
+                pause(spins);
+            }
+
+            if (m_stopping) {
+                return;
+            }
+
+            seen = m_generation;
+
+            ++m_active;
+            if (m_open) {
+                process();
+            }
+            --m_active;
+        }
+    }
+};
+
+} // namespace c74::min
@@ -25,6 +25,11 @@ file(GLOB_RECURSE C74_MIN_HEADERS ${CMAKE_CURRENT_LIST_DIR}/../include/*.h)
 
 add_definitions(-DC74_MIN_API)
 
+option(C74_MIN_SMALL_ATOMS "Store short lists of atoms inline instead of allocating them" OFF)
+if (${C74_MIN_SMALL_ATOMS})
+    add_definitions(-DC74_MIN_SMALL_ATOMS)
+endif ()
+
 if (EXISTS "${CMAKE_CURRENT_LIST_DIR}/../../min-lib")
     message(STATUS "Min-Lib found")
     add_definitions(
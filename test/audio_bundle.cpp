@@ -0,0 +1,248 @@
+/// @file
+///	@ingroup 	minapi
+///	@copyright	Copyright 2018 The Min-API Authors. All rights reserved.
+///	@license	Use of this source code is governed by the MIT License found in the License.md file.
+#include "catch.hpp"
+#include "c74_min_api.h"
+
+using namespace c74::min;
+
+
+TEST_CASE("Audio bundle channel views", "[audio_bundle]") {
+	const long frame_count { 8 };
+	vector<sample> left(frame_count, 1.0), right(frame_count, 2.0);
+	double* samples[] { left.data(), right.data() };
+	audio_bundle bundle { samples, 2, frame_count };
+
+	SECTION("A channel view covers the samples of that channel") {
+		auto channel { bundle.channel(1) };
+		REQUIRE( channel.data() == right.data() );
+		REQUIRE( channel.size() == frame_count );
+		channel[3] = 0.5;
+		REQUIRE( right[3] == 0.5 );
+	}
+
+	SECTION("The channels range visits every channel in order") {
+		auto index { 0 };
+		for (auto channel : bundle.channels()) {
+			REQUIRE( channel.data() == samples[index] );
+			for (auto& x : channel)
+				x *= 10.0;
+			++index;
+		}
+		REQUIRE( index == 2 );
+		REQUIRE( bundle.channels().size() == 2 );
+		REQUIRE( left[0] == 10.0 );
+		REQUIRE( right[frame_count - 1] == 20.0 );
+	}
+}
+
+
+TEST_CASE("Audio bundles processed in place", "[audio_bundle]") {
+	const long frame_count { 8 };
+	vector<sample> a(frame_count, 1.0), b(frame_count, 2.0), c(frame_count, 3.0);
+	double* input_samples[] { a.data(), b.data() };
+	double* inplace_samples[] { b.data(), a.data() };
+	double* separate_samples[] { c.data() };
+	audio_bundle input { input_samples, 2, frame_count };
+	audio_bundle inplace_output { inplace_samples, 2, frame_count };
+	audio_bundle separate_output { separate_samples, 1, frame_count };
+
+	SECTION("Shared memory is found in any channel") {
+		REQUIRE( input.shares_memory_with(inplace_output) );
+		REQUIRE( !input.shares_memory_with(separate_output) );
+		REQUIRE( input.channel(0).overlaps(inplace_output.channel(1)) );
+		REQUIRE( !input.channel(0).overlaps(inplace_output.channel(0)) );
+	}
+
+	SECTION("Overlapping parts of a vector are found") {
+		sample_span first_half { a.data(), frame_count / 2 };
+		sample_span second_half { a.data() + frame_count / 2, frame_count / 2 };
+		sample_span middle { a.data() + 2, frame_count / 2 };
+		REQUIRE( !first_half.overlaps(second_half) );
+		REQUIRE( middle.overlaps(first_half) );
+		REQUIRE( middle.overlaps(second_half) );
+	}
+
+	SECTION("Copying a bundle to itself leaves the samples unchanged") {
+		input = input;
+		REQUIRE( a[0] == 1.0 );
+		REQUIRE( b[0] == 2.0 );
+	}
+}
+
+
+// Scalar references for the bulk operations, one sample at a time.
+
+static void add_scalar(vector<sample>& a, const vector<sample>& b) {
+	for (auto i = 0; i < a.size(); ++i)
+		a[i] += b[i];
+}
+
+static void mix_scalar(vector<sample>& a, const vector<sample>& b, const sample gain) {
+	for (auto i = 0; i < a.size(); ++i)
+		a[i] += b[i] * gain;
+}
+
+static void ramp_scalar(vector<sample>& a, const sample start, const sample end) {
+	for (auto i = 0; i < a.size(); ++i)
+		a[i] *= start + (end - start) * i / a.size();
+}
+
+static sample peak_scalar(const vector<sample>& a) {
+	sample result { 0.0 };
+	for (auto x : a)
+		result = std::max(result, std::abs(x));
+	return result;
+}
+
+static sample rms_scalar(const vector<sample>& a) {
+	sample sum { 0.0 };
+	for (auto x : a)
+		sum += x * x;
+	return std::sqrt(sum / a.size());
+}
+
+
+struct test_bundle {
+	test_bundle(const long channel_count, const long frame_count, const double phase)
+	: storage(channel_count, vector<sample>(frame_count)) {
+		for (auto channel = 0; channel < channel_count; ++channel) {
+			for (auto i = 0; i < frame_count; ++i)
+				storage[channel][i] = std::sin(phase + channel + i * 0.1) * (channel + 1);
+			pointers.push_back(storage[channel].data());
+		}
+	}
+
+	audio_bundle bundle() {
+		return { pointers.data(), static_cast<long>(pointers.size()), static_cast<long>(storage[0].size()) };
+	}
+
+	vector<vector<sample>> storage;
+	vector<double*> pointers;
+};
+
+
+TEST_CASE("Audio bundle bulk operations match scalar references", "[audio_bundle]") {
+	// frame counts that are not a multiple of the lanes, including fewer frames than lanes
+	const long frame_count = GENERATE(1, 3, 64, 67);
+	const long channel_count { 3 };
+
+	test_bundle a { channel_count, frame_count, 0.0 };
+	test_bundle b { channel_count, frame_count, 1.0 };
+	auto expected { a.storage };
+	auto out { a.bundle() };
+
+	SECTION("clear") {
+		out.clear();
+		for (auto& channel : a.storage) {
+			for (auto x : channel)
+				REQUIRE( x == 0.0 );
+		}
+	}
+
+	SECTION("copy") {
+		out = b.bundle();
+		REQUIRE( a.storage == b.storage );
+	}
+
+	SECTION("add") {
+		out.add(b.bundle());
+		for (auto channel = 0; channel < channel_count; ++channel) {
+			add_scalar(expected[channel], b.storage[channel]);
+			for (auto i = 0; i < frame_count; ++i)
+				REQUIRE( a.storage[channel][i] == Approx(expected[channel][i]) );
+		}
+	}
+
+	SECTION("add to itself") {
+		out.add(out);
+		for (auto channel = 0; channel < channel_count; ++channel) {
+			for (auto i = 0; i < frame_count; ++i)
+				REQUIRE( a.storage[channel][i] == Approx(expected[channel][i] * 2.0) );
+		}
+	}
+
+	SECTION("scale") {
+		out.scale(0.3);
+		for (auto channel = 0; channel < channel_count; ++channel) {
+			for (auto i = 0; i < frame_count; ++i)
+				REQUIRE( a.storage[channel][i] == Approx(expected[channel][i] * 0.3) );
+		}
+	}
+
+	SECTION("mix") {
+		out.mix(b.bundle(), -0.7);
+		for (auto channel = 0; channel < channel_count; ++channel) {
+			mix_scalar(expected[channel], b.storage[channel], -0.7);
+			for (auto i = 0; i < frame_count; ++i)
+				REQUIRE( a.storage[channel][i] == Approx(expected[channel][i]) );
+		}
+	}
+
+	SECTION("ramp") {
+		out.ramp(0.25, 1.5);
+		for (auto channel = 0; channel < channel_count; ++channel) {
+			ramp_scalar(expected[channel], 0.25, 1.5);
+			for (auto i = 0; i < frame_count; ++i)
+				REQUIRE( a.storage[channel][i] == Approx(expected[channel][i]) );
+		}
+	}
+
+	SECTION("peak and RMS") {
+		sample peak { 0.0 };
+		vector<sample> all_samples;
+		for (auto channel = 0; channel < channel_count; ++channel) {
+			REQUIRE( out.channel(channel).peak() == peak_scalar(a.storage[channel]) );
+			REQUIRE( out.channel(channel).rms() == Approx(rms_scalar(a.storage[channel])) );
+			peak = std::max(peak, peak_scalar(a.storage[channel]));
+			all_samples.insert(all_samples.end(), a.storage[channel].begin(), a.storage[channel].end());
+		}
+		REQUIRE( out.peak() == peak );
+		REQUIRE( out.rms() == Approx(rms_scalar(all_samples)) );
+	}
+}
+
+
+TEST_CASE("Audio bundle bulk operations benchmark", "[.][benchmark]") {
+	const long frame_count { 512 };
+	const long channel_count { 8 };
+
+	test_bundle a { channel_count, frame_count, 0.0 };
+	test_bundle b { channel_count, frame_count, 1.0 };
+	auto out { a.bundle() };
+	auto in { b.bundle() };
+
+	BENCHMARK("mix (scalar)") {
+		for (auto channel = 0; channel < channel_count; ++channel)
+			mix_scalar(a.storage[channel], b.storage[channel], 0.5);
+		return a.storage[0][0];
+	};
+
+	BENCHMARK("mix (lanes)") {
+		out.mix(in, 0.5);
+		return a.storage[0][0];
+	};
+
+	BENCHMARK("ramp (scalar)") {
+		for (auto channel = 0; channel < channel_count; ++channel)
+			ramp_scalar(a.storage[channel], 1.0, 1.0);
+		return a.storage[0][0];
+	};
+
+	BENCHMARK("ramp (lanes)") {
+		out.ramp(1.0, 1.0);
+		return a.storage[0][0];
+	};
+
+	BENCHMARK("RMS (scalar)") {
+		sample sum { 0.0 };
+		for (auto channel = 0; channel < channel_count; ++channel)
+			sum += rms_scalar(b.storage[channel]);
+		return sum;
+	};
+
+	BENCHMARK("RMS (lanes)") {
+		return in.rms();
+	};
+}
@@ -0,0 +1,99 @@
+/// @file
+///	@ingroup 	minapi
+///	@copyright	Copyright 2018 The Min-API Authors. All rights reserved.
+///	@license	Use of this source code is governed by the MIT License found in the License.md file.
+#include "catch.hpp"
+#include "c74_min_api.h"
+
+using namespace c74::min;
+
+
+class control_test_object : public object<control_test_object> {};
+
+
+TEST_CASE("Control event queue", "[control_events]") {
+	control_test_object							my_object;
+	std::vector<std::pair<long, number>> applied;
+	long								position {0};
+	control_event_queue<number>			events {&my_object, [&](const number& value) { applied.emplace_back(position, value); }, 4};
+
+	std::vector<std::pair<long, long>> segments;
+	auto perform_vector = [&](const double now) {
+		segments.clear();
+		// at a samplerate of 1000 Hz each sample is a millisecond
+		perform_control_event_segments(my_object.control_event_queues(), now, 1000.0, 16, [&](const long start, const long end) {
+			position = end;
+			segments.emplace_back(start, end);
+		});
+	};
+
+	SECTION("The queue is registered with its owner") {
+		REQUIRE(my_object.control_event_queues().size() == 1);
+		REQUIRE(my_object.control_event_queues()[0] == &events);
+	}
+
+	SECTION("Without events the vector is processed in one segment") {
+		perform_vector(116.0);
+		REQUIRE(segments == std::vector<std::pair<long, long>>{ {0, 16} });
+		REQUIRE(applied.empty());
+	}
+
+	SECTION("The vector is split at the offsets of the events, which are applied between the segments") {
+		events.schedule_at(0.25, 103.0);
+		events.schedule_at(0.5, 110.5);
+
+		perform_vector(116.0); // covers 100 to 116 ms
+		REQUIRE(segments == std::vector<std::pair<long, long>>{ {0, 3}, {3, 11}, {11, 16} });
+		REQUIRE(applied == std::vector<std::pair<long, number>>{ {3, 0.25}, {11, 0.5} });
+	}
+
+	SECTION("Events at the same offset are applied together") {
+		events.schedule_at(0.25, 105.0);
+		events.schedule_at(0.5, 105.0);
+
+		perform_vector(116.0);
+		REQUIRE(segments == std::vector<std::pair<long, long>>{ {0, 5}, {5, 16} });
+		REQUIRE(applied == std::vector<std::pair<long, number>>{ {5, 0.25}, {5, 0.5} });
+	}
+
+	SECTION("Late events are applied at the start of the vector") {
+		events.schedule_at(0.25, 50.0);
+
+		perform_vector(116.0);
+		REQUIRE(segments == std::vector<std::pair<long, long>>{ {0, 16} });
+		REQUIRE(applied == std::vector<std::pair<long, number>>{ {0, 0.25} });
+	}
+
+	SECTION("Events for later vectors wait until they are due") {
+		events.schedule_at(0.25, 130.0);
+
+		perform_vector(116.0);
+		REQUIRE(applied.empty());
+
+		perform_vector(132.0); // covers 116 to 132 ms
+		REQUIRE(segments == std::vector<std::pair<long, long>>{ {0, 14}, {14, 16} });
+		REQUIRE(applied == std::vector<std::pair<long, number>>{ {14, 0.25} });
+	}
+
+	SECTION("The events of all the queues of an object split the vector") {
+		std::vector<number>		   other_applied;
+		control_event_queue<number> other {&my_object, [&](const number& value) { other_applied.push_back(value); }};
+
+		events.schedule_at(0.25, 108.0);
+		other.schedule_at(0.75, 104.0);
+
+		perform_vector(116.0);
+		REQUIRE(segments == std::vector<std::pair<long, long>>{ {0, 4}, {4, 8}, {8, 16} });
+		REQUIRE(applied == std::vector<std::pair<long, number>>{ {8, 0.25} });
+		REQUIRE(other_applied == std::vector<number>{ 0.75 });
+	}
+
+	SECTION("Events are dropped when the queue is full") {
+		for (auto i = 0; i < 5; ++i)
+			events.schedule_at(i, 101.0 + i);
+		REQUIRE(events.dropped() == 1);
+
+		perform_vector(116.0);
+		REQUIRE(applied.size() == 4);
+	}
+}
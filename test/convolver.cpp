@@ -0,0 +1,183 @@
+/// @file
+///	@ingroup 	minapi
+///	@copyright	Copyright 2018 The Min-API Authors. All rights reserved.
+///	@license	Use of this source code is governed by the MIT License found in the License.md file.
+#include "catch.hpp"
+#include "c74_min_api.h"
+
+using namespace c74::min;
+
+
+static vector<sample> random_samples(const size_t size, uint32_t seed) {
+	vector<sample> samples(size);
+	for (auto& x : samples) {
+		seed = seed * 1664525 + 1013904223;
+		x = seed / 4294967296.0 - 0.5;
+	}
+	return samples;
+}
+
+
+// Convolve one channel of a signal with one channel of an interleaved impulse response, directly.
+static vector<sample> convolve(const vector<sample>& input, const vector<sample>& impulse_response, const size_t ir_channel_count,
+	const size_t ir_channel) {
+	const auto	   ir_frame_count { impulse_response.size() / ir_channel_count };
+	vector<sample> output(input.size());
+
+	for (size_t i = 0; i < input.size(); ++i) {
+		for (size_t k = 0; k < ir_frame_count && k <= i; ++k)
+			output[i] += input[i - k] * impulse_response[k * ir_channel_count + ir_channel];
+	}
+	return output;
+}
+
+
+// Process signals through a convolver in vectors of a size, in place.
+static void process(convolver& a_convolver, vector<vector<sample>>& signals, const long vector_size) {
+	const auto	   frame_count { static_cast<long>(signals[0].size()) };
+	vector<double*> samples(signals.size());
+
+	for (long start = 0; start < frame_count; start += vector_size) {
+		for (size_t channel = 0; channel < signals.size(); ++channel)
+			samples[channel] = signals[channel].data() + start;
+
+		audio_bundle bundle { samples.data(), static_cast<long>(signals.size()), std::min(vector_size, frame_count - start) };
+		a_convolver(bundle, bundle);
+	}
+}
+
+
+TEST_CASE("Partitioned convolution", "[convolver]") {
+	const size_t partition_size { 16 };
+	const size_t max_partition_size = GENERATE(16, 128);
+	const long	 vector_size = GENERATE(1, 7, 16, 64);
+	const size_t frame_count { 2048 };
+	const size_t ir_frame_count = GENERATE(1, 16, 300, 1000);
+
+	convolver  reverb { 2, partition_size, max_partition_size };
+	const auto impulse_response { random_samples(ir_frame_count * 2, 1) };
+	const auto left { random_samples(frame_count, 2) };
+	const auto right { random_samples(frame_count, 3) };
+
+	REQUIRE( reverb.latency() == partition_size );
+
+	SECTION("Without an impulse response the output is silent") {
+		vector<vector<sample>> signals { left, right };
+		process(reverb, signals, vector_size);
+		for (auto& signal : signals) {
+			for (auto x : signal)
+				REQUIRE( x == 0.0 );
+		}
+	}
+
+	SECTION("The output is the convolution of the input with the impulse response, delayed by the latency") {
+		reverb.load(impulse_response.data(), ir_frame_count, 2);
+
+		vector<vector<sample>> signals { left, right };
+		process(reverb, signals, vector_size);
+
+		const auto expected_left { convolve(left, impulse_response, 2, 0) };
+		const auto expected_right { convolve(right, impulse_response, 2, 1) };
+		for (auto i = partition_size; i < frame_count; ++i) {
+			REQUIRE( signals[0][i] == Approx(expected_left[i - partition_size]).margin(1e-9) );
+			REQUIRE( signals[1][i] == Approx(expected_right[i - partition_size]).margin(1e-9) );
+		}
+	}
+
+	SECTION("Channels wrap around the channels of the impulse response") {
+		reverb.load(impulse_response.data(), ir_frame_count * 2, 1);
+
+		vector<vector<sample>> signals { left, right };
+		process(reverb, signals, vector_size);
+
+		const auto expected_right { convolve(right, impulse_response, 1, 0) };
+		for (auto i = partition_size; i < frame_count; ++i)
+			REQUIRE( signals[1][i] == Approx(expected_right[i - partition_size]).margin(1e-9) );
+	}
+}
+
+
+TEST_CASE("Loading impulse responses while convolving", "[convolver]") {
+	convolver  reverb { 1, 32, 256 };
+	const auto signal { random_samples(8192, 4) };
+	const auto first { random_samples(3000, 5) };
+	const auto second { random_samples(4000, 6) };
+
+	vector<vector<sample>> signals { signal };
+
+	reverb.load(first.data(), first.size());
+	process(reverb, signals, 64);
+
+	SECTION("The audio thread crossfades to the new impulse response, and the previous one is freed later") {
+		signals = { signal };
+		reverb.load(second.data(), second.size());
+		process(reverb, signals, 64);
+
+		// the new impulse response is longer than the previous one,
+		// so the input before it was taken is only convolved with the part the previous one reached
+		const auto tail_start { std::max(convolver::k_crossfade_frames, second.size() + 32) };
+		const auto expected { convolve(signal, second, 1, 0) };
+		for (auto i = tail_start; i < signal.size(); ++i)
+			REQUIRE( signals[0][i] == Approx(expected[i - 32]).margin(1e-9) );
+
+		// loading frees the impulse response replaced before, so that the audio thread can take the next one
+		reverb.clear();
+		signals = { signal };
+		process(reverb, signals, 64);
+		for (auto i = convolver::k_crossfade_frames; i < signal.size(); ++i)
+			REQUIRE( signals[0][i] == 0.0 );
+	}
+
+	SECTION("The input before a new impulse response is convolved with it after the crossfade") {
+		const auto third { random_samples(2500, 7) }; // longer than the crossfade
+		reverb.load(third.data(), third.size());
+		signals = { signal };
+		process(reverb, signals, 64);
+
+		vector<sample> heard { signal };
+		heard.insert(heard.end(), signal.begin(), signal.end());
+		const auto expected { convolve(heard, third, 1, 0) };
+		for (auto i = convolver::k_crossfade_frames; i < signal.size(); ++i)
+			REQUIRE( signals[0][i] == Approx(expected[signal.size() + i - 32]).margin(1e-9) );
+	}
+
+	SECTION("Clearing the impulse response fades the output to silence") {
+		reverb.clear();
+		signals = { signal };
+		process(reverb, signals, 64);
+
+		for (auto i = convolver::k_crossfade_frames; i < signal.size(); ++i)
+			REQUIRE( signals[0][i] == 0.0 );
+	}
+}
+
+
+TEST_CASE("Loading impulse responses from a buffer~", "[convolver]") {
+	SECTION("Reading the buffer~ does not mark it as modified, which would notify the reference that loads it again") {
+		REQUIRE( buffer_lock<false>::modifies_on_release );
+		REQUIRE_FALSE( convolver::impulse_response_lock::modifies_on_release );
+	}
+}
+
+
+TEST_CASE("Convolver benchmark", "[.][benchmark]") {
+	const size_t frame_count { 48000 };
+	const auto	 impulse_response { random_samples(frame_count, 7) };
+
+	vector<vector<sample>> signals { random_samples(4096, 8) };
+
+	convolver uniform { 1, 64 };
+	uniform.load(impulse_response.data(), frame_count);
+	convolver non_uniform { 1, 64, 4096 };
+	non_uniform.load(impulse_response.data(), frame_count);
+
+	BENCHMARK("uniform partitions of 64, one second of impulse response") {
+		process(uniform, signals, 64);
+		return signals[0][0];
+	};
+
+	BENCHMARK("partitions of 64 to 4096, one second of impulse response") {
+		process(non_uniform, signals, 64);
+		return signals[0][0];
+	};
+}
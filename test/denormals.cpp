@@ -0,0 +1,93 @@
+/// @file
+///	@ingroup 	minapi
+///	@copyright	Copyright 2018 The Min-API Authors. All rights reserved.
+///	@license	Use of this source code is governed by the MIT License found in the License.md file.
+#include "catch.hpp"
+#include "c74_min_api.h"
+
+using namespace c74::min;
+
+
+// A one-pole feedback loop with no input, decaying into denormals and then staying at the smallest of them.
+static sample decay(sample state, const long frame_count) {
+	for (auto i = 0; i < frame_count; ++i)
+		state *= 0.99;
+	return state;
+}
+
+
+class checked_operator : public check_outputs {};
+
+
+TEST_CASE("Denormals are flushed to zero in scope", "[denormals]") {
+	volatile sample tiny { std::numeric_limits<sample>::denorm_min() * 1000.0 };
+
+	REQUIRE( tiny * 0.5 != 0.0 );
+
+	if constexpr (scoped_flush_denormals::supported()) {
+		{
+			scoped_flush_denormals flush;
+			REQUIRE( tiny * 0.5 == 0.0 );
+			REQUIRE( decay(1e-300, 4096) == 0.0 );
+		}
+		// the previous flags are restored
+		REQUIRE( tiny * 0.5 != 0.0 );
+	}
+}
+
+
+TEST_CASE("Outputs are checked for NaN and infinite samples", "[denormals]") {
+	// frame counts that are not a multiple of the lanes, including fewer frames than lanes
+	const long frame_count = GENERATE(1, 3, 64, 67);
+	const long bad_frame = GENERATE(0, 1, 2);
+
+	vector<sample> left(frame_count, 0.5), right(frame_count, -0.5);
+	double* samples[] { left.data(), right.data() };
+	audio_bundle output { samples, 2, frame_count };
+	checked_operator checker;
+
+	SECTION("Finite outputs are left alone") {
+		REQUIRE( output.channel(0).finite() );
+		REQUIRE( perform_check_outputs(checker, output) );
+		REQUIRE( checker.nonfinite_count() == 0 );
+		REQUIRE( left[0] == 0.5 );
+	}
+
+	SECTION("A channel with a NaN or infinite sample is silenced and the vector counted") {
+		const auto value = GENERATE(std::numeric_limits<sample>::quiet_NaN(), std::numeric_limits<sample>::infinity(), -std::numeric_limits<sample>::infinity());
+		const auto index { (frame_count - 1) * bad_frame / 2 }; // first, middle and last frames
+		right[index] = value;
+
+		REQUIRE( output.channel(0).finite() );
+		REQUIRE( !output.channel(1).finite() );
+
+		REQUIRE( !perform_check_outputs(checker, output) );
+		REQUIRE( checker.nonfinite_count() == 1 );
+		REQUIRE( left == vector<sample>(frame_count, 0.5) );
+		REQUIRE( right == vector<sample>(frame_count, 0.0) );
+
+		checker.reset_nonfinite_count();
+		REQUIRE( checker.nonfinite_count() == 0 );
+	}
+}
+
+
+TEST_CASE("Decaying feedback benchmark", "[.][benchmark]") {
+	const long frame_count { 8192 };
+
+	BENCHMARK("decaying feedback") {
+		return decay(1e-300, frame_count);
+	};
+
+	BENCHMARK("decaying feedback (flushing denormals)") {
+		scoped_flush_denormals flush;
+		return decay(1e-300, frame_count);
+	};
+
+	vector<sample> samples(frame_count, 0.25);
+	sample_span	   channel { samples.data(), frame_count };
+
+	BENCHMARK("checking outputs") {
+		return channel.finite();
+	};
+}
@@ -0,0 +1,80 @@
+/// @file
+///	@ingroup 	minapi
+///	@copyright	Copyright 2018 The Min-API Authors. All rights reserved.
+///	@license	Use of this source code is governed by the MIT License found in the License.md file.
+#include "catch.hpp"
+#include "c74_min_api.h"
+
+using namespace c74::min;
+
+
+class typed_setup : public vector_operator<> {
+public:
+	void dspsetup(const double samplerate, const long vector_size) {
+		scratch.resize(vector_size);
+		one_over_samplerate = 1.0 / samplerate;
+	}
+
+	void operator()(audio_bundle input, audio_bundle output) {}
+
+	vector<sample> scratch;
+	double one_over_samplerate { 0.0 };
+};
+
+
+class connected_setup : public vector_operator<> {
+public:
+	void dspsetup(const double samplerate, const long vector_size, const signal_connections& connections) {
+		buffers.resize(connections.connected_inlet_count(), vector<sample>(vector_size));
+	}
+
+	void operator()(audio_bundle input, audio_bundle output) {}
+
+	vector<vector<sample>> buffers;
+};
+
+
+class no_setup : public vector_operator<> {
+public:
+	void operator()(audio_bundle input, audio_bundle output) {}
+};
+
+
+TEST_CASE("Typed dspsetup is detected at compile time", "[dspsetup]") {
+	REQUIRE( has_typed_dspsetup<typed_setup>::value );
+	REQUIRE( !has_typed_dspsetup_with_connections<typed_setup>::value );
+	REQUIRE( has_typed_dspsetup<connected_setup>::value );
+	REQUIRE( has_typed_dspsetup_with_connections<connected_setup>::value );
+	REQUIRE( !has_typed_dspsetup<no_setup>::value );
+}
+
+
+TEST_CASE("Typed dspsetup receives the audio settings and connections", "[dspsetup]") {
+	// two inlets, then three outlets
+	const short count[] { 1, 0, 2, 0, 1 };
+	const signal_connections connections { count, 2, 3 };
+
+	SECTION("Signal connections are counted for inlets and outlets") {
+		REQUIRE( connections.inlet_connections(0) == 1 );
+		REQUIRE( connections.inlet_connections(1) == 0 );
+		REQUIRE( connections.outlet_connections(0) == 2 );
+		REQUIRE( connections.outlet_connections(2) == 1 );
+		REQUIRE( connections.outlet_connections(3) == 0 );
+		REQUIRE( connections.connected_inlet_count() == 1 );
+		REQUIRE( connections.connected_outlet_count() == 2 );
+	}
+
+	SECTION("The samplerate and vector size are passed") {
+		typed_setup op;
+		call_typed_dspsetup(op, 48000.0, 128, connections);
+		REQUIRE( op.scratch.size() == 128 );
+		REQUIRE( op.one_over_samplerate == Approx(1.0 / 48000.0) );
+	}
+
+	SECTION("The signal connections are passed when asked for") {
+		connected_setup op;
+		call_typed_dspsetup(op, 48000.0, 64, connections);
+		REQUIRE( op.buffers.size() == 1 );
+		REQUIRE( op.buffers[0].size() == 64 );
+	}
+}
@@ -0,0 +1,98 @@
+/// @file
+///	@ingroup 	minapi
+///	@copyright	Copyright 2018 The Min-API Authors. All rights reserved.
+///	@license	Use of this source code is governed by the MIT License found in the License.md file.
+#include "catch.hpp"
+#include "c74_min_api.h"
+
+using namespace c74::min;
+
+
+class event_test_object : public object<event_test_object> {
+public:
+	event_outlet events { this, "(number) events", 4 };
+};
+
+
+// An event as it would be sent by the outlet, with the scheduler time at which it was taken.
+struct taken_event {
+	double time;
+	number value;
+	bool bang;
+};
+
+
+// Take the events of an outlet as the scheduler would: at each time the outlet asks to be called again.
+static vector<taken_event> take_all(event_outlet& an_outlet, double now) {
+	vector<taken_event> taken;
+
+	for (;;) {
+		const auto wait = an_outlet.take(now, [&taken, now](const auto& an_event) {
+			taken.push_back({ now, an_event.value, an_event.bang });
+		});
+		if (wait <= 0.0)
+			break;
+		now += wait;
+	}
+	return taken;
+}
+
+
+TEST_CASE("Event outlets", "[outlet]") {
+	event_test_object my_object;
+	auto& events { my_object.events };
+	double now;
+
+	events.prepare(1000.0); // one sample per millisecond
+	c74::max::clock_getftime(&now);
+
+	SECTION("Events keep the spacing of their offsets in the vector") {
+		events.send(1.0, 10);
+		events.send(2.0, 30);
+		events.send_bang(45);
+
+		const auto taken { take_all(events, now + 100.0) };
+		REQUIRE( taken.size() == 3 );
+		REQUIRE( taken[0].value == 1.0 );
+		REQUIRE( taken[1].value == 2.0 );
+		REQUIRE( taken[2].bang );
+		REQUIRE( taken[1].time - taken[0].time == Approx(20.0) );
+		REQUIRE( taken[2].time - taken[1].time == Approx(15.0) );
+	}
+
+	SECTION("The first event of a burst is sent straightaway") {
+		events.send(1.0, 10);
+		REQUIRE( events.take(now + 100.0, [](const auto&) {}) == 0.0 );
+	}
+
+	SECTION("Events of later vectors follow those of earlier vectors") {
+		events.send(1.0, 60);
+		events.advance(64);
+		events.send(2.0, 0);
+		events.send(3.0, 2);
+
+		const auto taken { take_all(events, now + 100.0) };
+		REQUIRE( taken.size() == 3 );
+		REQUIRE( taken[0].value == 1.0 );
+		REQUIRE( taken[1].value == 2.0 );
+		REQUIRE( taken[2].value == 3.0 );
+		REQUIRE( taken[1].time >= taken[0].time );
+		REQUIRE( taken[2].time - taken[1].time == Approx(2.0) );
+	}
+
+	SECTION("Events sent while the outlet is full are dropped and counted") {
+		for (auto i = 0; i < 6; ++i)
+			events.send(i, i);
+
+		const auto taken { take_all(events, now + 100.0) };
+		REQUIRE( taken.size() == 4 );
+		REQUIRE( taken.back().value == 3.0 );
+		REQUIRE( events.dropped() == 2 );
+	}
+
+	SECTION("Nothing is waiting once every event has been sent") {
+		events.send(1.0, 0);
+		take_all(events, now);
+		REQUIRE( events.take(now, [](const auto&) { FAIL("no event should be waiting"); }) == 0.0 );
+	}
+}
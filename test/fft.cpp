@@ -0,0 +1,171 @@
+/// @file
+///	@ingroup 	minapi
+///	@copyright	Copyright 2018 The Min-API Authors. All rights reserved.
+///	@license	Use of this source code is governed by the MIT License found in the License.md file.
+#include "catch.hpp"
+#include "c74_min_api.h"
+
+using namespace c74::min;
+
+
+// The discrete Fourier transform of a real signal, calculated directly.
+static vector<complex_sample> dft(const vector<sample>& input) {
+	const auto			   size { input.size() };
+	const auto			   pi { std::acos(-1.0) };
+	vector<complex_sample> bins(size / 2 + 1);
+
+	for (size_t k = 0; k < bins.size(); ++k) {
+		for (size_t n = 0; n < size; ++n)
+			bins[k] += input[n] * std::polar(1.0, -2.0 * pi * k * n / size);
+	}
+	return bins;
+}
+
+
+static vector<sample> noise(const size_t size) {
+	vector<sample> samples(size);
+	uint32_t	   seed { 12345 };
+	for (auto& x : samples) {
+		seed = seed * 1664525 + 1013904223;
+		x = seed / 4294967296.0 - 0.5;
+	}
+	return samples;
+}
+
+
+TEST_CASE("FFT of real signals", "[fft]") {
+	const size_t size = GENERATE(4, 8, 16, 32, 64, 128, 1024);
+	fft			 transform { size };
+	const auto	 input { noise(size) };
+
+	REQUIRE( transform.size() == size );
+	REQUIRE( transform.bin_count() == size / 2 + 1 );
+
+	SECTION("The forward transform matches the discrete Fourier transform") {
+		vector<complex_sample> bins(transform.bin_count());
+		transform.forward(input.data(), bins.data());
+
+		const auto expected { dft(input) };
+		for (size_t k = 0; k < bins.size(); ++k) {
+			REQUIRE( bins[k].real() == Approx(expected[k].real()).margin(1e-9) );
+			REQUIRE( bins[k].imag() == Approx(expected[k].imag()).margin(1e-9) );
+		}
+	}
+
+	SECTION("The inverse of the forward transform is the signal") {
+		vector<complex_sample> bins(transform.bin_count());
+		vector<sample>		   output(size);
+		transform.forward(input.data(), bins.data());
+		transform.inverse(bins.data(), output.data());
+
+		for (size_t i = 0; i < size; ++i)
+			REQUIRE( output[i] == Approx(input[i]).margin(1e-12) );
+	}
+}
+
+
+TEST_CASE("FFT sizes must be powers of two", "[fft]") {
+	fft transform;
+	REQUIRE( transform.size() == 0 );
+	REQUIRE( transform.bin_count() == 0 );
+
+	transform.resize(16);
+	REQUIRE( transform.size() == 16 );
+
+	// when the error does not throw, as in these tests, the size is left as it was
+	transform.resize(2);
+	REQUIRE( transform.size() == 16 );
+	transform.resize(48);
+	REQUIRE( transform.size() == 16 );
+}
+
+
+TEST_CASE("Short-time Fourier transform", "[fft]") {
+	const size_t fft_size { 64 };
+	const size_t overlap = GENERATE(2, 4, 8);
+	const long	 vector_size = GENERATE(1, 37, 64, 256);
+	const long	 frame_count { 1024 };
+
+	const auto	   left { noise(frame_count) };
+	vector<sample> right(frame_count);
+	for (auto i = 0; i < frame_count; ++i)
+		right[i] = -left[i];
+
+	size_t calls { 0 };
+	bool   silence { false };
+	stft   spectral { fft_size, overlap, 2, [&](spectrum bins, size_t channel) {
+		  ++calls;
+		  REQUIRE( bins.size() == fft_size / 2 + 1 );
+		  if (silence) {
+			  for (auto& bin : bins)
+				  bin = 0.0;
+		  }
+	} };
+
+	auto process = [&](vector<sample> in_left, vector<sample> in_right) {
+		for (long start = 0; start < frame_count; start += vector_size) {
+			double*		 samples[] { in_left.data() + start, in_right.data() + start };
+			audio_bundle bundle { samples, 2, std::min(vector_size, frame_count - start) };
+			spectral(bundle, bundle); // in place
+		}
+		return std::make_pair(in_left, in_right);
+	};
+
+	SECTION("Unmodified spectra give back the input, delayed by the latency") {
+		const auto output { process(left, right) };
+		REQUIRE( spectral.latency() == fft_size );
+
+		for (auto i = static_cast<long>(fft_size); i < frame_count; ++i) {
+			REQUIRE( output.first[i] == Approx(left[i - fft_size]).margin(1e-9) );
+			REQUIRE( output.second[i] == Approx(right[i - fft_size]).margin(1e-9) );
+		}
+		REQUIRE( calls == 2 * (frame_count / spectral.hop_size()) );
+	}
+
+	SECTION("The spectra are modified in place") {
+		silence = true;
+		const auto output { process(left, right) };
+		for (auto i = 0; i < frame_count; ++i)
+			REQUIRE( output.first[i] == 0.0 );
+	}
+
+	SECTION("Channels beyond those processed are silenced") {
+		spectral.resize(fft_size, overlap, 1);
+		const auto output { process(left, right) };
+		for (auto i = 0; i < frame_count; ++i)
+			REQUIRE( output.second[i] == 0.0 );
+		REQUIRE( output.first[frame_count - 1] == Approx(left[frame_count - 1 - fft_size]).margin(1e-9) );
+	}
+
+	SECTION("Sizes changed twice between vectors start again from silence with the last sizes") {
+		process(left, right);
+		spectral.resize(fft_size, overlap, 1);
+		spectral.resize(fft_size, overlap, 2);
+		REQUIRE( spectral.channel_count() == 2 );
+
+		const auto output { process(left, right) };
+		for (auto i = 0; i < static_cast<long>(fft_size); ++i) {
+			REQUIRE( output.first[i] == Approx(0.0).margin(1e-9) );
+			REQUIRE( output.second[i] == Approx(0.0).margin(1e-9) );
+		}
+		for (auto i = static_cast<long>(fft_size); i < frame_count; ++i) {
+			REQUIRE( output.first[i] == Approx(left[i - fft_size]).margin(1e-9) );
+			REQUIRE( output.second[i] == Approx(right[i - fft_size]).margin(1e-9) );
+		}
+	}
+}
+
+
+TEST_CASE("FFT benchmark", "[.][benchmark]") {
+	const size_t		   size { 1024 };
+	fft					   transform { size };
+	const auto			   input { noise(size) };
+	vector<complex_sample> bins(transform.bin_count());
+	vector<sample>		   output(size);
+
+	BENCHMARK("forward and inverse FFT of 1024 samples") {
+		transform.forward(input.data(), bins.data());
+		transform.inverse(bins.data(), output.data());
+		return output[0];
+	};
+}
@@ -0,0 +1,103 @@
+/// @file
+///	@ingroup 	minapi
+///	@copyright	Copyright 2018 The Min-API Authors. All rights reserved.
+///	@license	Use of this source code is governed by the MIT License found in the License.md file.
+#include "catch.hpp"
+#include "c74_min_api.h"
+
+using namespace c74::min;
+
+
+TEST_CASE("lockfree_queue ordering and overflow", "[lockfree_queue]") {
+	lockfree_queue<int> queue;
+	std::vector<int> popped;
+	auto read = [&popped](int& item) { popped.push_back(item); };
+
+	SECTION("An unconfigured queue drops everything") {
+		REQUIRE( queue.capacity() == 0 );
+		REQUIRE( !queue.push([](int& item) { item = 1; }) );
+		REQUIRE( queue.pop_all(read) == 0 );
+	}
+
+	SECTION("Items are popped in the order they were pushed") {
+		queue.configure(4);
+		for (auto i = 0; i < 3; ++i)
+			queue.push([i](int& item) { item = i; });
+		REQUIRE( queue.pop_all(read) == 3 );
+		REQUIRE( popped == std::vector<int>{ 0, 1, 2 } );
+	}
+
+	SECTION("Each slot is prepared once") {
+		lockfree_queue<atoms> lists;
+		lists.configure(4, overflow_policy::drop_newest, [](atoms& as) { as.reserve(16); });
+		lists.push([](atoms& as) { as.assign({ 1, 2, 3 }); });
+		lists.pop_all([](atoms& as) { REQUIRE( as.capacity() >= 16 ); });
+	}
+
+	SECTION("Dropping the newest items") {
+		queue.configure(2, overflow_policy::drop_newest);
+		for (auto i = 0; i < 5; ++i)
+			queue.push([i](int& item) { item = i; });
+		REQUIRE( queue.dropped() == 3 );
+		queue.pop_all(read);
+		REQUIRE( popped == std::vector<int>{ 0, 1 } );
+	}
+
+	SECTION("Dropping the oldest items") {
+		queue.configure(2, overflow_policy::drop_oldest);
+		for (auto i = 0; i < 5; ++i)
+			queue.push([i](int& item) { item = i; });
+		REQUIRE( queue.dropped() == 3 );
+		queue.pop_all(read);
+		REQUIRE( popped == std::vector<int>{ 3, 4 } );
+	}
+
+	SECTION("Growing keeps every item in order") {
+		queue.configure(2, overflow_policy::grow);
+		for (auto i = 0; i < 5; ++i)
+			queue.push([i](int& item) { item = i; });
+		REQUIRE( queue.dropped() == 0 );
+		REQUIRE( queue.pop_all(read) == 5 );
+		REQUIRE( popped == std::vector<int>{ 0, 1, 2, 3, 4 } );
+
+		queue.push([](int& item) { item = 5; });
+		queue.pop_all(read);
+		REQUIRE( popped.back() == 5 );
+	}
+}
+
+
+TEST_CASE("lockfree_queue with concurrent producers", "[lockfree_queue]") {
+	constexpr auto producers = 4;
+	constexpr auto items_per_producer = 10000;
+
+	lockfree_queue<std::pair<int, int>> queue;
+	queue.configure(64, overflow_policy::grow);
+
+	std::vector<int> last_seen(producers, -1);
+	bool in_order { true };
+	auto total { 0 };
+	auto read = [&](std::pair<int, int>& item) {
+		if (item.second != last_seen[item.first] + 1)
+			in_order = false;
+		last_seen[item.first] = item.second;
+		++total;
+	};
+
+	std::vector<std::thread> threads;
+	for (auto p = 0; p < producers; ++p) {
+		threads.emplace_back([&queue, p]() {
+			for (auto i = 0; i < items_per_producer; ++i)
+				queue.push([p, i](std::pair<int, int>& item) { item = { p, i }; });
+		});
+	}
+
+	while (total < producers * items_per_producer)
+		queue.pop_all(read);
+	for (auto& t : threads)
+		t.join();
+
+	REQUIRE( total == producers * items_per_producer );
+	REQUIRE( in_order );
+	REQUIRE( queue.dropped() == 0 );
+}
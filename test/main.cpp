@@ -37,3 +37,116 @@ TEST_CASE("Attribute - repetitions", "[attribute]") {
 		REQUIRE(static_cast<number>(my_attr) == 7.5);
 	}
 }
+
+TEST_CASE("Attribute - set from signals", "[attribute]") {
+	TestObject my_object;
+
+	SECTION("Threadsafe numeric attributes write the sample straight to their value") {
+		attribute<number, threadsafe::yes> my_attr {&my_object, "My Attribute", 1.0};
+		mapped_attribute mapped {1, &my_attr};
+
+		REQUIRE(my_attr.resolve_sample_setter() != nullptr);
+		REQUIRE(mapped.inlet() == 1);
+		REQUIRE(mapped.attribute() == &my_attr);
+
+		mapped.set(0.25);
+		REQUIRE(static_cast<number>(my_attr) == 0.25);
+	}
+
+	SECTION("The range limit is applied to each sample") {
+		attribute<number, threadsafe::yes, limit::clamp> my_attr {&my_object, "My Attribute", 0.0, range {-10.0, 10.0}};
+		mapped_attribute mapped {1, &my_attr};
+		const auto value = GENERATE(-100.0, 2.5, 11.5);
+
+		mapped.set(value);
+		REQUIRE(static_cast<number>(my_attr) == std::clamp(value, -10.0, 10.0));
+	}
+
+	SECTION("Integer attributes are truncated as when they are set with atoms") {
+		attribute<int, threadsafe::yes, limit::clamp> my_attr {&my_object, "My Attribute", 4, range {1, 16}};
+		mapped_attribute mapped {1, &my_attr};
+
+		mapped.set(7.9);
+		REQUIRE(static_cast<int>(my_attr) == 7);
+		mapped.set(100.0);
+		REQUIRE(static_cast<int>(my_attr) == 16);
+	}
+
+	SECTION("Samples outside the range of an integer type are limited before they are converted") {
+		attribute<int, threadsafe::yes, limit::clamp> clamped {&my_object, "Clamped", 4, range {1, 16}};
+		attribute<int, threadsafe::yes> unlimited {&my_object, "Unlimited", 4};
+		mapped_attribute mapped_clamped {1, &clamped};
+		mapped_attribute mapped_unlimited {2, &unlimited};
+
+		mapped_clamped.set(1e20);
+		REQUIRE(static_cast<int>(clamped) == 16);
+		mapped_clamped.set(-1e20);
+		REQUIRE(static_cast<int>(clamped) == 1);
+		mapped_unlimited.set(1e20);
+		REQUIRE(static_cast<int>(unlimited) == std::numeric_limits<int>::max());
+		mapped_unlimited.set(-1e20);
+		REQUIRE(static_cast<int>(unlimited) == std::numeric_limits<int>::lowest());
+	}
+
+	SECTION("NaN samples leave the value unchanged") {
+		attribute<int, threadsafe::yes, limit::clamp> my_attr {&my_object, "My Attribute", 4, range {1, 16}};
+		mapped_attribute mapped {1, &my_attr};
+
+		mapped.set(std::numeric_limits<double>::quiet_NaN());
+		REQUIRE(static_cast<int>(my_attr) == 4);
+	}
+
+	SECTION("Attributes that are not threadsafe are set on the main thread with the latest sample") {
+		attribute<number, threadsafe::no> my_attr {&my_object, "My Attribute", 1.0};
+		attribute<number> undefined_attr {&my_object, "Undefined", 1.0};
+		mapped_attribute mapped {1, &my_attr};
+
+		REQUIRE(my_attr.resolve_sample_setter() == nullptr);
+		REQUIRE(undefined_attr.resolve_sample_setter() == nullptr);
+		REQUIRE(undefined_attr.defers_set());
+
+		std::thread audio { [&mapped] {
+			mapped.set(0.25);
+			mapped.set(0.5);
+		} };
+		audio.join();
+		REQUIRE(static_cast<number>(my_attr) == 1.0);
+
+		mapped.apply_pending();
+		REQUIRE(static_cast<number>(my_attr) == 0.5);
+
+		my_attr = 2.0;
+		mapped.apply_pending(); // nothing new was stored
+		REQUIRE(static_cast<number>(my_attr) == 2.0);
+	}
+
+	SECTION("Attributes that are not threadsafe are set straightaway on the main thread") {
+		attribute<number, threadsafe::no> my_attr {&my_object, "My Attribute", 1.0};
+		mapped_attribute mapped {1, &my_attr};
+
+		mapped.set(0.25);
+		REQUIRE(static_cast<number>(my_attr) == 0.25);
+	}
+
+	SECTION("Attributes with a custom setter take the full path for each sample") {
+		int setter_calls {};
+		attribute<number> my_attr {&my_object, "My Attribute", 0.0,
+			setter { [&setter_calls](const atoms& args, const int inlet) -> atoms {
+				++setter_calls;
+				return { static_cast<double>(args[0]) * 2.0 };
+			}}
+		};
+		mapped_attribute mapped {1, &my_attr};
+		setter_calls = 0;
+
+		REQUIRE(my_attr.resolve_sample_setter() == nullptr);
+		mapped.set(0.5);
+		REQUIRE(setter_calls == 1);
+		REQUIRE(static_cast<number>(my_attr) == 1.0);
+	}
+
+	SECTION("Attributes that are not numbers are not set directly") {
+		attribute<symbol> my_attr {&my_object, "My Attribute", "none"};
+		REQUIRE(my_attr.resolve_sample_setter() == nullptr);
+	}
+}
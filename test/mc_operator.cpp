@@ -0,0 +1,266 @@
+/// @file
+///	@ingroup 	minapi
+///	@copyright	Copyright 2018 The Min-API Authors. All rights reserved.
+///	@license	Use of this source code is governed by the MIT License found in the License.md file.
+#include "catch.hpp"
+#include "c74_min_api.h"
+
+using namespace c74::min;
+
+
+class onepole : public mc_operator<>, public lane_processing {
+public:
+	template <class T>
+	T operator()(T x, size_t channel) {
+		auto& y1 = history.get<T>(channel);
+		y1 = y1 + (x - y1) * coefficient;
+		return y1;
+	}
+
+	channel_state history { this };
+	double coefficient { 0.1 };
+};
+
+
+class parallel_onepole : public onepole, public parallel_channels {
+public:
+	parallel_onepole(const size_t thread_count = default_thread_count(), const long minimum_samples = k_default_minimum_samples)
+	: parallel_channels { thread_count, minimum_samples } {
+		channel_workers().start();
+	}
+};
+
+
+// Reference: each channel processed on its own through the scalar instantiation of the call operator.
+template <class min_class_type>
+static void perform_channels_scalar(min_class_type& op, const double** in_chans, const long input_channels, double** out_chans, const long output_channels, const long sampleframes) {
+	for (auto channel = 0; channel < output_channels; ++channel) {
+		for (auto i = 0; i < sampleframes; ++i)
+			out_chans[channel][i] = op(in_chans[channel % input_channels][i], channel);
+	}
+}
+
+
+// Compile the audio for a number of channels, and let the audio thread switch to them.
+static void compile_channels(mc_operator_base& op, const long channel_count) {
+	op.update_input_channel_count(0, channel_count);
+	op.prepare_channels();
+	op.update_channels();
+}
+
+
+struct multichannel_signal {
+	multichannel_signal(const long channel_count, const long frame_count)
+	: storage(channel_count, vector<sample>(frame_count, 0.0)) {
+		for (auto& channel : storage)
+			pointers.push_back(channel.data());
+	}
+
+	vector<vector<sample>> storage;
+	vector<double*> pointers;
+};
+
+
+TEST_CASE("MC channel negotiation", "[mc_operator]") {
+	onepole op;
+
+	SECTION("The output follows the widest input") {
+		REQUIRE( op.channel_count() == 1 );
+		REQUIRE( op.update_input_channel_count(0, 4) );
+		REQUIRE( op.channel_count() == 4 );
+		REQUIRE( op.update_input_channel_count(1, 16) );
+		REQUIRE( op.channel_count() == 16 );
+		REQUIRE( !op.update_input_channel_count(0, 8) );
+		REQUIRE( op.input_channel_count(0) == 8 );
+		REQUIRE( op.input_channel_count(2) == 0 );
+		REQUIRE( op.update_input_channel_count(1, 0) );
+		REQUIRE( op.channel_count() == 8 );
+	}
+
+	SECTION("Channel state is only prepared when the audio is compiled") {
+		op.update_channels();
+		REQUIRE( op.history.size() == 0 );
+		REQUIRE( op.compiled_channel_count() == 0 );
+
+		compile_channels(op, 1);
+		REQUIRE( op.history.size() == 1 );
+		REQUIRE( op.history[0] == 0.0 );
+	}
+
+	SECTION("Channel state is resized, keeping the existing channels") {
+		compile_channels(op, 1);
+		REQUIRE( op.history.size() == 1 );
+		op.history.fill(0.5);
+
+		compile_channels(op, 13);
+		REQUIRE( op.history.size() == 13 );
+		REQUIRE( op.compiled_channel_count() == 13 );
+		REQUIRE( op.history[0] == 0.5 );
+		REQUIRE( op.history[12] == 0.0 );
+
+		compile_channels(op, 3);
+		REQUIRE( op.history.size() == 3 );
+		REQUIRE( op.history[0] == 0.5 );
+	}
+
+	SECTION("The audio thread keeps its channels until it switches at the start of a vector") {
+		compile_channels(op, 4);
+		op.history.fill(0.25);
+
+		op.update_input_channel_count(0, 16);
+		op.prepare_channels();
+		REQUIRE( op.channel_count() == 16 );
+		REQUIRE( op.compiled_channel_count() == 4 );
+		REQUIRE( op.history.size() == 4 );
+
+		op.update_channels();
+		REQUIRE( op.compiled_channel_count() == 16 );
+		REQUIRE( op.history.size() == 16 );
+		REQUIRE( op.history[3] == 0.25 );
+		REQUIRE( op.history[4] == 0.0 );
+	}
+
+	SECTION("Channels prepared twice before the audio thread switches are replaced") {
+		compile_channels(op, 4);
+
+		op.update_input_channel_count(0, 32);
+		op.prepare_channels();
+		op.update_input_channel_count(0, 8);
+		op.prepare_channels();
+		op.update_channels();
+		REQUIRE( op.compiled_channel_count() == 8 );
+		REQUIRE( op.history.size() == 8 );
+	}
+
+	SECTION("Packs of channel state are aligned") {
+		compile_channels(op, 32);
+		const auto address = reinterpret_cast<std::uintptr_t>(&op.history.get<sample_lanes<k_sample_lanes>>(k_sample_lanes));
+		REQUIRE( address % alignof(sample_lanes<k_sample_lanes>) == 0 );
+	}
+}
+
+
+TEST_CASE("MC lane processing matches processing each channel on its own", "[mc_operator]") {
+	const long sampleframes { 67 };
+	const long output_channels = GENERATE(1, 3, 8, 13);
+	const long input_channels = GENERATE(1, 5, 13);
+
+	multichannel_signal in { input_channels, sampleframes };
+	for (auto channel = 0; channel < input_channels; ++channel) {
+		for (auto i = 0; i < sampleframes; ++i)
+			in.storage[channel][i] = std::sin(channel + i * 0.1);
+	}
+	multichannel_signal expected { output_channels, sampleframes };
+	multichannel_signal actual { output_channels, sampleframes };
+	auto in_chans = const_cast<const double**>(in.pointers.data());
+
+	onepole reference_op;
+	onepole op;
+	compile_channels(reference_op, output_channels);
+	compile_channels(op, output_channels);
+
+	perform_channels_scalar(reference_op, in_chans, input_channels, expected.pointers.data(), output_channels, sampleframes);
+	perform_channel_lanes(op, in_chans, input_channels, actual.pointers.data(), output_channels, sampleframes);
+
+	for (auto channel = 0; channel < output_channels; ++channel) {
+		for (auto i = 0; i < sampleframes; ++i)
+			REQUIRE( actual.storage[channel][i] == Approx(expected.storage[channel][i]) );
+	}
+}
+
+
+TEST_CASE("MC parallel processing matches processing each channel on its own", "[mc_operator]") {
+	const long sampleframes { 64 };
+	const long output_channels = GENERATE(3, 16, 67);
+	const long input_channels { 16 };
+
+	multichannel_signal in { input_channels, sampleframes };
+	for (auto channel = 0; channel < input_channels; ++channel) {
+		for (auto i = 0; i < sampleframes; ++i)
+			in.storage[channel][i] = std::sin(channel + i * 0.1);
+	}
+	multichannel_signal expected { output_channels, sampleframes };
+	multichannel_signal actual { output_channels, sampleframes };
+	auto in_chans = const_cast<const double**>(in.pointers.data());
+
+	onepole reference_op;
+	parallel_onepole op { 3, 0 };
+	compile_channels(reference_op, output_channels);
+	compile_channels(op, output_channels);
+
+	for (auto vector = 0; vector < 10; ++vector) {
+		perform_channels_scalar(reference_op, in_chans, input_channels, expected.pointers.data(), output_channels, sampleframes);
+		perform_channel_lanes_parallel(op, in_chans, input_channels, actual.pointers.data(), output_channels, sampleframes);
+
+		for (auto channel = 0; channel < output_channels; ++channel) {
+			for (auto i = 0; i < sampleframes; ++i)
+				REQUIRE( actual.storage[channel][i] == Approx(expected.storage[channel][i]) );
+		}
+	}
+}
+
+
+TEST_CASE("MC parallel objects share their worker threads", "[mc_operator]") {
+	parallel_onepole first { 2, 0 };
+	parallel_onepole second { 2, 0 };
+	parallel_onepole other { 1, 0 };
+
+	REQUIRE( &first.channel_workers() == &second.channel_workers() );
+	REQUIRE( &first.channel_workers() != &other.channel_workers() );
+	REQUIRE( first.channel_workers().thread_count() == 2 );
+}
+
+
+TEST_CASE("MC lane processing benchmark", "[.][benchmark]") {
+	const long sampleframes { 64 };
+	const long channels { 128 };
+
+	multichannel_signal in { channels, sampleframes };
+	for (auto channel = 0; channel < channels; ++channel) {
+		for (auto i = 0; i < sampleframes; ++i)
+			in.storage[channel][i] = std::sin(channel + i * 0.1);
+	}
+	multichannel_signal out { channels, sampleframes };
+	auto in_chans = const_cast<const double**>(in.pointers.data());
+
+	onepole op;
+	compile_channels(op, channels);
+
+	BENCHMARK("128 channels (scalar)") {
+		perform_channels_scalar(op, in_chans, channels, out.pointers.data(), channels, sampleframes);
+		return out.storage[channels - 1][sampleframes - 1];
+	};
+
+	BENCHMARK("128 channels (lanes)") {
+		perform_channel_lanes(op, in_chans, channels, out.pointers.data(), channels, sampleframes);
+		return out.storage[channels - 1][sampleframes - 1];
+	};
+}
+
+
+TEST_CASE("MC parallel processing benchmark", "[.][benchmark]") {
+	const long sampleframes { 64 };
+	const long channels = GENERATE(16, 64, 256, 1024);
+
+	multichannel_signal in { channels, sampleframes };
+	for (auto channel = 0; channel < channels; ++channel) {
+		for (auto i = 0; i < sampleframes; ++i)
+			in.storage[channel][i] = std::sin(channel + i * 0.1);
+	}
+	multichannel_signal out { channels, sampleframes };
+	auto in_chans = const_cast<const double**>(in.pointers.data());
+
+	parallel_onepole op { parallel_channels::default_thread_count(), 0 };
+	compile_channels(op, channels);
+	const auto name = std::to_string(channels) + " channels, " + std::to_string(op.channel_workers().thread_count()) + " workers";
+
+	BENCHMARK(name + " (audio thread)") {
+		perform_channel_lanes(op, in_chans, channels, out.pointers.data(), channels, sampleframes);
+		return out.storage[channels - 1][sampleframes - 1];
+	};
+
+	BENCHMARK(name + " (parallel)") {
+		perform_channel_lanes_parallel(op, in_chans, channels, out.pointers.data(), channels, sampleframes);
+		return out.storage[channels - 1][sampleframes - 1];
+	};
+}
@@ -0,0 +1,281 @@
+/// @file
+///	@ingroup 	minapi
+///	@copyright	Copyright 2018 The Min-API Authors. All rights reserved.
+///	@license	Use of this source code is governed by the MIT License found in the License.md file.
+#include "catch.hpp"
+#include "c74_min_api.h"
+
+using namespace c74::min;
+
+
+class dispatch_object : public object<dispatch_object> {
+public:
+	message<> bang { this, "bang", MIN_FUNCTION { ++bangs; return {}; } };
+	message<> number { this, "number", MIN_FUNCTION { value = args[0]; return {}; } };
+	message<> foo { this, "foo", MIN_FUNCTION { ++foos; return {}; } };
+	message<> bar { this, "bar", MIN_FUNCTION { return {}; } };
+
+	int bangs {};
+	int foos {};
+	double value {};
+};
+
+using dispatch = message_dispatch<dispatch_object>;
+
+
+TEST_CASE("Message dispatch resolves selectors to the messages of each instance", "[message]") {
+	dispatch_object prototype;
+	dispatch::build(prototype);
+	dispatch::resolve<wrapper_message_name_bang>();
+	dispatch::resolve<wrapper_message_name_float>();
+
+	dispatch_object instance;
+
+	SECTION("Selectors find the message of the instance receiving them, not the prototype") {
+		REQUIRE( dispatch::find(instance, symbol("foo")) == &instance.foo );
+		REQUIRE( dispatch::find(instance, symbol("bar")) == &instance.bar );
+		REQUIRE( dispatch::find(prototype, symbol("foo")) == &prototype.foo );
+	}
+
+	SECTION("Wrapper name types resolve to the renamed messages") {
+		REQUIRE( dispatch::find<wrapper_message_name_bang>(instance) == &instance.bang );
+		REQUIRE( dispatch::find<wrapper_message_name_float>(instance) == &instance.number );
+	}
+
+	SECTION("Calling through the dispatch reaches the instance") {
+		(*dispatch::find(instance, symbol("foo")))();
+		(*dispatch::find<wrapper_message_name_float>(instance))(atoms{ 3.5 });
+		REQUIRE( instance.foos == 1 );
+		REQUIRE( instance.value == 3.5 );
+		REQUIRE( prototype.foos == 0 );
+	}
+
+	SECTION("Unknown selectors are not found") {
+		REQUIRE( dispatch::find(instance, symbol("nothing_by_this_name")) == nullptr );
+	}
+
+	SECTION("Messages that an instance has not constructed are not found at their recorded position") {
+		alignas(dispatch_object) unsigned char storage[sizeof(dispatch_object)] {};
+		auto& unconstructed = *reinterpret_cast<dispatch_object*>(storage);
+
+		REQUIRE( dispatch::find(unconstructed, symbol("foo")) == nullptr );
+		REQUIRE( dispatch::find<wrapper_message_name_bang>(unconstructed) == nullptr );
+	}
+
+	SECTION("Messages living outside the instance fall back to the name lookup") {
+		auto extra = std::make_unique<message<>>(&instance, "extra", [](const atoms&, const int) -> atoms { return {}; });
+		REQUIRE( dispatch::find(instance, symbol("extra")) == extra.get() );
+	}
+}
+
+
+TEST_CASE("Message dispatch benchmark", "[.][benchmark]") {
+	dispatch_object instance;
+	dispatch::build(instance);
+	dispatch::resolve<wrapper_message_name_bang>();
+
+	symbol foo { "foo" };
+	const c74::max::t_symbol* foo_selector { foo };
+
+	BENCHMARK("string lookup (selector)") {
+		return instance.messages()[foo_selector->s_name];
+	};
+
+	BENCHMARK("dispatch table (selector)") {
+		return dispatch::find(instance, foo_selector);
+	};
+
+	BENCHMARK("string lookup (bang)") {
+		return instance.messages()[wrapper_message_name_bang::name];
+	};
+
+	BENCHMARK("dispatch slot (bang)") {
+		return dispatch::find<wrapper_message_name_bang>(instance);
+	};
+}
+
+
+class number_object : public object<number_object> {
+public:
+	message<> number { this, "number", MIN_NUMBER_FUNCTION { last_value = value; ++calls; } };
+	message<> bar { this, "bar", MIN_FUNCTION { received = args; return {}; } };
+
+	c74::min::number last_value {};
+	int calls {};
+	atoms received;
+};
+
+
+TEST_CASE("Messages receiving a single number", "[message]") {
+	number_object my_object;
+
+	SECTION("A number function is called directly with the value") {
+		REQUIRE( my_object.number.has_number_function() );
+		my_object.number.call_number(0.25);
+		REQUIRE( my_object.last_value == 0.25 );
+		REQUIRE( my_object.calls == 1 );
+	}
+
+	SECTION("Calling a number function with atoms passes the first atom") {
+		my_object.number(atoms{ 7, 8 });
+		REQUIRE( my_object.last_value == 7.0 );
+		REQUIRE( my_object.calls == 1 );
+	}
+
+	SECTION("Messages without a number function receive the number as an atom") {
+		REQUIRE( !my_object.bar.has_number_function() );
+		my_object.bar.call_number(1.5);
+		REQUIRE( my_object.received.size() == 1 );
+		REQUIRE( double(my_object.received[0]) == 1.5 );
+	}
+
+	SECTION("Number functions keep the message type of every threadsafety") {
+		auto function = [](const c74::min::number value, const int inlet) {};
+		message<> undefined_message { &my_object, "position", function, "", message_type::float_optional };
+		message<threadsafe::no> unsafe_message { &my_object, "position", function, "", message_type::float_optional };
+		message<threadsafe::yes> safe_message { &my_object, "position", function, "", message_type::float_optional };
+
+		REQUIRE( message_type(undefined_message) == message_type::float_optional );
+		REQUIRE( message_type(unsafe_message) == message_type::float_optional );
+		REQUIRE( message_type(safe_message) == message_type::float_optional );
+	}
+
+	SECTION("Messages without a number function receive integers with their full precision") {
+		const t_atom_long large { (t_atom_long(1) << 60) + 1 };
+
+		my_object.bar.call_number(atom{ large });
+		REQUIRE( my_object.received.size() == 1 );
+		REQUIRE( my_object.received[0].a_type == c74::max::A_LONG );
+		REQUIRE( t_atom_long(my_object.received[0]) == large );
+	}
+}
+
+
+class reference_object : public object<reference_object> {
+public:
+	message<> list { this, "list",
+		MIN_REFERENCE_FUNCTION {
+			first_address = &args[0];
+			count = args.size();
+			sum = 0;
+			for (auto i = 0; i < args.size(); ++i)
+				sum += static_cast<double>(args[i]);
+			return {};
+		}
+	};
+
+	const c74::max::t_atom* first_address {};
+	long count {};
+	double sum {};
+};
+
+
+TEST_CASE("Messages receiving their arguments by reference", "[message]") {
+	reference_object my_object;
+	c74::max::t_atom raw[3];
+
+	c74::max::atom_setlong(raw + 0, 1);
+	c74::max::atom_setfloat(raw + 1, 2.5);
+	c74::max::atom_setlong(raw + 2, 3);
+
+	SECTION("The arguments are not copied") {
+		REQUIRE( my_object.list.has_reference_function() );
+		my_object.list.call_reference(atom_reference(3, raw));
+		REQUIRE( my_object.first_address == raw );
+		REQUIRE( my_object.count == 3 );
+		REQUIRE( my_object.sum == 6.5 );
+	}
+
+	SECTION("Calling with atoms passes a reference to those atoms") {
+		atoms as { 4, 5 };
+		my_object.list(as);
+		REQUIRE( my_object.first_address == &as[0] );
+		REQUIRE( my_object.sum == 9.0 );
+	}
+
+	SECTION("Reference functions keep the message type of every threadsafety") {
+		auto function = [](const atom_reference& args, const int inlet) -> atoms { return {}; };
+		message<> undefined_message { &my_object, "values", function, "", message_type::float_optional };
+		message<threadsafe::no> unsafe_message { &my_object, "values", function, "", message_type::float_optional };
+		message<threadsafe::yes> safe_message { &my_object, "values", function, "", message_type::float_optional };
+
+		REQUIRE( message_type(undefined_message) == message_type::float_optional );
+		REQUIRE( message_type(unsafe_message) == message_type::float_optional );
+		REQUIRE( message_type(safe_message) == message_type::float_optional );
+	}
+}
+
+
+class deferring_object : public object<deferring_object> {
+public:
+	message<> list { this, "list", MIN_FUNCTION { received.push_back(args); return {}; } };
+
+	std::vector<atoms> received;
+};
+
+
+TEST_CASE("Deferred message queue", "[message]") {
+	deferring_object my_object;
+	auto& queue { my_object.deferred_messages() };
+
+	SECTION("Creating a message prepares the queue with the default capacity") {
+		REQUIRE( queue.capacity() == deferred_message_queue::k_default_capacity );
+		REQUIRE( queue.policy() == overflow_policy::drop_oldest );
+	}
+
+	SECTION("The capacity is rounded up to a power of two") {
+		queue.configure(5, overflow_policy::drop_newest);
+		REQUIRE( queue.capacity() == 8 );
+		REQUIRE( queue.policy() == overflow_policy::drop_newest );
+	}
+
+	SECTION("Queued calls are made in order by a single drain") {
+		queue.push(&my_object.list, { 1, 2 }, 0);
+		queue.push(&my_object.list, { 3 }, 1);
+		REQUIRE( my_object.received.empty() );
+
+		queue.drain();
+		REQUIRE( my_object.received.size() == 2 );
+		REQUIRE( my_object.received[0] == atoms{ 1, 2 } );
+		REQUIRE( my_object.received[1] == atoms{ 3 } );
+	}
+
+	SECTION("Dropping the newest calls when full") {
+		queue.configure(2, overflow_policy::drop_newest);
+		for (auto i = 0; i < 5; ++i)
+			queue.push(&my_object.list, { i }, 0);
+		REQUIRE( queue.dropped() == 3 );
+
+		queue.drain();
+		REQUIRE( my_object.received.size() == 2 );
+		REQUIRE( my_object.received[0] == atoms{ 0 } );
+		REQUIRE( my_object.received[1] == atoms{ 1 } );
+
+		queue.reset_dropped();
+		REQUIRE( queue.dropped() == 0 );
+	}
+
+	SECTION("Dropping the oldest calls when full") {
+		queue.configure(2, overflow_policy::drop_oldest);
+		for (auto i = 0; i < 5; ++i)
+			queue.push(&my_object.list, { i }, 0);
+		REQUIRE( queue.dropped() == 3 );
+
+		queue.drain();
+		REQUIRE( my_object.received.size() == 2 );
+		REQUIRE( my_object.received[0] == atoms{ 3 } );
+		REQUIRE( my_object.received[1] == atoms{ 4 } );
+	}
+
+	SECTION("Growing keeps every call in order") {
+		queue.configure(2, overflow_policy::grow);
+		for (auto i = 0; i < 5; ++i)
+			queue.push(&my_object.list, { i }, 0);
+		REQUIRE( queue.dropped() == 0 );
+
+		queue.drain();
+		REQUIRE( my_object.received.size() == 5 );
+		for (auto i = 0; i < 5; ++i)
+			REQUIRE( my_object.received[i] == atoms{ i } );
+	}
+}
@@ -0,0 +1,142 @@
+/// @file
+///	@ingroup 	minapi
+///	@copyright	Copyright 2018 The Min-API Authors. All rights reserved.
+///	@license	Use of this source code is governed by the MIT License found in the License.md file.
+#include "catch.hpp"
+#include "c74_min_api.h"
+
+using namespace c74::min;
+
+
+// The values an outlet queue would send on the right thread, taken without sending them.
+template <class queue_type>
+static vector<atoms> take_values(queue_type& queue) {
+	vector<atoms> values;
+	queue.take([&values](const queued_outlet_value& value) {
+		if (value.type == message_type::int_argument)
+			values.push_back({ atom(value.int_value) });
+		else if (value.type == message_type::float_argument)
+			values.push_back({ atom(value.float_value) });
+		else
+			values.push_back(value.list);
+	});
+	return values;
+}
+
+
+TEST_CASE("Outlet queues", "[outlet]") {
+	const atoms list { 1, 2.5, "three" };
+
+	SECTION("A first queue keeps the first value until it is sent") {
+		outlet_queue<thread_check::main, thread_action::first> queue { nullptr, 3 };
+		queue.push(t_atom_long(1));
+		queue.push(2.5);
+		REQUIRE( take_values(queue) == vector<atoms> { { 1 } } );
+		REQUIRE( take_values(queue).empty() );
+
+		queue.push(list);
+		REQUIRE( take_values(queue) == vector<atoms> { list } );
+	}
+
+	SECTION("A last queue keeps the last value until it is sent") {
+		outlet_queue<thread_check::main, thread_action::last> queue { nullptr, 3 };
+		queue.push(t_atom_long(1));
+		queue.push(list);
+		queue.push(2.5);
+		REQUIRE( take_values(queue) == vector<atoms> { { 2.5 } } );
+		REQUIRE( take_values(queue).empty() );
+	}
+
+	SECTION("A fifo queue keeps every value in order") {
+		outlet_queue<thread_check::main, thread_action::fifo> queue { nullptr, 3 };
+		queue.push(t_atom_long(1));
+		queue.push(list);
+		queue.push(2.5);
+		REQUIRE( take_values(queue) == vector<atoms> { { 1 }, list, { 2.5 } } );
+		REQUIRE( take_values(queue).empty() );
+	}
+
+	SECTION("A full fifo queue drops new values and counts them") {
+		outlet_queue<thread_check::main, thread_action::fifo> queue { nullptr };
+		for (auto i = 0; i < 300; ++i)
+			queue.push(t_atom_long(i));
+
+		const auto values { take_values(queue) };
+		REQUIRE( values.size() == outlet_queue<thread_check::main, thread_action::fifo>::k_default_capacity );
+		REQUIRE( values.back() == atoms { 255 } );
+		REQUIRE( queue.dropped() == 300 - values.size() );
+	}
+
+	SECTION("A last queue written by several threads at once sends a whole value, and the last one once they are done") {
+		outlet_queue<thread_check::main, thread_action::last> queue { nullptr, 3 };
+		std::atomic<bool> writing { true };
+		std::atomic<int>  torn { 0 };
+		vector<std::thread> writers;
+
+		for (auto writer = 0; writer < 3; ++writer) {
+			writers.emplace_back([&queue, writer] {
+				for (auto i = 0; i < 20000; ++i)
+					queue.push(atoms { writer, i, writer * i });
+			});
+		}
+
+		std::thread reader { [&] {
+			while (writing) {
+				for (const auto& value : take_values(queue)) {
+					if (static_cast<int>(value[2]) != static_cast<int>(value[0]) * static_cast<int>(value[1]))
+						++torn;
+				}
+			}
+		} };
+
+		for (auto& writer : writers)
+			writer.join();
+		writing = false;
+		reader.join();
+		REQUIRE( torn == 0 );
+
+		queue.push(atoms { 7, 8, 9 });
+		REQUIRE( take_values(queue) == vector<atoms> { { 7, 8, 9 } } );
+	}
+}
+
+
+class outlet_test_object : public object<outlet_test_object> {
+public:
+	outlet<thread_check::scheduler, thread_action::first> first_values { this, "first" };
+	outlet<thread_check::scheduler, thread_action::last> last_values { this, "last" };
+	outlet<thread_check::scheduler, thread_action::fifo> all_values { this, "all" };
+};
+
+
+TEST_CASE("Outlets queue values sent from other threads", "[outlet]") {
+	outlet_test_object my_object;
+	const symbol	   note { "note" };
+	bool			   queued { false };
+
+	std::thread sender { [&] {
+		queued = !outlet_call_is_safe<thread_check::scheduler>();
+		if (!queued)
+			return; // the sends would go straight out
+
+		my_object.first_values.send(1, 2.5, "three");
+		my_object.first_values.send(4);
+
+		my_object.last_values.send(4);
+		my_object.last_values.send_message(note, 60, 100);
+
+		my_object.all_values.send(1, 2.5, "three");
+		my_object.all_values.send_message(note, 60, 100);
+		my_object.all_values.send(4.5);
+	} };
+	sender.join();
+
+	if (!queued) {
+		WARN( "The sending thread is taken to be the scheduler, so nothing is queued." );
+		return;
+	}
+
+	REQUIRE( take_values(my_object.first_values.queue_storage()) == vector<atoms> { { 1, 2.5, "three" } } );
+	REQUIRE( take_values(my_object.last_values.queue_storage()) == vector<atoms> { { note, 60, 100 } } );
+	REQUIRE( take_values(my_object.all_values.queue_storage()) == vector<atoms> { { 1, 2.5, "three" }, { note, 60, 100 }, { 4.5 } } );
+}
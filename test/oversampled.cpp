@@ -0,0 +1,188 @@
+/// @file
+///	@ingroup 	minapi
+///	@copyright	Copyright 2018 The Min-API Authors. All rights reserved.
+///	@license	Use of this source code is governed by the MIT License found in the License.md file.
+#include "catch.hpp"
+#include "c74_min_api.h"
+
+using namespace c74::min;
+
+
+template <size_t factor>
+class oversampled_identity : public oversampled<factor, sample_operator<1, 1>> {
+public:
+	sample operator()(sample x) {
+		return x;
+	}
+};
+
+
+// Ignores its input and makes a sine wave at the oversampled samplerate.
+class oversampled_oscillator : public oversampled<2, sample_operator<1, 1>> {
+public:
+	sample operator()(sample) {
+		const auto value { std::sin(m_phase) };
+		m_phase += 2.0 * detail::k_pi * m_frequency / samplerate();
+		return value;
+	}
+
+	double m_frequency { 0.0 };
+	double m_phase { 0.0 };
+};
+
+
+// Process a signal with an oversampled operator in vectors, as the performer does.
+template <class T>
+static vector<sample> process(T& op, const vector<sample>& input, const long vector_size) {
+	vector<sample> output(input.size());
+
+	for (size_t start = 0; start < input.size(); start += vector_size) {
+		const double* ins[] { input.data() + start };
+		double*		  outs[] { output.data() + start };
+
+		op.perform_oversampled(ins, 1, outs, 1, vector_size, [&](const double** oversampled_ins, double** oversampled_outs, const long frame_count) {
+			for (auto i = 0; i < frame_count; ++i) {
+				op.frame(i);
+				oversampled_outs[0][i] = op(oversampled_ins[0][i]);
+			}
+		});
+	}
+	return output;
+}
+
+
+static vector<sample> sine(const double frequency, const double samplerate, const size_t frame_count) {
+	vector<sample> samples(frame_count);
+	for (size_t i = 0; i < frame_count; ++i)
+		samples[i] = std::sin(2.0 * detail::k_pi * frequency * i / samplerate);
+	return samples;
+}
+
+
+static sample rms(const vector<sample>& samples, const size_t start) {
+	sample sum { 0.0 };
+	for (auto i = start; i < samples.size(); ++i)
+		sum += samples[i] * samples[i];
+	return std::sqrt(sum / (samples.size() - start));
+}
+
+
+TEST_CASE("Half-band coefficients", "[oversampled]") {
+	// the center coefficient of 0.5 and those on both sides add up to a gain of one at DC
+	sample sum { 0.0 };
+	for (auto coefficient : k_halfband_steep)
+		sum += 2.0 * coefficient;
+	REQUIRE( sum + 0.5 == Approx(1.0) );
+	REQUIRE( k_halfband_steep[0] > 0.0 );
+	REQUIRE( k_halfband_steep[1] < 0.0 );
+	REQUIRE( std::abs(k_halfband_steep.back()) < 0.001 );
+}
+
+
+TEST_CASE("Oversampled operators", "[oversampled]") {
+	const long vector_size { 64 };
+
+	SECTION("The call operator sees the oversampled samplerate and vector size") {
+		oversampled_identity<4> op;
+		op.samplerate(44100.0);
+		op.vector_size(vector_size);
+
+		REQUIRE( op.samplerate() == 4 * 44100.0 );
+		REQUIRE( op.vector_size() == 4 * vector_size );
+		REQUIRE( oversampled_identity<4>::oversampling_factor() == 4 );
+	}
+
+	SECTION("An identity passes audio through, delayed by the latency") {
+		oversampled_identity<2> op;
+		op.samplerate(44100.0);
+		op.vector_size(vector_size);
+		op.prepare_oversampling();
+
+		REQUIRE( oversampled_identity<2>::latency() == 31.0 );
+
+		const auto input { sine(1000.0, 44100.0, 4096) };
+		const auto output { process(op, input, vector_size) };
+		for (auto i = 100; i < 4096; ++i)
+			REQUIRE( output[i] == Approx(input[i - 31]).margin(0.001) );
+	}
+
+	SECTION("The passband is kept at higher factors") {
+		const auto frequency = GENERATE(100.0, 5000.0, 18000.0);
+		const auto input { sine(frequency, 44100.0, 8192) };
+
+		oversampled_identity<4> op4;
+		op4.samplerate(44100.0);
+		op4.vector_size(vector_size);
+		op4.prepare_oversampling();
+		REQUIRE( rms(process(op4, input, vector_size), 1024) == Approx(rms(input, 1024)).epsilon(0.01) );
+
+		oversampled_identity<8> op8;
+		op8.samplerate(44100.0);
+		op8.vector_size(vector_size);
+		op8.prepare_oversampling();
+		REQUIRE( rms(process(op8, input, vector_size), 1024) == Approx(rms(input, 1024)).epsilon(0.01) );
+	}
+
+	SECTION("Frequencies above the Nyquist frequency are filtered out rather than aliased") {
+		oversampled_oscillator op;
+		op.samplerate(44100.0);
+		op.vector_size(vector_size);
+		op.prepare_oversampling();
+		op.m_frequency = 30000.0; // would alias to 14100 Hz
+
+		const auto output { process(op, vector<sample>(8192, 0.0), vector_size) };
+		REQUIRE( rms(output, 1024) < 0.001 ); // -60 dB
+	}
+
+	SECTION("Preparing for a new vector size carries the filters over, without a click") {
+		const auto input { sine(1000.0, 44100.0, 4096) };
+
+		oversampled_identity<2> reference;
+		reference.samplerate(44100.0);
+		reference.vector_size(vector_size);
+		reference.prepare_oversampling();
+		const auto expected { process(reference, input, vector_size) };
+
+		oversampled_identity<2> op;
+		op.samplerate(44100.0);
+		op.vector_size(vector_size);
+		op.prepare_oversampling();
+		const auto first { process(op, vector<sample>(input.begin(), input.begin() + 2048), vector_size) };
+
+		// the audio thread keeps the previous filters until its next vector
+		op.vector_size(2 * vector_size);
+		op.prepare_oversampling();
+		op.prepare_oversampling();
+		const auto second { process(op, vector<sample>(input.begin() + 2048, input.end()), 2 * vector_size) };
+
+		for (auto i = 0; i < 2048; ++i) {
+			REQUIRE( first[i] == Approx(expected[i]).margin(1e-12) );
+			REQUIRE( second[i] == Approx(expected[2048 + i]).margin(1e-12) );
+		}
+	}
+
+	SECTION("Vectors larger than were prepared for are silenced") {
+		oversampled_identity<2> op;
+		op.samplerate(44100.0);
+		op.vector_size(16);
+		op.prepare_oversampling();
+
+		const auto output { process(op, vector<sample>(64, 1.0), 64) };
+		REQUIRE( output == vector<sample>(64, 0.0) );
+	}
+}
+
+
+TEST_CASE("Oversampling benchmark", "[.][benchmark]") {
+	const long vector_size { 512 };
+	const auto input { sine(1000.0, 44100.0, vector_size) };
+
+	oversampled_identity<4> op;
+	op.samplerate(44100.0);
+	op.vector_size(vector_size);
+	op.prepare_oversampling();
+
+	BENCHMARK("4x oversampling of a vector") {
+		return process(op, input, vector_size)[0];
+	};
+}
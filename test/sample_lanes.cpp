@@ -0,0 +1,192 @@
+/// @file
+///	@ingroup 	minapi
+///	@copyright	Copyright 2018 The Min-API Authors. All rights reserved.
+///	@license	Use of this source code is governed by the MIT License found in the License.md file.
+#include "catch.hpp"
+#include "c74_min_api.h"
+
+using namespace c74::min;
+
+using pack = sample_lanes<k_sample_lanes>;
+
+
+class shaper : public sample_operator<1, 1>, public lane_processing {
+public:
+	template <class T>
+	T operator()(T x) {
+		using std::abs;
+		return x * 0.5 + abs(x) * x * drive;
+	}
+
+	double drive { 0.25 };
+};
+
+
+class crossfade : public sample_operator<2, 2>, public lane_processing {
+public:
+	template <class T>
+	std::array<T, 2> operator()(T a, T b) {
+		using std::min;
+		using std::max;
+		return {{ a * (1.0 - position) + b * position, max(min(a, b), T(-0.5)) }};
+	}
+
+	double position { 0.3 };
+};
+
+
+class frame_counter : public sample_operator<1, 0>, public lane_processing {
+public:
+	template <class T>
+	void operator()(T x) {
+		if constexpr (std::is_same<T, sample>::value)
+			frames.push_back(frame());
+		else {
+			for (auto i = 0; i < T::size(); ++i)
+				frames.push_back(frame() + i);
+		}
+	}
+
+	vector<long> frames;
+};
+
+
+// Reference: one frame at a time through the scalar instantiation of the call operator.
+template <class min_class_type>
+static void perform_scalar(min_class_type& op, const double** in_chans, double** out_chans, const long sampleframes) {
+	for (auto i = 0; i < sampleframes; ++i) {
+		op.frame(i);
+		perform_lanes_call<sample>(op, in_chans, out_chans, min_class_type::output_count(), i, std::make_index_sequence<min_class_type::input_count()>());
+	}
+}
+
+
+static vector<sample> test_signal(const size_t size, const double phase) {
+	vector<sample> v(size);
+	for (auto i = 0; i < size; ++i)
+		v[i] = std::sin(phase + i * 0.1);
+	return v;
+}
+
+
+TEST_CASE("Sample lanes arithmetic", "[sample_lanes]") {
+	pack a { 2.0 };
+	pack b;
+	for (auto i = 0; i < pack::size(); ++i)
+		b[i] = i - 1.0;
+
+	SECTION("A sample is broadcast to every lane") {
+		for (auto i = 0; i < pack::size(); ++i)
+			REQUIRE( a[i] == 2.0 );
+	}
+
+	SECTION("Operators work on each lane") {
+		auto c { (a + b) * 3.0 - b / a };
+		auto d { -b };
+		for (auto i = 0; i < pack::size(); ++i) {
+			REQUIRE( c[i] == Approx((2.0 + b[i]) * 3.0 - b[i] / 2.0) );
+			REQUIRE( d[i] == -b[i] );
+		}
+	}
+
+	SECTION("Math functions are found for lanes") {
+		using std::abs;
+		using std::max;
+		auto c { abs(b) };
+		auto d { max(b, pack(0.0)) };
+		for (auto i = 0; i < pack::size(); ++i) {
+			REQUIRE( c[i] == std::abs(b[i]) );
+			REQUIRE( d[i] == std::max(b[i], 0.0) );
+		}
+	}
+
+	SECTION("Packs are loaded from and stored to consecutive samples") {
+		vector<sample> v(pack::size() + 1, 0.0);
+		b.store(v.data() + 1);
+		REQUIRE( v[0] == 0.0 );
+		auto c { pack::load(v.data() + 1) };
+		for (auto i = 0; i < pack::size(); ++i)
+			REQUIRE( c[i] == b[i] );
+	}
+}
+
+
+TEST_CASE("Lane processing matches processing one sample at a time", "[sample_lanes]") {
+	// frame counts that are not a multiple of the lanes, including fewer frames than lanes
+	const long sampleframes = GENERATE(1, 3, 64, 67);
+
+	auto in1 { test_signal(sampleframes, 0.0) };
+	auto in2 { test_signal(sampleframes, 1.0) };
+	const double* in_chans[] { in1.data(), in2.data() };
+
+	SECTION("One input and one output") {
+		shaper op;
+		vector<sample> expected(sampleframes), actual(sampleframes);
+		double* expected_chans[] { expected.data() };
+		double* actual_chans[] { actual.data() };
+
+		perform_scalar(op, in_chans, expected_chans, sampleframes);
+		perform_lanes(op, in_chans, actual_chans, 1, sampleframes);
+
+		for (auto i = 0; i < sampleframes; ++i)
+			REQUIRE( actual[i] == Approx(expected[i]) );
+	}
+
+	SECTION("Several inputs and outputs") {
+		crossfade op;
+		vector<sample> expected1(sampleframes), expected2(sampleframes), actual1(sampleframes), actual2(sampleframes);
+		double* expected_chans[] { expected1.data(), expected2.data() };
+		double* actual_chans[] { actual1.data(), actual2.data() };
+
+		perform_scalar(op, in_chans, expected_chans, sampleframes);
+		perform_lanes(op, in_chans, actual_chans, 2, sampleframes);
+
+		for (auto i = 0; i < sampleframes; ++i) {
+			REQUIRE( actual1[i] == Approx(expected1[i]) );
+			REQUIRE( actual2[i] == Approx(expected2[i]) );
+		}
+	}
+
+	SECTION("Every frame is processed once, with frame() at the start of each pack") {
+		frame_counter op;
+		perform_lanes(op, in_chans, nullptr, 0, sampleframes);
+
+		REQUIRE( op.frames.size() == sampleframes );
+		for (auto i = 0; i < sampleframes; ++i)
+			REQUIRE( op.frames[i] == i );
+	}
+}
+
+
+TEST_CASE("Lane processing benchmark", "[.][benchmark]") {
+	const long sampleframes { 512 };
+
+	auto in1 { test_signal(sampleframes, 0.0) };
+	auto in2 { test_signal(sampleframes, 1.0) };
+	const double* in_chans[] { in1.data(), in2.data() };
+	vector<sample> out1(sampleframes), out2(sampleframes);
+	double* out_chans[] { out1.data(), out2.data() };
+
+	shaper shaper_op;
+	crossfade crossfade_op;
+
+	BENCHMARK("shaper (scalar)") {
+		perform_scalar(shaper_op, in_chans, out_chans, sampleframes);
+		return out1[sampleframes - 1];
+	};
+
+	BENCHMARK("shaper (lanes)") {
+		perform_lanes(shaper_op, in_chans, out_chans, 1, sampleframes);
+		return out1[sampleframes - 1];
+	};
+
+	BENCHMARK("crossfade (scalar)") {
+		perform_scalar(crossfade_op, in_chans, out_chans, sampleframes);
+		return out2[sampleframes - 1];
+	};
+
+	BENCHMARK("crossfade (lanes)") {
+		perform_lanes(crossfade_op, in_chans, out_chans, 2, sampleframes);
+		return out2[sampleframes - 1];
+	};
+}
@@ -0,0 +1,109 @@
+/// @file
+///	@ingroup 	minapi
+///	@copyright	Copyright 2018 The Min-API Authors. All rights reserved.
+///	@license	Use of this source code is governed by the MIT License found in the License.md file.
+#include "catch.hpp"
+#include "c74_min_api.h"
+
+using namespace c74::min;
+
+
+class scratch_test_object : public object<scratch_test_object> {};
+
+
+TEST_CASE("Scratch arena", "[scratch_arena]") {
+	scratch_test_object my_object;
+	scratch_arena scratch {&my_object, 2, 100};
+	scratch.prepare(64);
+	scratch.reset();
+
+	SECTION("The arena is registered with its owner") {
+		REQUIRE(my_object.scratch_arenas().size() == 1);
+		REQUIRE(my_object.scratch_arenas()[0] == &scratch);
+	}
+
+	SECTION("Allocations are aligned and do not overlap") {
+		auto a = scratch.vector(64);
+		auto b = scratch.vector(64);
+		auto c = scratch.allocate<float>(25);
+
+		REQUIRE(a.size() == 64);
+		REQUIRE(b.size() == 64);
+		REQUIRE(c != nullptr);
+		for (auto address : { reinterpret_cast<std::uintptr_t>(a.data()), reinterpret_cast<std::uintptr_t>(b.data()), reinterpret_cast<std::uintptr_t>(c) })
+			REQUIRE(address % scratch_arena::k_alignment == 0);
+		REQUIRE(!a.overlaps(b));
+		REQUIRE(reinterpret_cast<sample*>(c) >= b.end());
+		REQUIRE(scratch.exhausted() == 0);
+	}
+
+	SECTION("Allocating more than was reserved fails without allocating") {
+		scratch.vector(64);
+		scratch.vector(64);
+		scratch.allocate<unsigned char>(100);
+		REQUIRE(scratch.exhausted() == 0);
+
+		auto too_much = scratch.vector(64);
+		REQUIRE(too_much.size() == 0);
+		REQUIRE(too_much.data() == nullptr);
+		REQUIRE(scratch.exhausted() == 1);
+	}
+
+	SECTION("Resetting gives everything back") {
+		auto a = scratch.vector(64);
+		REQUIRE(scratch.used() > 0);
+		scratch.reset();
+		REQUIRE(scratch.used() == 0);
+		REQUIRE(scratch.vector(64).data() == a.data());
+	}
+
+	SECTION("Many small allocations fit whether or not checks are enabled") {
+		scratch_arena bytes {&my_object, 0, 4096};
+		bytes.prepare(64);
+		bytes.reset();
+
+		for (auto i = 0; i < 64; ++i)
+			REQUIRE(bytes.allocate<unsigned char>(64) != nullptr);
+		REQUIRE(bytes.exhausted() == 0);
+		REQUIRE(bytes.allocate<unsigned char>(1) == nullptr);
+	}
+
+	SECTION("Writing past the end of an allocation is detected") {
+		if constexpr (C74_MIN_SCRATCH_ARENA_CHECKS) {
+			auto a = scratch.vector(64);
+			scratch.reset();
+			REQUIRE(scratch.overruns() == 0);
+
+			a = scratch.vector(64);
+			a.data()[64] = 1.0;
+			scratch.reset();
+			REQUIRE(scratch.overruns() == 1);
+		}
+	}
+
+	SECTION("The audio routine keeps its memory until it switches at the next reset") {
+		auto a = scratch.vector(64);
+		scratch.prepare(256);
+		REQUIRE(scratch.capacity() == 2 * 64 * sizeof(sample) + 128);
+		REQUIRE(scratch.vector(64).data() != nullptr);
+		a.data()[0] = 1.0; // still valid
+
+		scratch.reset();
+		REQUIRE(scratch.capacity() == 2 * 256 * sizeof(sample) + 128);
+		REQUIRE(scratch.vector(256).size() == 256);
+		REQUIRE(scratch.vector(256).size() == 256);
+		REQUIRE(scratch.exhausted() == 0);
+	}
+
+	SECTION("The perform routine resets all the arenas of an object") {
+		scratch_arena other {&my_object, 1};
+		other.prepare(64);
+		other.reset();
+		scratch.vector(64);
+		other.vector(64);
+
+		scratch_arena::perform_reset(nullptr, nullptr, nullptr, 0, nullptr, 0, 64, 0, static_cast<object_base*>(&my_object));
+		REQUIRE(scratch.used() == 0);
+		REQUIRE(other.used() == 0);
+	}
+}
@@ -0,0 +1,150 @@
+/// @file
+///	@ingroup 	minapi
+///	@copyright	Copyright 2018 The Min-API Authors. All rights reserved.
+///	@license	Use of this source code is governed by the MIT License found in the License.md file.
+#include "catch.hpp"
+#include "c74_min_api.h"
+
+using namespace c74::min;
+
+
+TEST_CASE("small_vector storage", "[small_vector]") {
+	small_vector<std::string, 4> v;
+
+	SECTION("Items up to the inline capacity do not allocate") {
+		v = { "a", "b", "c", "d" };
+		REQUIRE( v.size() == 4 );
+		REQUIRE( v.is_inline() );
+	}
+
+	SECTION("Growing beyond the inline capacity moves the items to the heap") {
+		for (auto i = 0; i < 10; ++i)
+			v.push_back(std::to_string(i));
+		REQUIRE( v.size() == 10 );
+		REQUIRE( !v.is_inline() );
+		REQUIRE( v.front() == "0" );
+		REQUIRE( v.back() == "9" );
+	}
+
+	SECTION("Pushing one of our own items while growing") {
+		v = { "a", "b", "c", "d" };
+		v.push_back(v[0]);
+		REQUIRE( v.size() == 5 );
+		REQUIRE( v[4] == "a" );
+	}
+
+	SECTION("Shrinking returns to inline storage") {
+		v.resize(20, "x");
+		v.resize(2);
+		v.shrink_to_fit();
+		REQUIRE( v.is_inline() );
+		REQUIRE( v.size() == 2 );
+		REQUIRE( v[1] == "x" );
+	}
+}
+
+
+TEST_CASE("small_vector has the interface of std::vector", "[small_vector]") {
+	using sv = small_vector<int, 4>;
+
+	SECTION("Construction") {
+		REQUIRE( sv(3).size() == 3 );
+		REQUIRE( sv(3)[2] == 0 );
+		REQUIRE( sv(3, 7)[1] == 7 );
+		REQUIRE( sv{ 3, 7 }.size() == 2 );
+
+		std::vector<int> source { 1, 2, 3, 4, 5, 6 };
+		sv v(source.begin(), source.end());
+		REQUIRE( std::equal(v.begin(), v.end(), source.begin(), source.end()) );
+	}
+
+	SECTION("Copy and move of both inline and heap storage") {
+		const auto count = GENERATE(2, 12);
+		sv original(count, 5);
+		sv copy { original };
+		REQUIRE( copy == original );
+
+		sv moved { std::move(copy) };
+		REQUIRE( moved == original );
+		REQUIRE( copy.empty() );
+
+		sv assigned;
+		assigned = std::move(moved);
+		REQUIRE( assigned == original );
+	}
+
+	SECTION("Insert and erase") {
+		sv v { 1, 2, 3 };
+		v.insert(v.begin(), 0);
+		v.insert(v.end(), { 4, 5, 6 });
+		v.insert(v.begin() + 1, 2, 9);
+		REQUIRE( v == sv{ 0, 9, 9, 1, 2, 3, 4, 5, 6 } );
+
+		v.erase(v.begin() + 1, v.begin() + 3);
+		v.erase(v.begin());
+		REQUIRE( v == sv{ 1, 2, 3, 4, 5, 6 } );
+
+		v.pop_back();
+		REQUIRE( v.back() == 5 );
+		REQUIRE_THROWS_AS( v.at(5), std::out_of_range );
+	}
+
+	SECTION("Swap") {
+		sv a { 1, 2 };
+		sv b { 3, 4, 5, 6, 7, 8 };
+		swap(a, b);
+		REQUIRE( a == sv{ 3, 4, 5, 6, 7, 8 } );
+		REQUIRE( b == sv{ 1, 2 } );
+	}
+}
+
+
+TEST_CASE("small_vector of atoms", "[small_vector]") {
+	using small_atoms = small_vector<atom, 8>;
+
+	small_atoms as { 1, 2.5, "foo" };
+	REQUIRE( as.size() == 3 );
+	REQUIRE( as[0].type() == message_type::int_argument );
+	REQUIRE( double(as[1]) == Approx(2.5) );
+	REQUIRE( as[2] == symbol("foo") );
+
+	c74::max::t_atom raw[2];
+	c74::max::atom_setlong(raw + 0, 4);
+	c74::max::atom_setfloat(raw + 1, 0.5);
+	small_atoms from_raw(raw, raw + 2);
+	REQUIRE( int(from_raw[0]) == 4 );
+	REQUIRE( double(from_raw[1]) == Approx(0.5) );
+}
+
+
+namespace {
+
+	// Simulate passing a list through a message: build it, copy it as the wrappers do, and read it
+	template<class container_type>
+	double list_round_trip(const std::size_t count) {
+		container_type as;
+		for (std::size_t i = 0; i < count; ++i)
+			as.push_back(static_cast<double>(i));
+
+		container_type received { as };
+		double sum {};
+		for (const auto& a : received)
+			sum += static_cast<double>(a);
+		return sum;
+	}
+
+}
+
+
+TEST_CASE("small_vector list throughput benchmark", "[.][benchmark]") {
+	using small_atoms = small_vector<atom, 8>;
+
+	for (auto count : { 1, 4, 16, 256 }) {
+		BENCHMARK("std::vector " + std::to_string(count) + " atoms") {
+			return list_round_trip<std::vector<atom>>(count);
+		};
+		BENCHMARK("small_vector " + std::to_string(count) + " atoms") {
+			return list_round_trip<small_atoms>(count);
+		};
+	}
+}
@@ -0,0 +1,124 @@
+/// @file
+///	@ingroup 	minapi
+///	@copyright	Copyright 2018 The Min-API Authors. All rights reserved.
+///	@license	Use of this source code is governed by the MIT License found in the License.md file.
+#include "catch.hpp"
+#include "c74_min_api.h"
+#include "c74_min_attribute_impl.h" // the members of attribute<>, which only main.cpp includes through c74_min.h
+
+using namespace c74::min;
+
+
+class smoothed_test_object : public object<smoothed_test_object> {};
+
+
+TEST_CASE("Smoothed attribute", "[attribute]") {
+	smoothed_test_object my_object;
+
+	SECTION("A linear ramp arrives at the new value after the ramp time") {
+		smoothed_attribute<> my_attr {&my_object, "My Attribute", 0.0, 1.0};
+		my_attr.prepare(8000.0);	// 8 samples per millisecond
+		REQUIRE(my_attr.next() == 0.0);
+
+		my_attr = 1.0;
+		for (auto i = 1; i <= 8; ++i)
+			REQUIRE(my_attr.next() == Approx(i / 8.0));
+		REQUIRE(my_attr.next() == 1.0);
+		REQUIRE(!my_attr.ramping());
+	}
+
+	SECTION("An exponential ramp arrives within -60 dB before jumping to the new value") {
+		smoothed_attribute<smoothing::exponential> my_attr {&my_object, "My Attribute", 0.0, 1.0};
+		my_attr.prepare(8000.0);
+		my_attr.next();
+
+		my_attr = 1.0;
+		sample previous {0.0};
+		for (auto i = 1; i < 8; ++i) {
+			const auto value = my_attr.next();
+			REQUIRE(value > previous);
+			previous = value;
+		}
+		REQUIRE(previous == Approx(1.0 - std::pow(0.001, 7.0 / 8.0)));
+		REQUIRE(my_attr.next() == 1.0);
+	}
+
+	SECTION("Block smoothing jumps to the new value") {
+		smoothed_attribute<smoothing::block> my_attr {&my_object, "My Attribute", 0.0, 1.0};
+		my_attr.prepare(8000.0);
+		my_attr = 0.5;
+		REQUIRE(my_attr.advance(64) == 0.5);
+	}
+
+	SECTION("Compiling the audio starts from the current value") {
+		smoothed_attribute<> my_attr {&my_object, "My Attribute", 0.0, 1.0};
+		my_attr.prepare(8000.0);
+		my_attr.next();
+		my_attr = 1.0;
+		my_attr.next();
+		my_attr.prepare(8000.0);
+		REQUIRE(my_attr.next() == 1.0);
+	}
+
+	SECTION("Values from signals are smoothed") {
+		smoothed_attribute<smoothing::linear, threadsafe::no, limit::clamp> my_attr {&my_object, "My Attribute", 0.0, 1.0, range {0.0, 0.5}};
+		mapped_attribute mapped {1, &my_attr};
+		my_attr.prepare(8000.0);
+		my_attr.next();
+
+		REQUIRE(my_attr.resolve_sample_setter() != nullptr);
+		mapped.set(4.0);
+		REQUIRE(static_cast<number>(my_attr) == 0.0);
+		REQUIRE(my_attr.next() == Approx(0.5 / 8.0));
+	}
+
+	SECTION("A custom setter still applies") {
+		smoothed_attribute<> my_attr {&my_object, "My Attribute", 0.0, 1.0,
+			setter { [](const atoms& args, const int inlet) -> atoms {
+				return { static_cast<double>(args[0]) * 2.0 };
+			}}
+		};
+		my_attr.prepare(8000.0);
+		my_attr.next();
+		my_attr = 0.25;
+		REQUIRE(my_attr.advance(8) == 0.0);
+		REQUIRE(my_attr.next() == 0.5);
+	}
+}
+
+
+template <class smoothed_type>
+static void require_fill_matches_next(smoothed_test_object& my_object, const long frame_count) {
+	smoothed_type reference {&my_object, "Reference", 0.0, 1.0};
+	smoothed_type my_attr {&my_object, "My Attribute", 0.0, 1.0};
+	reference.prepare(48000.0);	// 48 samples per millisecond
+	my_attr.prepare(48000.0);
+	reference.next();
+	my_attr.advance(1);
+	vector<sample> output(frame_count);
+
+	for (auto value : { 1.0, -0.5, -0.5, 2.0 }) {
+		reference = value;
+		my_attr = value;
+		my_attr.fill(output.data(), frame_count);
+		for (auto i = 0; i < frame_count; ++i)
+			REQUIRE(output[i] == Approx(reference.next()).margin(1e-12));
+		REQUIRE(my_attr.advance(frame_count) == Approx(reference.advance(frame_count)).margin(1e-12));
+	}
+}
+
+
+TEST_CASE("Smoothed attribute - filling a vector matches one sample at a time", "[attribute]") {
+	smoothed_test_object my_object;
+	const long frame_count = GENERATE(1, 7, 32, 67);
+
+	SECTION("linear") {
+		require_fill_matches_next<smoothed_attribute<smoothing::linear>>(my_object, frame_count);
+	}
+	SECTION("exponential") {
+		require_fill_matches_next<smoothed_attribute<smoothing::exponential>>(my_object, frame_count);
+	}
+	SECTION("block") {
+		require_fill_matches_next<smoothed_attribute<smoothing::block>>(my_object, frame_count);
+	}
+}
@@ -0,0 +1,61 @@
+/// @file
+///	@ingroup 	minapi
+///	@copyright	Copyright 2018 The Min-API Authors. All rights reserved.
+///	@license	Use of this source code is governed by the MIT License found in the License.md file.
+#include "catch.hpp"
+#include "c74_min_api.h"
+#include "c74_min_attribute_impl.h" // the members of attribute<>, which only main.cpp includes through c74_min.h
+
+using namespace c74::min;
+
+
+class snapshot_test_object : public object<snapshot_test_object> {};
+
+
+TEST_CASE("Snapshot attribute", "[attribute]") {
+	snapshot_test_object my_object;
+	snapshot_attribute<numbers> my_attr {&my_object, "My Attribute", {1.0, 2.0}};
+
+	SECTION("The audio thread reads the value as it was set") {
+		REQUIRE(*my_attr.snapshot() == numbers {1.0, 2.0});
+		my_attr = atoms {3.0, 4.0, 5.0};
+		REQUIRE(*my_attr.snapshot() == numbers {3.0, 4.0, 5.0});
+		REQUIRE(static_cast<numbers>(my_attr) == numbers {3.0, 4.0, 5.0});
+	}
+
+	SECTION("A snapshot being read is not freed until the reader is done") {
+		{
+			auto reader = my_attr.snapshot();
+			my_attr = atoms {3.0};
+			REQUIRE(!my_attr.reclaim());
+			REQUIRE(*reader == numbers {1.0, 2.0});
+		}
+		REQUIRE(my_attr.reclaim());
+	}
+
+	SECTION("Reading while the value changes on another thread") {
+		std::atomic<bool> done {false};
+		std::atomic<int> torn_reads {0};
+		my_attr = atoms {0.0, 0.0};
+
+		std::thread audio_thread { [&] {
+			while (!done) {
+				auto reader = my_attr.snapshot();
+				for (auto value : *reader) {
+					if (value != reader->front())
+						++torn_reads;
+				}
+			}
+		}};
+
+		for (auto i = 0; i < 1000; ++i) {
+			my_attr = atoms(1 + i % 16, static_cast<double>(i));
+			my_attr.reclaim();
+		}
+		done = true;
+		audio_thread.join();
+
+		REQUIRE(torn_reads == 0);
+		REQUIRE(my_attr.reclaim());
+	}
+}
@@ -0,0 +1,94 @@
+/// @file
+///	@ingroup 	minapi
+///	@copyright	Copyright 2018 The Min-API Authors. All rights reserved.
+///	@license	Use of this source code is governed by the MIT License found in the License.md file.
+#include "catch.hpp"
+#include "c74_min_api.h"
+
+using namespace c74::min;
+
+
+TEST_CASE("Worker pool runs every task once", "[worker_pool]") {
+	const size_t thread_count = GENERATE(0, 1, 3);
+	worker_pool workers { thread_count, std::chrono::microseconds(100) };
+	workers.start();
+
+	std::array<std::atomic<int>, 16> calls {};
+	auto task = [&calls](const size_t index) { ++calls[index]; };
+
+	SECTION("Each run returns when all of its tasks are done") {
+		for (auto run = 1; run <= 500; ++run) {
+			workers.run(calls.size(), task);
+			for (auto& count : calls)
+				REQUIRE( count == run );
+		}
+	}
+
+	SECTION("Workers that have gone to sleep are woken") {
+		std::this_thread::sleep_for(std::chrono::milliseconds(5));
+		workers.run(calls.size(), task);
+		for (auto& count : calls)
+			REQUIRE( count == 1 );
+	}
+
+	SECTION("Workers can be stopped while asleep and started again") {
+		std::this_thread::sleep_for(std::chrono::milliseconds(5));
+		workers.stop();
+		REQUIRE( !workers.running() );
+
+		workers.start();
+		REQUIRE( workers.running() );
+		workers.run(calls.size(), task);
+		for (auto& count : calls)
+			REQUIRE( count == 1 );
+	}
+
+	SECTION("Runs may have fewer tasks than threads") {
+		workers.run(1, task);
+		REQUIRE( calls[0] == 1 );
+		REQUIRE( calls[1] == 0 );
+	}
+
+	SECTION("A run while another thread is running does all of its tasks") {
+		std::array<std::atomic<int>, 16> other_calls {};
+		auto other_task = [&other_calls](const size_t index) { ++other_calls[index]; };
+
+		std::thread other { [&workers, &other_calls, &other_task] {
+			for (auto run = 0; run < 500; ++run)
+				workers.run(other_calls.size(), other_task);
+		} };
+		for (auto run = 0; run < 500; ++run)
+			workers.run(calls.size(), task);
+		other.join();
+
+		for (auto i = 0; i < 16; ++i) {
+			REQUIRE( calls[i] == 500 );
+			REQUIRE( other_calls[i] == 500 );
+		}
+	}
+
+	workers.stop();
+	REQUIRE( !workers.running() );
+}
+
+
+TEST_CASE("Worker pool benchmark", "[.][benchmark]") {
+	const size_t		  task_count { 4 };
+	vector<vector<sample>> channels(task_count, vector<sample>(4096, 0.5));
+
+	// each task is some tens of microseconds of work, like processing a few channels of a vector
+	auto task = [&channels](const size_t index) {
+		for (auto& x : channels[index])
+			x = std::sin(x) * 0.999 + 0.001;
+	};
+
+	for (size_t thread_count = 0; thread_count < task_count; ++thread_count) {
+		worker_pool workers { thread_count };
+		workers.start();
+
+		BENCHMARK("4 tasks on the calling thread and " + std::to_string(thread_count) + " workers") {
+			workers.run(task_count, task);
+			return channels[0][0];
+		};
+	}
+}